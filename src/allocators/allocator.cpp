@@ -29,6 +29,7 @@
 #include <iostream>
 #include <sstream>
 #include <cassert>
+#include <algorithm>
 #include "allocator.hpp"
 
 /////////////////////////////////////////////////////////////////////////
@@ -41,6 +42,7 @@
 #include "selalloc.hpp"
 #include "separable_input_first.hpp"
 #include "separable_output_first.hpp"
+#include "vc_mask.hpp"
 //
 /////////////////////////////////////////////////////////////////////////
 
@@ -74,6 +76,14 @@ void Allocator::AddRequest( int in, int out, int label, int in_pri,
   _dirty = true;
 }
 
+void Allocator::AddRequestMask( int in, int first, unsigned long long mask,
+				int label, int in_pri, int out_pri )
+{
+  for ( ; mask; mask &= mask - 1 ) {
+    AddRequest( in, first + __builtin_ctzll( mask ), label, in_pri, out_pri );
+  }
+}
+
 int Allocator::OutputAssigned( int in ) const
 {
   assert( ( in >= 0 ) && ( in < _inputs ) );
@@ -108,310 +118,192 @@ void Allocator::PrintGrants( ostream * os ) const
 }
 
 //==================================================
-// DenseAllocator
+// BitmapAllocator
 //==================================================
 
-DenseAllocator::DenseAllocator( Module *parent, const string& name,
-				int inputs, int outputs ) :
-  Allocator( parent, name, inputs, outputs )
+BitmapAllocator::BitmapAllocator( Module *parent, const string& name,
+				  int inputs, int outputs ) :
+  Allocator( parent, name, inputs, outputs ),
+  _in_words( ( outputs + 63 ) / 64 ), _out_words( ( inputs + 63 ) / 64 )
 {
-  _request.resize(_inputs);
-
-  for ( int i = 0; i < _inputs; ++i ) {
-    _request[i].resize(_outputs);  
-    for ( int j = 0; j < _outputs; ++j ) {
-      _request[i][j].label = -1;
-    }
-  }
+  _in_bits.resize(_inputs * _in_words, 0);
+  _out_bits.resize(_outputs * _out_words, 0);
+  _in_occ.resize(_out_words, 0);
+  _out_occ.resize(_in_words, 0);
+  _in_count.resize(_inputs, 0);
+  _out_count.resize(_outputs, 0);
+  _requests.resize(_inputs * _outputs);
 }
 
-void DenseAllocator::Clear( )
+int BitmapAllocator::_FirstSet( unsigned long long const * bits,
+				unsigned long long const * mask,
+				int from, int end )
 {
-  for ( int i = 0; i < _inputs; ++i ) {
-    for ( int j = 0; j < _outputs; ++j ) {
-      _request[i][j].label = -1;
-    }
+  if ( from >= end ) {
+    return -1;
   }
-  Allocator::Clear();
-}
-
-int DenseAllocator::ReadRequest( int in, int out ) const
-{
-  assert( ( in >= 0 ) && ( in < _inputs ) );
-  assert( ( out >= 0 ) && ( out < _outputs ) );
-
-  return _request[in][out].label;
-}
-
-bool DenseAllocator::ReadRequest( sRequest &req, int in, int out ) const
-{
-  assert( ( in >= 0 ) && ( in < _inputs ) );
-  assert( ( out >= 0 ) && ( out < _outputs ) );
-
-  req = _request[in][out];
-
-  return ( req.label >= 0 );
-}
-
-void DenseAllocator::AddRequest( int in, int out, int label, 
-				 int in_pri, int out_pri )
-{
-  Allocator::AddRequest(in, out, label, in_pri, out_pri);
-  assert( _request[in][out].label == -1 );
-
-  _request[in][out].label   = label;
-  _request[in][out].in_pri  = in_pri;
-  _request[in][out].out_pri = out_pri;
-}
-
-void DenseAllocator::RemoveRequest( int in, int out, int label )
-{
-  assert( ( in >= 0 ) && ( in < _inputs ) );
-  assert( ( out >= 0 ) && ( out < _outputs ) ); 
-  
-  _request[in][out].label = -1;
-}
-
-bool DenseAllocator::InputHasRequests( int in ) const
-{
-  for(int out = 0; out < _outputs; ++out) {
-    if(_request[in][out].label >= 0) {
-      return true;
+  int w = from >> 6;
+  int const last = ( end - 1 ) >> 6;
+  unsigned long long word = bits[w] & ( ~0ULL << ( from & 63 ) );
+  while ( true ) {
+    if ( mask ) {
+      word &= mask[w];
     }
-  }
-  return false;
-}
-
-bool DenseAllocator::OutputHasRequests( int out ) const
-{
-  for(int in = 0; in < _inputs; ++in) {
-    if(_request[in][out].label >= 0) {
-      return true;
+    if ( word ) {
+      int const i = ( w << 6 ) + __builtin_ctzll( word );
+      return ( i < end ) ? i : -1;
     }
-  }
-  return false;
-}
-
-int DenseAllocator::NumInputRequests( int in ) const
-{
-  int result = 0;
-  for(int out = 0; out < _outputs; ++out) {
-    if(_request[in][out].label >= 0) {
-      ++result;
+    if ( w == last ) {
+      return -1;
     }
+    word = bits[++w];
   }
-  return result;
 }
 
-int DenseAllocator::NumOutputRequests( int out ) const
+int BitmapAllocator::_NextRoundRobin( unsigned long long const * bits,
+				      unsigned long long const * mask,
+				      int size, int offset, int current )
 {
-  int result = 0;
-  for(int in = 0; in < _inputs; ++in) {
-    if(_request[in][out].label >= 0) {
-      ++result;
-    }
+  if ( ( current >= 0 ) && ( current < offset ) ) {
+    // already wrapped around
+    return _FirstSet( bits, mask, current + 1, offset );
   }
-  return result;
+  int const i = _FirstSet( bits, mask, ( current < 0 ) ? offset : ( current + 1 ),
+			   size );
+  return ( i >= 0 ) ? i : _FirstSet( bits, mask, 0, offset );
 }
 
-void DenseAllocator::PrintRequests( ostream * os ) const
+void BitmapAllocator::Clear( )
 {
-  if(!os) os = &cout;
-
-  *os << "Input requests = [ ";
-  for ( int input = 0; input < _inputs; ++input ) {
-    bool print = false;
-    ostringstream ss;
-    for ( int output = 0; output < _outputs; ++output ) {
-      const sRequest & req = _request[input][output];
-      if ( req.label >= 0 ) {
-	print = true;
-	ss << output << "@" << req.in_pri << " ";
-      }
-    }
-    if(print) {
-      *os << input << " -> [ " << ss.str() << "]  ";
+  for ( int w = 0; w < _out_words; ++w ) {
+    for ( unsigned long long occ = _in_occ[w]; occ; occ &= occ - 1 ) {
+      int const input = ( w << 6 ) + __builtin_ctzll( occ );
+      fill( &_in_bits[input * _in_words], &_in_bits[( input + 1 ) * _in_words], 0ULL );
+      _in_count[input] = 0;
     }
+    _in_occ[w] = 0;
   }
-  *os << "], output requests = [ ";
-  for ( int output = 0; output < _outputs; ++output ) {
-    bool print = false;
-    ostringstream ss;
-    for ( int input = 0; input < _inputs; ++input ) {
-      const sRequest & req = _request[input][output];
-      if ( req.label >= 0 ) {
-	print = true;
-	ss << input << "@" << req.out_pri << " ";
-      }
-    }
-    if(print) {
-      *os << output << " -> [ " << ss.str() << "]  ";
+  for ( int w = 0; w < _in_words; ++w ) {
+    for ( unsigned long long occ = _out_occ[w]; occ; occ &= occ - 1 ) {
+      int const output = ( w << 6 ) + __builtin_ctzll( occ );
+      fill( &_out_bits[output * _out_words], &_out_bits[( output + 1 ) * _out_words], 0ULL );
+      _out_count[output] = 0;
     }
+    _out_occ[w] = 0;
   }
-  *os << "]." << endl;
-}
-
-//==================================================
-// SparseAllocator
-//==================================================
-
-SparseAllocator::SparseAllocator( Module *parent, const string& name,
-				  int inputs, int outputs ) :
-  Allocator( parent, name, inputs, outputs )
-{
-  _in_req.resize(_inputs);
-  _out_req.resize(_outputs);
-}
-
-
-void SparseAllocator::Clear( )
-{
-  for ( int i = 0; i < _inputs; ++i ) {
-    if(!_in_req[i].empty())
-      _in_req[i].clear( );
-  }
-
-  for ( int j = 0; j < _outputs; ++j ) {
-    if(!_out_req[j].empty())
-      _out_req[j].clear( );
-  }
-
-  _in_occ.clear( );
-  _out_occ.clear( );
 
   Allocator::Clear();
 }
 
-int SparseAllocator::ReadRequest( int in, int out ) const
+int BitmapAllocator::ReadRequest( int in, int out ) const
 {
-  sRequest r;
-
-  if ( ! ReadRequest( r, in, out ) ) {
-    r.label = -1;
-  } 
+  assert( ( in >= 0 ) && ( in < _inputs ) );
+  assert( ( out >= 0 ) && ( out < _outputs ) );
 
-  return r.label;
+  return _HasRequest( in, out ) ? _Request( in, out ).label : -1;
 }
 
-bool SparseAllocator::ReadRequest( sRequest &req, int in, int out ) const
+bool BitmapAllocator::ReadRequest( sRequest &req, int in, int out ) const
 {
-  bool found;
-
   assert( ( in >= 0 ) && ( in < _inputs ) );
   assert( ( out >= 0 ) && ( out < _outputs ) );
 
-  map<int, sRequest>::const_iterator match = _in_req[in].find(out);
-  if ( match != _in_req[in].end( ) ) {
-    req = match->second;
-    found = true;
-  } else {
-    found = false;
+  if ( !_HasRequest( in, out ) ) {
+    return false;
   }
-
-  return found;
+  req = _Request( in, out );
+  return true;
 }
 
-void SparseAllocator::AddRequest( int in, int out, int label, 
+void BitmapAllocator::AddRequest( int in, int out, int label, 
 				  int in_pri, int out_pri )
 {
   Allocator::AddRequest(in, out, label, in_pri, out_pri);
-  assert( _in_req[in].count(out) == 0 );
-  assert( _out_req[out].count(in) == 0 );
+  assert( !_HasRequest( in, out ) );
 
-  // insert into occupied inputs set if
-  // input is currently empty
-  if ( _in_req[in].empty( ) ) {
-    _in_occ.insert(in);
+  // mark input and output as occupied on their first request
+  if ( _in_count[in]++ == 0 ) {
+    _SetBit( &_in_occ[0], in );
   }
-
-  // similarly for the output
-  if ( _out_req[out].empty( ) ) {
-    _out_occ.insert(out);
+  if ( _out_count[out]++ == 0 ) {
+    _SetBit( &_out_occ[0], out );
   }
 
-  sRequest req;
+  _SetBit( &_in_bits[in * _in_words], out );
+  _SetBit( &_out_bits[out * _out_words], in );
+
+  sRequest & req = _requests[in * _outputs + out];
   req.port    = out;
   req.label   = label;
   req.in_pri  = in_pri;
   req.out_pri = out_pri;
-
-  _in_req[in][out] = req;
-
-  req.port  = in;
-
-  _out_req[out][in] = req;
 }
 
-void SparseAllocator::RemoveRequest( int in, int out, int label )
+void BitmapAllocator::RemoveRequest( int in, int out, int label )
 {
   assert( ( in >= 0 ) && ( in < _inputs ) );
   assert( ( out >= 0 ) && ( out < _outputs ) ); 
   
-  assert( _in_req[in].count( out ) > 0 );
-  assert( _in_req[in][out].label == label );
-  _in_req[in].erase( out );
-
-  // remove from occupied inputs list if
-  // input is now empty
-  if ( _in_req[in].empty( ) ) {
-    _in_occ.erase(in);
-  }
+  assert( _HasRequest( in, out ) );
+  assert( _Request( in, out ).label == label );
 
-  // similarly for the output
-  assert( _out_req[out].count( in ) > 0 );
-  assert( _out_req[out][in].label == label );
-  _out_req[out].erase( in );
+  _ClearBit( &_in_bits[in * _in_words], out );
+  _ClearBit( &_out_bits[out * _out_words], in );
 
-  if ( _out_req[out].empty( ) ) {
-    _out_occ.erase(out);
+  // remove from occupied inputs and outputs once empty
+  if ( --_in_count[in] == 0 ) {
+    _ClearBit( &_in_occ[0], in );
+  }
+  if ( --_out_count[out] == 0 ) {
+    _ClearBit( &_out_occ[0], out );
   }
 }
 
-bool SparseAllocator::InputHasRequests( int in ) const
+bool BitmapAllocator::InputHasRequests( int in ) const
 {
-  return _in_occ.count(in) > 0;
+  return _in_count[in] > 0;
 }
 
-bool SparseAllocator::OutputHasRequests( int out ) const
+bool BitmapAllocator::OutputHasRequests( int out ) const
 {
-  return _out_occ.count(out) > 0;
+  return _out_count[out] > 0;
 }
 
-int SparseAllocator::NumInputRequests( int in ) const
+int BitmapAllocator::NumInputRequests( int in ) const
 {
-  return _in_occ.count(in);
+  return _in_count[in];
 }
 
-int SparseAllocator::NumOutputRequests( int out ) const
+int BitmapAllocator::NumOutputRequests( int out ) const
 {
-  return _out_occ.count(out);
+  return _out_count[out];
 }
 
-void SparseAllocator::PrintRequests( ostream * os ) const
+void BitmapAllocator::PrintRequests( ostream * os ) const
 {
-  map<int, sRequest>::const_iterator iter;
-  
   if(!os) os = &cout;
   
   *os << "Input requests = [ ";
   for ( int input = 0; input < _inputs; ++input ) {
-    if(!_in_req[input].empty()) {
+    if(_in_count[input] > 0) {
       *os << input << " -> [ ";
-      for ( iter = _in_req[input].begin( ); 
-	    iter != _in_req[input].end( ); iter++ ) {
-	*os << iter->second.port << "@" << iter->second.in_pri << " ";
+      unsigned long long const * row = _InputRow( input );
+      for ( int output = _FirstSet( row, NULL, 0, _outputs ); output >= 0;
+	    output = _FirstSet( row, NULL, output + 1, _outputs ) ) {
+	*os << output << "@" << _Request( input, output ).in_pri << " ";
       }
       *os << "]  ";
     }
   }
   *os << "], output requests = [ ";
   for ( int output = 0; output < _outputs; ++output ) {
-    if(!_out_req[output].empty()) {
+    if(_out_count[output] > 0) {
       *os << output << " -> ";
       *os << "[ ";
-      for ( iter = _out_req[output].begin( ); 
-	    iter != _out_req[output].end( ); iter++ ) {
-	*os << iter->second.port << "@" << iter->second.out_pri << " ";
+      unsigned long long const * column = _OutputColumn( output );
+      for ( int input = _FirstSet( column, NULL, 0, _inputs ); input >= 0;
+	    input = _FirstSet( column, NULL, input + 1, _inputs ) ) {
+	*os << input << "@" << _Request( input, output ).out_pri << " ";
       }
       *os << "]  ";
     }
@@ -467,6 +359,10 @@ Allocator *Allocator::NewAllocator( Module *parent, const string& name,
   } else if (alloc_name == "separable_output_first") {
     string arb_type = param_str.empty() ? (config ? config->GetStr("arb_type") : "round_robin") : param_str;
     a = new SeparableOutputFirstAllocator( parent, name, inputs, outputs,arb_type );
+  } else if (alloc_name == "vc_mask_input_first") {
+    a = new VCMaskAllocator( parent, name, inputs, outputs, false );
+  } else if (alloc_name == "vc_mask_output_first") {
+    a = new VCMaskAllocator( parent, name, inputs, outputs, true );
   }
 
 //==================================================
@@ -29,13 +29,13 @@
 #define _ALLOCATOR_HPP_
 
 #include <string>
-#include <map>
-#include <set>
 #include <vector>
 
 #include "module.hpp"
 #include "config_utils.hpp"
 
+class Checkpoint;
+
 class Allocator : public Module {
 protected:
   const int _inputs;
@@ -65,6 +65,9 @@ public:
 
   virtual void AddRequest( int in, int out, int label = 1, 
 			   int in_pri = 0, int out_pri = 0 );
+  // request outputs first + i for each bit i of the mask at once
+  virtual void AddRequestMask( int in, int first, unsigned long long mask,
+			       int label = 1, int in_pri = 0, int out_pri = 0 );
   virtual void RemoveRequest( int in, int out, int label = 1 ) = 0;
   
   virtual void Allocate( ) = 0;
@@ -81,6 +84,9 @@ public:
   virtual void PrintRequests( ostream * os = NULL ) const = 0;
   void PrintGrants( ostream * os = NULL ) const;
 
+  // save or restore the state that is kept across cycles
+  virtual void Serialize( Checkpoint & cp ) { }
+
   static Allocator *NewAllocator( Module *parent, const string& name,
 				  const string &alloc_type, 
 				  int inputs, int outputs, 
@@ -88,52 +94,61 @@ public:
 };
 
 //==================================================
-// A dense allocator stores the entire request
-// matrix.
+// A bitmap allocator stores one bit per request, both
+// by input (a row of output bits) and by output (a
+// column of input bits), so the request matrix can be
+// scanned and cleared a word at a time. Labels and
+// priorities live in a separate inputs x outputs
+// array that is only valid where the bit is set.
 //==================================================
 
-class DenseAllocator : public Allocator {
+class BitmapAllocator : public Allocator {
 protected:
-  vector<vector<sRequest> > _request;
-
-public:
-  DenseAllocator( Module *parent, const string& name,
-		  int inputs, int outputs );
-
-  void Clear( );
-  
-  int  ReadRequest( int in, int out ) const;
-  bool ReadRequest( sRequest &req, int in, int out ) const;
-
-  void AddRequest( int in, int out, int label = 1, 
-		   int in_pri = 0, int out_pri = 0 );
-  void RemoveRequest( int in, int out, int label = 1 );
-
-  bool OutputHasRequests( int out ) const;
-  bool InputHasRequests( int in ) const;
-
-  int NumOutputRequests( int out ) const;
-  int NumInputRequests( int in ) const;
-
-  void PrintRequests( ostream * os = NULL ) const;
-
-};
-
-//==================================================
-// A sparse allocator only stores the requests
-// (allows for a more efficient implementation).
-//==================================================
-
-class SparseAllocator : public Allocator {
-protected:
-  set<int> _in_occ;
-  set<int> _out_occ;
-  
-  vector<map<int, sRequest> > _in_req;
-  vector<map<int, sRequest> > _out_req;
+  const int _in_words;  // words per input row (one bit per output)
+  const int _out_words; // words per output column (one bit per input)
+
+  vector<unsigned long long> _in_bits;
+  vector<unsigned long long> _out_bits;
+  vector<unsigned long long> _in_occ;
+  vector<unsigned long long> _out_occ;
+
+  vector<int> _in_count;
+  vector<int> _out_count;
+
+  vector<sRequest> _requests;
+
+  inline unsigned long long const * _InputRow( int in ) const {
+    return &_in_bits[in * _in_words];
+  }
+  inline unsigned long long const * _OutputColumn( int out ) const {
+    return &_out_bits[out * _out_words];
+  }
+  inline bool _HasRequest( int in, int out ) const {
+    return ( _in_bits[in * _in_words + ( out >> 6 )] >> ( out & 63 ) ) & 1;
+  }
+  inline sRequest const & _Request( int in, int out ) const {
+    return _requests[in * _outputs + out];
+  }
+
+  static inline void _SetBit( unsigned long long * bits, int i ) {
+    bits[i >> 6] |= 1ULL << ( i & 63 );
+  }
+  static inline void _ClearBit( unsigned long long * bits, int i ) {
+    bits[i >> 6] &= ~( 1ULL << ( i & 63 ) );
+  }
+
+  // first bit set in [from, end) of bits (and of mask, if given), or -1
+  static int _FirstSet( unsigned long long const * bits,
+			unsigned long long const * mask, int from, int end );
+
+  // the set bit following current when scanning [0, size) round-robin
+  // from offset; pass current = -1 to get the first one, -1 at the end
+  static int _NextRoundRobin( unsigned long long const * bits,
+			      unsigned long long const * mask,
+			      int size, int offset, int current = -1 );
 
 public:
-  SparseAllocator( Module *parent, const string& name,
+  BitmapAllocator( Module *parent, const string& name,
 		   int inputs, int outputs );
 
   void Clear( );
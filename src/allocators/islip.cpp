@@ -30,16 +30,19 @@
 
 #include "islip.hpp"
 #include "random_utils.hpp"
+#include "checkpoint.hpp"
 
 //#define DEBUG_ISLIP
 
 iSLIP_Sparse::iSLIP_Sparse( Module *parent, const string& name,
 			    int inputs, int outputs, int iters ) :
-  SparseAllocator( parent, name, inputs, outputs ),
+  BitmapAllocator( parent, name, inputs, outputs ),
   _iSLIP_iter(iters)
 {
   _gptrs.resize(_outputs, 0);
   _aptrs.resize(_inputs, 0);
+  _free_inputs.resize(_out_words);
+  _granted.resize(_inputs * _in_words);
 }
 
 void iSLIP_Sparse::Allocate( )
@@ -47,58 +50,31 @@ void iSLIP_Sparse::Allocate( )
   int input;
   int output;
 
-  int input_offset;
-  int output_offset;
-
-  map<int, sRequest>::iterator p;
-  bool wrapped;
+  _free_inputs.assign(_out_words, ~0ULL);
 
   for ( int iter = 0; iter < _iSLIP_iter; ++iter ) {
     // Grant phase
 
     vector<int> grants(_outputs, -1);
 
-    for ( output = 0; output < _outputs; ++output ) {
+    _granted.assign(_inputs * _in_words, 0);
+
+    for ( output = _FirstSet( &_out_occ[0], NULL, 0, _outputs ); output >= 0;
+	  output = _FirstSet( &_out_occ[0], NULL, output + 1, _outputs ) ) {
 
-      // Skip loop if there are no requests
-      // or the output is already matched
-      if ( ( _out_req[output].empty( ) ) ||
-	   ( _outmatch[output] != -1 ) ) {
+      // Skip if the output is already matched
+      if ( _outmatch[output] != -1 ) {
 	continue;
       }
 
-      // A round-robin arbiter between input requests
-      input_offset = _gptrs[output];
+      // A round-robin arbiter between requests from free inputs
+      input = _NextRoundRobin( _OutputColumn( output ), &_free_inputs[0],
+			       _inputs, _gptrs[output] );
 
-      p = _out_req[output].begin( );
-      while( ( p != _out_req[output].end( ) ) &&
-	     ( p->second.port < input_offset ) ) {
-	p++;
+      if ( input >= 0 ) {
+	grants[output] = input;
+	_SetBit( &_granted[input * _in_words], output );
       }
-
-      wrapped = false;
-      while( (!wrapped) || 
-	     ( ( p != _out_req[output].end( ) ) &&
-	       ( p->second.port < input_offset ) ) ) {
-	if ( p == _out_req[output].end( ) ) {
-	  if ( wrapped ) { break; }
-	  // p is valid here because empty lists
-	  // are skipped (above)
-	  p = _out_req[output].begin( );
-	  wrapped = true;
-	}
-
-	input = p->second.port;
-
-	// we know the output is free (above) and
-	// if the input is free, grant request
-	if ( _inmatch[input] == -1 ) {
-	  grants[output] = input;
-	  break;
-	}
-
-	p++;
-      }      
     }
 
 #ifdef DEBUG_ISLIP
@@ -117,53 +93,25 @@ void iSLIP_Sparse::Allocate( )
 
     // Accept phase
 
-    for ( input = 0; input < _inputs; ++input ) {
-
-      if ( _in_req[input].empty( ) ) {
-	continue;
-      }
+    for ( input = _FirstSet( &_in_occ[0], NULL, 0, _inputs ); input >= 0;
+	  input = _FirstSet( &_in_occ[0], NULL, input + 1, _inputs ) ) {
 
       // A round-robin arbiter between output grants
-      output_offset = _aptrs[input];
-
-      p = _in_req[input].begin( );
-      while( ( p != _in_req[input].end( ) ) &&
-	     ( p->second.port < output_offset ) ) {
-	p++;
-      }
-
-      wrapped = false;
-      while( (!wrapped) || 
-	     ( ( p != _in_req[input].end( ) ) &&
-	       ( p->second.port < output_offset ) ) ) {
-	if ( p == _in_req[input].end( ) ) {
-	  if ( wrapped ) { break; }
-	  // p is valid here because empty lists
-	  // are skipped (above)
-	  p = _in_req[input].begin( );
-	  wrapped = true;
-	}
-
-	output = p->second.port;
-
-	// we know the output is free (above) and
-	// if the input is free, grant request
-	if ( grants[output] == input ) {
-	  // Accept
-	  _inmatch[input]   = output;
-	  _outmatch[output] = input;
-
-	  // Only update pointers if accepted during the 1st iteration
-	  if ( iter == 0 ) {
-	    _gptrs[output] = ( input + 1 ) % _inputs;
-	    _aptrs[input]  = ( output + 1 ) % _outputs;
-	  }
-
-	  break;
+      output = _NextRoundRobin( &_granted[input * _in_words], NULL,
+				_outputs, _aptrs[input] );
+
+      if ( output >= 0 ) {
+	// Accept
+	_inmatch[input]   = output;
+	_outmatch[output] = input;
+	_ClearBit( &_free_inputs[0], input );
+
+	// Only update pointers if accepted during the 1st iteration
+	if ( iter == 0 ) {
+	  _gptrs[output] = ( input + 1 ) % _inputs;
+	  _aptrs[input]  = ( output + 1 ) % _outputs;
 	}
-
-	p++;
-      } 
+      }
     }
   }
 
@@ -181,3 +129,9 @@ void iSLIP_Sparse::Allocate( )
   cout << endl;
 #endif
 }
+
+void iSLIP_Sparse::Serialize( Checkpoint & cp )
+{
+  cp.Sync( _gptrs );
+  cp.Sync( _aptrs );
+}
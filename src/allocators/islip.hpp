@@ -32,17 +32,23 @@
 
 #include "allocator.hpp"
 
-class iSLIP_Sparse : public SparseAllocator {
+class iSLIP_Sparse : public BitmapAllocator {
   int _iSLIP_iter;
 
   vector<int> _gptrs;
   vector<int> _aptrs;
 
+  // inputs that are still unmatched, and the outputs granted to each input
+  vector<unsigned long long> _free_inputs;
+  vector<unsigned long long> _granted;
+
 public:
   iSLIP_Sparse( Module *parent, const string& name,
 		int inputs, int outputs, int iters );
 
   void Allocate( );
+
+  void Serialize( Checkpoint & cp );
 };
 
 #endif 
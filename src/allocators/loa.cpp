@@ -30,13 +30,13 @@
 
 #include "loa.hpp"
 #include "random_utils.hpp"
+#include "checkpoint.hpp"
 
 LOA::LOA( Module *parent, const string& name,
 	  int inputs, int outputs ) :
-  DenseAllocator( parent, name, inputs, outputs )
+  BitmapAllocator( parent, name, inputs, outputs )
 {
-  _req.resize(inputs);
-  _counts.resize(outputs);
+  _requesters.resize(outputs * _out_words);
 
   _rptr.resize(inputs);
   _gptr.resize(outputs);
@@ -47,66 +47,58 @@ void LOA::Allocate( )
   int input;
   int output;
 
-  int input_offset;
-  int output_offset;
-
   int lonely;
   int lonely_cnt;
 
-  // Count phase --- the number of requests
-  // per output is counted
+  // Request phase --- the number of requests
+  // per output is already counted as they are added
 
-  for ( int j = 0; j < _outputs; ++j ) {
-    _counts[j] = 0;
-    for ( int i = 0; i < _inputs; ++i ) {
-      _counts[j] += ( _request[i][j].label != -1 ) ? 1 : 0;
-    }
-  }
+  _requesters.assign(_outputs * _out_words, 0);
 
-  // Request phase
-  for ( input = 0; input < _inputs; ++input ) {
+  for ( input = _FirstSet( &_in_occ[0], NULL, 0, _inputs ); input >= 0;
+	input = _FirstSet( &_in_occ[0], NULL, input + 1, _inputs ) ) {
 
     // Find the lonely output
-    output_offset = _rptr[input];
+    unsigned long long const * row = _InputRow( input );
     lonely        = -1;
     lonely_cnt    = _inputs + 1;
 
-    for ( int o = 0; o < _outputs; ++o ) {
-      output = ( o + output_offset ) % _outputs;
-
-      if ( ( _request[input][output].label != -1 ) && 
-	   ( _counts[output] < lonely_cnt ) ) {
+    for ( output = _NextRoundRobin( row, NULL, _outputs, _rptr[input] );
+	  output >= 0;
+	  output = _NextRoundRobin( row, NULL, _outputs, _rptr[input], output ) ) {
+      if ( _out_count[output] < lonely_cnt ) {
 	lonely = output;
-	lonely_cnt = _counts[output];
+	lonely_cnt = _out_count[output];
       }
     }
 
-    // Request the lonely output (-1 for no request)
-    _req[input] = lonely;
+    // Request the lonely output
+    _SetBit( &_requesters[lonely * _out_words], input );
   }
 
   // Grant phase
-  for ( output = 0; output < _outputs; ++output ) {
-    input_offset = _gptr[output];
-
-    for ( int i = 0; i < _inputs; ++i ) {
-      input = ( i + input_offset ) % _inputs;  
-      
-      if ( _req[input] == output ) {
-	// Grant!
-	
-	_inmatch[input]   = output;
-	_outmatch[output] = input;
+  for ( output = _FirstSet( &_out_occ[0], NULL, 0, _outputs ); output >= 0;
+	output = _FirstSet( &_out_occ[0], NULL, output + 1, _outputs ) ) {
+
+    input = _NextRoundRobin( &_requesters[output * _out_words], NULL,
+			     _inputs, _gptr[output] );
+
+    if ( input >= 0 ) {
+      // Grant!
 	
-	_rptr[input] = ( _rptr[input] + 1 ) % _outputs;
-	_gptr[output] = ( _gptr[output] + 1 ) % _inputs;
+      _inmatch[input]   = output;
+      _outmatch[output] = input;
 	
-	break;
-      }
+      _rptr[input] = ( _rptr[input] + 1 ) % _outputs;
+      _gptr[output] = ( _gptr[output] + 1 ) % _inputs;
     }
   }
 
 
 }
 
-
+void LOA::Serialize( Checkpoint & cp )
+{
+  cp.Sync( _rptr );
+  cp.Sync( _gptr );
+}
@@ -32,9 +32,9 @@
 
 #include "allocator.hpp"
 
-class LOA : public DenseAllocator {
-  vector<int> _counts;
-  vector<int> _req;
+class LOA : public BitmapAllocator {
+  // inputs that picked each output as their lonely output
+  vector<unsigned long long> _requesters;
 
   vector<int> _rptr;
   vector<int> _gptr;
@@ -44,6 +44,8 @@ public:
        int inputs, int outputs );
 
   void Allocate( );
+
+  void Serialize( Checkpoint & cp );
 };
 
 #endif
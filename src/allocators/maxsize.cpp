@@ -33,6 +33,7 @@
 #include <iostream>
 
 #include "maxsize.hpp"
+#include "checkpoint.hpp"
 
 // shortest augmenting path:
 //
@@ -70,7 +71,7 @@
 
 MaxSizeMatch::MaxSizeMatch( Module *parent, const string& name,
 			    int inputs, int outputs ) :
-  DenseAllocator( parent, name, inputs, outputs )
+  BitmapAllocator( parent, name, inputs, outputs )
 {
   _from.resize(outputs);
   _s    = new int [inputs];
@@ -120,9 +121,11 @@ bool MaxSizeMatch::_ShortestAugmenting( )
     for ( int e = 0; e < slen; ++e ) {
       i = _s[e];
       
-      for ( j = 0; j < _outputs; ++j ) {
-	if ( ( _request[i][j].label != -1 ) && // edge (i,j) exists
-	     ( _inmatch[i] != j ) &&     // (i,j) is not contained in the current matching
+      unsigned long long const * row = _InputRow( i );
+
+      for ( j = _FirstSet( row, NULL, 0, _outputs ); j >= 0; // edge (i,j) exists
+	    j = _FirstSet( row, NULL, j + 1, _outputs ) ) {
+	if ( ( _inmatch[i] != j ) &&     // (i,j) is not contained in the current matching
 	     ( _from[j] == -1 ) ) {      // no shorter path to j exists
 	  
 	  _from[j] = i;                  // how did we get to j?
@@ -208,3 +211,8 @@ bool MaxSizeMatch::_ShortestAugmenting( )
 
   return true;
 }
+
+void MaxSizeMatch::Serialize( Checkpoint & cp )
+{
+  cp.Sync( _prio );
+}
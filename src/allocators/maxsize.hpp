@@ -32,7 +32,7 @@
 
 #include "allocator.hpp"
 
-class MaxSizeMatch : public DenseAllocator {
+class MaxSizeMatch : public BitmapAllocator {
   vector<int> _from;   // array to hold breadth-first tree
   int *_s;      // stack of leaf nodes in tree
   int *_ns;     // next stack
@@ -46,6 +46,8 @@ public:
   ~MaxSizeMatch( );
   
   void Allocate( );
+
+  void Serialize( Checkpoint & cp );
 };
 
 #endif 
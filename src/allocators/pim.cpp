@@ -35,9 +35,11 @@
 
 PIM::PIM( Module *parent, const string& name,
 	  int inputs, int outputs, int iters ) :
-  DenseAllocator( parent, name, inputs, outputs ),
+  BitmapAllocator( parent, name, inputs, outputs ),
   _PIM_iter(iters)
 {
+  _free_inputs.resize(_out_words);
+  _granted.resize(_inputs * _in_words);
 }
 
 PIM::~PIM( )
@@ -52,27 +54,25 @@ void PIM::Allocate( )
   int input_offset;
   int output_offset;
 
+  _free_inputs.assign(_out_words, ~0ULL);
+
   for ( int iter = 0; iter < _PIM_iter; ++iter ) {
     // Grant phase --- outputs randomly choose
     // between one of their requests
 
-    vector<int> grants(_outputs, -1);
+    _granted.assign(_inputs * _in_words, 0);
 
     for ( output = 0; output < _outputs; ++output ) {
       
       // A random arbiter between input requests
       input_offset  = RandomInt( _inputs - 1 );
       
-      for ( int i = 0; i < _inputs; ++i ) {
-	input = ( i + input_offset ) % _inputs;  
-	
-	if ( ( _request[input][output].label != -1 ) && 
-	     ( _inmatch[input] == -1 ) &&
-	     ( _outmatch[output] == -1 ) ) {
-	  
+      if ( _outmatch[output] == -1 ) {
+	input = _NextRoundRobin( _OutputColumn( output ), &_free_inputs[0],
+				 _inputs, input_offset );
+	if ( input >= 0 ) {
 	  // Grant
-	  grants[output] = input;
-	  break;
+	  _SetBit( &_granted[input * _in_words], output );
 	}
       }
     }
@@ -85,17 +85,15 @@ void PIM::Allocate( )
       // A random arbiter between output grants
       output_offset  = RandomInt( _outputs - 1 );
       
-      for ( int o = 0; o < _outputs; ++o ) {
-	output = ( o + output_offset ) % _outputs;
+      output = _NextRoundRobin( &_granted[input * _in_words], NULL,
+				_outputs, output_offset );
 	
-	if ( grants[output] == input ) {
+      if ( output >= 0 ) {
 	  
-	  // Accept
-	  _inmatch[input]   = output;
-	  _outmatch[output] = input;
-	  
-	  break;
-	}
+	// Accept
+	_inmatch[input]   = output;
+	_outmatch[output] = input;
+	_ClearBit( &_free_inputs[0], input );
       }
     }
   }
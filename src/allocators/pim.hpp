@@ -32,9 +32,13 @@
 
 #include "allocator.hpp"
 
-class PIM : public DenseAllocator {
+class PIM : public BitmapAllocator {
   int _PIM_iter;
 
+  // inputs that are still unmatched, and the outputs granted to each input
+  vector<unsigned long long> _free_inputs;
+  vector<unsigned long long> _granted;
+
 public:
   PIM( Module *parent, const string& name,
        int inputs, int outputs, int iters );
@@ -30,12 +30,13 @@
 
 #include "selalloc.hpp"
 #include "random_utils.hpp"
+#include "checkpoint.hpp"
 
 //#define DEBUG_SELALLOC
 
 SelAlloc::SelAlloc( Module *parent, const string& name,
 		    int inputs, int outputs, int iters ) :
-  SparseAllocator( parent, name, inputs, outputs )
+  BitmapAllocator( parent, name, inputs, outputs )
 {
   _iter = iters;
 
@@ -49,13 +50,6 @@ void SelAlloc::Allocate( )
   int input;
   int output;
 
-  int input_offset;
-  int output_offset;
-
-  map<int, sRequest>::iterator p;
-  set<int>::iterator outer_iter;
-  bool wrapped;
-
   int max_index;
   int max_pri;
 
@@ -64,55 +58,34 @@ void SelAlloc::Allocate( )
   for ( int iter = 0; iter < _iter; ++iter ) {
     // Grant phase
 
-    for( outer_iter = _out_occ.begin( ); 
-	 outer_iter != _out_occ.end( ); ++outer_iter ) {
-      output = *outer_iter;
+    for ( output = _FirstSet( &_out_occ[0], NULL, 0, _outputs ); output >= 0;
+	  output = _FirstSet( &_out_occ[0], NULL, output + 1, _outputs ) ) {
 
-      // Skip loop if there are no requests
-      // or the output is already matched or
-      // the output is masked
-      if ( ( _out_req[output].empty( ) ) ||
-	   ( _outmatch[output] != -1 ) ||
+      // Skip loop if the output is already
+      // matched or the output is masked
+      if ( ( _outmatch[output] != -1 ) ||
 	   ( _outmask[output] != 0 ) ) {
 	continue;
       }
 
       // A round-robin arbiter between input requests
-      input_offset = _gptrs[output];
-
-      p = _out_req[output].begin( );
-      while( ( p != _out_req[output].end( ) ) &&
-	     ( p->second.port < input_offset ) ) {
-	p++;
-      }
+      unsigned long long const * column = _OutputColumn( output );
 
       max_index = -1;
       max_pri   = 0;
 
-      wrapped = false;
-      while( (!wrapped) || 
-	     ( ( p != _out_req[output].end() ) && 
-	       ( p->second.port < input_offset ) ) ) {
-	if ( p == _out_req[output].end( ) ) {
-	  if ( wrapped ) { break; }
-	  // p is valid here because empty lists
-	  // are skipped (above)
-	  p = _out_req[output].begin( );
-	  wrapped = true;
-	}
-
-	input = p->second.port;
+      for ( input = _NextRoundRobin( column, NULL, _inputs, _gptrs[output] );
+	    input >= 0;
+	    input = _NextRoundRobin( column, NULL, _inputs, _gptrs[output], input ) ) {
 
 	// we know the output is free (above) and
 	// if the input is free, check if request is the
 	// highest priority so far
 	if ( ( _inmatch[input] == -1 ) &&
-	     ( ( p->second.out_pri > max_pri ) || ( max_index == -1 ) ) ) {
-	  max_pri   = p->second.out_pri;
+	     ( ( _Request( input, output ).out_pri > max_pri ) || ( max_index == -1 ) ) ) {
+	  max_pri   = _Request( input, output ).out_pri;
 	  max_index = input;
 	}
-
-	p++;
       }   
 
       if ( max_index != -1 ) { // grant
@@ -136,51 +109,27 @@ void SelAlloc::Allocate( )
 
     // Accept phase
 
-    for ( outer_iter = _in_occ.begin( ); 
-	  outer_iter != _in_occ.end( ); ++outer_iter ) {
-      input = *outer_iter;
-
-      if ( _in_req[input].empty( ) ) {
-	continue;
-      }
+    for ( input = _FirstSet( &_in_occ[0], NULL, 0, _inputs ); input >= 0;
+	  input = _FirstSet( &_in_occ[0], NULL, input + 1, _inputs ) ) {
 
       // A round-robin arbiter between output grants
-      output_offset = _aptrs[input];
-
-      p = _in_req[input].begin( );
-      while( ( p != _in_req[input].end( ) ) &&
-	     ( p->second.port < output_offset ) ) {
-	p++;
-      }
+      unsigned long long const * row = _InputRow( input );
 
       max_index = -1;
       max_pri   = 0;
 
-      wrapped = false;
-      while( (!wrapped) || 
-	     ( ( p != _in_req[input].end() ) && 
-	       ( p->second.port < output_offset ) ) ) {
-	if ( p == _in_req[input].end( ) ) {
-	  if ( wrapped ) { break; }
-	  // p is valid here because empty lists
-	  // are skipped (above)
-	  p = _in_req[input].begin( );
-	  wrapped = true;
-	}
-
-	output = p->second.port;
+      for ( output = _NextRoundRobin( row, NULL, _outputs, _aptrs[input] );
+	    output >= 0;
+	    output = _NextRoundRobin( row, NULL, _outputs, _aptrs[input], output ) ) {
 
 	// we know the output is free (above) and
 	// if the input is free, check if the highest
 	// priroity
 	if ( ( grants[output] == input ) && 
-	     ( !_out_req[output].empty( ) ) &&
-	     ( ( p->second.in_pri > max_pri ) || ( max_index == -1 ) ) ) {
-	  max_pri   = p->second.in_pri;
+	     ( ( _Request( input, output ).in_pri > max_pri ) || ( max_index == -1 ) ) ) {
+	  max_pri   = _Request( input, output ).in_pri;
 	  max_index = output;
 	}
-
-	p++;
       } 
 
       if ( max_index != -1 ) {
@@ -222,16 +171,15 @@ void SelAlloc::MaskOutput( int out, int mask )
 
 void SelAlloc::PrintRequests( ostream * os ) const
 {
-  map<int, sRequest>::const_iterator iter;
-  
   if(!os) os = &cout;
   
   *os << "Input requests = [ ";
   for ( int input = 0; input < _inputs; ++input ) {
     *os << input << " -> [ ";
-    for ( iter = _in_req[input].begin( ); 
-	  iter != _in_req[input].end( ); iter++ ) {
-      *os << iter->second.port << " ";
+    unsigned long long const * row = _InputRow( input );
+    for ( int output = _FirstSet( row, NULL, 0, _outputs ); output >= 0;
+	  output = _FirstSet( row, NULL, output + 1, _outputs ) ) {
+      *os << output << " ";
     }
     *os << "]  ";
   }
@@ -240,9 +188,10 @@ void SelAlloc::PrintRequests( ostream * os ) const
     *os << output << " -> ";
     if ( _outmask[output] == 0 ) {
       *os << "[ ";
-      for ( iter = _out_req[output].begin( ); 
-	    iter != _out_req[output].end( ); iter++ ) {
-	*os << iter->second.port << " ";
+      unsigned long long const * column = _OutputColumn( output );
+      for ( int input = _FirstSet( column, NULL, 0, _inputs ); input >= 0;
+	    input = _FirstSet( column, NULL, input + 1, _inputs ) ) {
+	*os << input << " ";
       }
       *os << "]  ";
     } else {
@@ -252,3 +201,9 @@ void SelAlloc::PrintRequests( ostream * os ) const
   *os << "]." << endl;
 }
 
+void SelAlloc::Serialize( Checkpoint & cp )
+{
+  cp.Sync( _aptrs );
+  cp.Sync( _gptrs );
+  cp.Sync( _outmask );
+}
@@ -32,7 +32,7 @@
 
 #include "allocator.hpp"
 
-class SelAlloc : public SparseAllocator {
+class SelAlloc : public BitmapAllocator {
   int _iter;
 
   vector<int> _aptrs;
@@ -46,6 +46,8 @@ public:
 
   void Allocate( );
 
+  void Serialize( Checkpoint & cp );
+
   void MaskOutput( int out, int mask = 1 );
 
   virtual void PrintRequests( ostream * os = NULL ) const;
@@ -36,11 +36,12 @@
 #include <sstream>
 
 #include "arbiter.hpp"
+#include "checkpoint.hpp"
 
 SeparableAllocator::SeparableAllocator( Module* parent, const string& name,
 					int inputs, int outputs,
 					const string& arb_type )
-  : SparseAllocator( parent, name, inputs, outputs )
+  : BitmapAllocator( parent, name, inputs, outputs )
 {
   
   _input_arb.resize(inputs);
@@ -82,5 +83,14 @@ void SeparableAllocator::Clear() {
     if(_output_arb[o]->_num_reqs)
       _output_arb[o]->Clear();
   }
-  SparseAllocator::Clear();
+  BitmapAllocator::Clear();
+}
+
+void SeparableAllocator::Serialize( Checkpoint & cp ) {
+  for ( int i = 0 ; i < _inputs ; ++i ) {
+    _input_arb[i]->Serialize( cp ) ;
+  }
+  for ( int o = 0; o < _outputs; ++o ) {
+    _output_arb[o]->Serialize( cp ) ;
+  }
 }
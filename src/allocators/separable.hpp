@@ -40,7 +40,7 @@
 
 class Arbiter;
 
-class SeparableAllocator : public SparseAllocator {
+class SeparableAllocator : public BitmapAllocator {
   
 protected:
 
@@ -56,6 +56,8 @@ public:
 
   virtual void Clear() ;
 
+  virtual void Serialize( Checkpoint & cp ) ;
+
 } ;
 
 #endif
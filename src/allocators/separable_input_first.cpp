@@ -48,21 +48,18 @@ SeparableInputFirstAllocator( Module* parent, const string& name, int inputs,
 
 void SeparableInputFirstAllocator::Allocate() {
   
-  set<int>::const_iterator port_iter = _in_occ.begin();
-  while(port_iter != _in_occ.end()) {
+  for(int input = _FirstSet(&_in_occ[0], NULL, 0, _inputs); input >= 0;
+      input = _FirstSet(&_in_occ[0], NULL, input + 1, _inputs)) {
     
-    const int & input = *port_iter;
-
     // add requests to the input arbiter
 
-    map<int, sRequest>::const_iterator req_iter = _in_req[input].begin();
-    while(req_iter != _in_req[input].end()) {
+    unsigned long long const * row = _InputRow(input);
+    for(int output = _FirstSet(row, NULL, 0, _outputs); output >= 0;
+	output = _FirstSet(row, NULL, output + 1, _outputs)) {
 
-      const sRequest & req = req_iter->second;
+      const sRequest & req = _Request(input, output);
       
-      _input_arb[input]->AddRequest(req.port, req.label, req.in_pri);
-
-      ++req_iter;
+      _input_arb[input]->AddRequest(output, req.label, req.in_pri);
     }
 
     // Execute the input arbiters and propagate the grants to the
@@ -72,18 +69,14 @@ void SeparableInputFirstAllocator::Allocate() {
     const int output = _input_arb[input]->Arbitrate(&label, NULL);
     assert(output > -1);
 
-    const sRequest & req = _out_req[output][input]; 
-    assert((req.port == input) && (req.label == label));
-
-    _output_arb[output]->AddRequest(req.port, req.label, req.out_pri);
+    const sRequest & req = _Request(input, output); 
+    assert(req.label == label);
 
-    ++port_iter;
+    _output_arb[output]->AddRequest(input, req.label, req.out_pri);
   }
 
-  port_iter = _out_occ.begin();
-  while(port_iter != _out_occ.end()) {
-
-    const int & output = *port_iter;
+  for(int output = _FirstSet(&_out_occ[0], NULL, 0, _outputs); output >= 0;
+      output = _FirstSet(&_out_occ[0], NULL, output + 1, _outputs)) {
 
     // Execute the output arbiters.
     
@@ -97,7 +90,5 @@ void SeparableInputFirstAllocator::Allocate() {
       _input_arb[input]->UpdateState() ;
       _output_arb[output]->UpdateState() ;
     }
-
-    ++port_iter;
   }
 }
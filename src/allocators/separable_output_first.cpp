@@ -48,21 +48,18 @@ SeparableOutputFirstAllocator( Module* parent, const string& name, int inputs,
 
 void SeparableOutputFirstAllocator::Allocate() {
   
-  set<int>::const_iterator port_iter = _out_occ.begin();
-  while(port_iter != _out_occ.end()) {
+  for(int output = _FirstSet(&_out_occ[0], NULL, 0, _outputs); output >= 0;
+      output = _FirstSet(&_out_occ[0], NULL, output + 1, _outputs)) {
     
-    const int & output = *port_iter;
-
     // add requests to the output arbiter
 
-    map<int, sRequest>::const_iterator req_iter = _out_req[output].begin();
-    while(req_iter != _out_req[output].end()) {
+    unsigned long long const * column = _OutputColumn(output);
+    for(int input = _FirstSet(column, NULL, 0, _inputs); input >= 0;
+	input = _FirstSet(column, NULL, input + 1, _inputs)) {
       
-      const sRequest & req = req_iter->second;
-
-      _output_arb[output]->AddRequest(req.port, req.label, req.out_pri);
+      const sRequest & req = _Request(input, output);
 
-      ++req_iter;
+      _output_arb[output]->AddRequest(input, req.label, req.out_pri);
     }
     
     // Execute the output arbiter and propagate the grants to the
@@ -72,19 +69,15 @@ void SeparableOutputFirstAllocator::Allocate() {
     const int input = _output_arb[output]->Arbitrate(&label, NULL);
     assert(input > -1);
 
-    const sRequest & req = _in_req[input][output];
-    assert((req.port == output) && (req.label == label));
-
-    _input_arb[input]->AddRequest(req.port, req.label, req.in_pri);
+    const sRequest & req = _Request(input, output);
+    assert(req.label == label);
 
-    ++port_iter;
+    _input_arb[input]->AddRequest(output, req.label, req.in_pri);
   }
   
-  port_iter = _in_occ.begin();
-  while(port_iter != _in_occ.end()) {
+  for(int input = _FirstSet(&_in_occ[0], NULL, 0, _inputs); input >= 0;
+      input = _FirstSet(&_in_occ[0], NULL, input + 1, _inputs)) {
     
-    const int & input = *port_iter;
-
     // Execute the input arbiters.
     
     const int output = _input_arb[input]->Arbitrate(NULL, NULL);
@@ -97,7 +90,5 @@ void SeparableOutputFirstAllocator::Allocate() {
       _input_arb[input]->UpdateState() ;
       _output_arb[output]->UpdateState() ;
     }
-    
-    ++port_iter;
   }
 }
@@ -0,0 +1,344 @@
+// $Id$
+
+/*
+ Copyright (c) 2007-2012, Trustees of The Leland Stanford Junior University
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ Redistributions of source code must retain the above copyright notice, this 
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice, this
+ list of conditions and the following disclaimer in the documentation and/or
+ other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE 
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// ----------------------------------------------------------------------
+//
+//  VCMaskAllocator: Separable allocator with round-robin arbiters that
+//  keeps its requests as 64-bit masks of outputs
+//
+// ----------------------------------------------------------------------
+
+#include "vc_mask.hpp"
+
+#include <iostream>
+#include <sstream>
+#include <cassert>
+
+#include "booksim.hpp"
+#include "roundrobin_arb.hpp"
+#include "checkpoint.hpp"
+
+VCMaskAllocator::VCMaskAllocator( Module *parent, const string& name,
+				  int inputs, int outputs, bool output_first )
+  : Allocator( parent, name, inputs, outputs ), _output_first( output_first )
+{
+  _requests.resize(_inputs);
+  _input_pointer.resize(_inputs, 0);
+  _output_pointer.resize(_outputs, 0);
+  _out_best_input.resize(_outputs, -1);
+  _out_best_pri.resize(_outputs);
+  _out_best_in_pri.resize(_outputs);
+  _output_offered.resize((_outputs + 63) / 64, 0);
+  _in_best_output.resize(_inputs, -1);
+  _in_best_pri.resize(_inputs);
+  _input_offered.resize((_inputs + 63) / 64, 0);
+}
+
+void VCMaskAllocator::Clear( )
+{
+  for ( size_t i = 0; i < _requesting_inputs.size( ); ++i ) {
+    _requests[_requesting_inputs[i]].clear( );
+  }
+  _requesting_inputs.clear( );
+  Allocator::Clear( );
+}
+
+VCMaskAllocator::sRequestMask const * VCMaskAllocator::_FindRequest( int in, int out ) const
+{
+  assert( ( in >= 0 ) && ( in < _inputs ) );
+  assert( ( out >= 0 ) && ( out < _outputs ) );
+
+  for ( vector<sRequestMask>::const_iterator iter = _requests[in].begin( );
+	iter != _requests[in].end( ); ++iter ) {
+    int const offset = out - iter->first;
+    if ( ( offset >= 0 ) && ( offset < 64 ) &&
+	 ( ( iter->mask >> offset ) & 1 ) ) {
+      return &*iter;
+    }
+  }
+  return NULL;
+}
+
+int VCMaskAllocator::ReadRequest( int in, int out ) const
+{
+  sRequestMask const * const req = _FindRequest( in, out );
+  return req ? req->label : -1;
+}
+
+bool VCMaskAllocator::ReadRequest( sRequest &req, int in, int out ) const
+{
+  sRequestMask const * const r = _FindRequest( in, out );
+  if ( !r ) {
+    return false;
+  }
+  req.port    = out;
+  req.label   = r->label;
+  req.in_pri  = r->in_pri;
+  req.out_pri = r->out_pri;
+  return true;
+}
+
+void VCMaskAllocator::AddRequest( int in, int out, int label, 
+				  int in_pri, int out_pri )
+{
+  AddRequestMask( in, out, 1, label, in_pri, out_pri );
+}
+
+void VCMaskAllocator::AddRequestMask( int in, int first, unsigned long long mask,
+				      int label, int in_pri, int out_pri )
+{
+  Allocator::AddRequest( in, first, label, in_pri, out_pri );
+  assert( mask );
+  assert( first + 63 - __builtin_clzll( mask ) < _outputs );
+
+  if ( _requests[in].empty( ) ) {
+    _requesting_inputs.push_back( in );
+  }
+
+  sRequestMask req;
+  req.first   = first;
+  req.mask    = mask;
+  req.label   = label;
+  req.in_pri  = in_pri;
+  req.out_pri = out_pri;
+  _requests[in].push_back( req );
+}
+
+void VCMaskAllocator::RemoveRequest( int in, int out, int label )
+{
+  sRequestMask * const req = const_cast<sRequestMask *>( _FindRequest( in, out ) );
+  assert( req );
+  assert( req->label == label );
+  req->mask &= ~( 1ULL << ( out - req->first ) );
+}
+
+// The input arbiter grants the requested output with the highest priority
+// that comes first in round-robin order. Within one mask, that is the
+// first requested output at or after the arbiter's pointer or, if all of
+// them lie before it, the first one overall.
+int VCMaskAllocator::_InputArbitrate( int in, sRequestMask const * * req ) const
+{
+  int const pointer = _input_pointer[in];
+
+  int best_output = -1;
+  int best_pri = 0;
+  int best_distance = 0;
+
+  for ( vector<sRequestMask>::const_iterator iter = _requests[in].begin( );
+	iter != _requests[in].end( ); ++iter ) {
+
+    if ( !iter->mask || ( ( best_output >= 0 ) && ( iter->in_pri < best_pri ) ) ) {
+      continue;
+    }
+
+    unsigned long long mask = iter->mask;
+    int const offset = pointer - iter->first;
+    if ( ( offset > 0 ) && ( offset < 64 ) ) {
+      unsigned long long const upper = mask & ( ~0ULL << offset );
+      if ( upper ) {
+	mask = upper;
+      }
+    }
+    int const output = iter->first + __builtin_ctzll( mask );
+    int const distance = ( output - pointer + _outputs ) % _outputs;
+
+    if ( ( best_output < 0 ) || ( iter->in_pri > best_pri ) ||
+	 ( distance < best_distance ) ) {
+      best_output = output;
+      best_pri = iter->in_pri;
+      best_distance = distance;
+      *req = &*iter;
+    }
+  }
+  return best_output;
+}
+
+void VCMaskAllocator::_OfferOutput( int out, int in, int out_pri, int in_pri )
+{
+  unsigned long long & offered = _output_offered[out >> 6];
+  unsigned long long const bit = 1ULL << ( out & 63 );
+  if ( !( offered & bit ) ||
+       RoundRobinArbiter::Supersedes( in, out_pri, _out_best_input[out],
+				      _out_best_pri[out], _output_pointer[out],
+				      _inputs ) ) {
+    offered |= bit;
+    _out_best_input[out] = in;
+    _out_best_pri[out] = out_pri;
+    _out_best_in_pri[out] = in_pri;
+  }
+}
+
+void VCMaskAllocator::_OfferInput( int in, int out, int in_pri )
+{
+  unsigned long long & offered = _input_offered[in >> 6];
+  unsigned long long const bit = 1ULL << ( in & 63 );
+  if ( !( offered & bit ) ||
+       RoundRobinArbiter::Supersedes( out, in_pri, _in_best_output[in],
+				      _in_best_pri[in], _input_pointer[in],
+				      _outputs ) ) {
+    offered |= bit;
+    _in_best_output[in] = out;
+    _in_best_pri[in] = in_pri;
+  }
+}
+
+void VCMaskAllocator::_Grant( int in, int out )
+{
+  assert( ( _inmatch[in] == -1 ) && ( _outmatch[out] == -1 ) );
+
+  _inmatch[in] = out;
+  _outmatch[out] = in;
+  _input_pointer[in] = ( out + 1 ) % _outputs;
+  _output_pointer[out] = ( in + 1 ) % _inputs;
+}
+
+void VCMaskAllocator::Allocate( )
+{
+  if ( !_output_first ) {
+
+    // each input forwards its winning request to the output arbiter
+
+    for ( size_t i = 0; i < _requesting_inputs.size( ); ++i ) {
+      int const input = _requesting_inputs[i];
+      sRequestMask const * req = NULL;
+      int const output = _InputArbitrate( input, &req );
+      if ( output >= 0 ) {
+	_OfferOutput( output, input, req->out_pri, req->in_pri );
+      }
+    }
+
+    for ( size_t w = 0; w < _output_offered.size( ); ++w ) {
+      for ( unsigned long long bits = _output_offered[w]; bits; bits &= bits - 1 ) {
+	int const output = 64 * w + __builtin_ctzll( bits );
+	_Grant( _out_best_input[output], output );
+      }
+      _output_offered[w] = 0;
+    }
+
+  } else {
+
+    // every request goes to its output arbiter, and each output forwards
+    // its winner to the input arbiter
+
+    for ( size_t i = 0; i < _requesting_inputs.size( ); ++i ) {
+      int const input = _requesting_inputs[i];
+      for ( vector<sRequestMask>::const_iterator iter = _requests[input].begin( );
+	    iter != _requests[input].end( ); ++iter ) {
+	for ( unsigned long long bits = iter->mask; bits; bits &= bits - 1 ) {
+	  _OfferOutput( iter->first + __builtin_ctzll( bits ), input,
+			iter->out_pri, iter->in_pri );
+	}
+      }
+    }
+
+    for ( size_t w = 0; w < _output_offered.size( ); ++w ) {
+      for ( unsigned long long bits = _output_offered[w]; bits; bits &= bits - 1 ) {
+	int const output = 64 * w + __builtin_ctzll( bits );
+	_OfferInput( _out_best_input[output], output, _out_best_in_pri[output] );
+      }
+      _output_offered[w] = 0;
+    }
+
+    for ( size_t w = 0; w < _input_offered.size( ); ++w ) {
+      for ( unsigned long long bits = _input_offered[w]; bits; bits &= bits - 1 ) {
+	int const input = 64 * w + __builtin_ctzll( bits );
+	_Grant( input, _in_best_output[input] );
+      }
+      _input_offered[w] = 0;
+    }
+  }
+}
+
+bool VCMaskAllocator::InputHasRequests( int in ) const
+{
+  return NumInputRequests( in ) > 0;
+}
+
+bool VCMaskAllocator::OutputHasRequests( int out ) const
+{
+  return NumOutputRequests( out ) > 0;
+}
+
+int VCMaskAllocator::NumInputRequests( int in ) const
+{
+  int result = 0;
+  for ( vector<sRequestMask>::const_iterator iter = _requests[in].begin( );
+	iter != _requests[in].end( ); ++iter ) {
+    result += __builtin_popcountll( iter->mask );
+  }
+  return result;
+}
+
+int VCMaskAllocator::NumOutputRequests( int out ) const
+{
+  int result = 0;
+  for ( size_t i = 0; i < _requesting_inputs.size( ); ++i ) {
+    if ( _FindRequest( _requesting_inputs[i], out ) ) {
+      ++result;
+    }
+  }
+  return result;
+}
+
+void VCMaskAllocator::PrintRequests( ostream * os ) const
+{
+  if(!os) os = &cout;
+
+  *os << "Input requests = [ ";
+  for ( int input = 0; input < _inputs; ++input ) {
+    if ( InputHasRequests( input ) ) {
+      *os << input << " -> [ ";
+      for ( int output = 0; output < _outputs; ++output ) {
+	sRequestMask const * const req = _FindRequest( input, output );
+	if ( req ) {
+	  *os << output << "@" << req->in_pri << " ";
+	}
+      }
+      *os << "]  ";
+    }
+  }
+  *os << "], output requests = [ ";
+  for ( int output = 0; output < _outputs; ++output ) {
+    ostringstream ss;
+    for ( int input = 0; input < _inputs; ++input ) {
+      sRequestMask const * const req = _FindRequest( input, output );
+      if ( req ) {
+	ss << input << "@" << req->out_pri << " ";
+      }
+    }
+    if ( !ss.str( ).empty( ) ) {
+      *os << output << " -> [ " << ss.str( ) << "]  ";
+    }
+  }
+  *os << "]." << endl;
+}
+
+void VCMaskAllocator::Serialize( Checkpoint & cp )
+{
+  cp.Sync( _input_pointer );
+  cp.Sync( _output_pointer );
+}
@@ -0,0 +1,113 @@
+// $Id$
+
+/*
+ Copyright (c) 2007-2012, Trustees of The Leland Stanford Junior University
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ Redistributions of source code must retain the above copyright notice, this 
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice, this
+ list of conditions and the following disclaimer in the documentation and/or
+ other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE 
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// ----------------------------------------------------------------------
+//
+//  VCMaskAllocator: Separable allocator with round-robin arbiters that
+//  keeps its requests as 64-bit masks of outputs. An input typically
+//  requests a contiguous range of VCs at each output port, so one mask
+//  covers a whole route set element, and input arbitration picks the
+//  winner of each mask with a single bit scan instead of looking at
+//  every VC. Grants are identical to those of the separable input- or
+//  output-first allocator with round-robin arbiters.
+//
+// ----------------------------------------------------------------------
+
+#ifndef _VC_MASK_HPP_
+#define _VC_MASK_HPP_
+
+#include <vector>
+
+#include "allocator.hpp"
+
+class VCMaskAllocator : public Allocator {
+
+  // requests for outputs first + i for each bit i of mask
+  struct sRequestMask {
+    int first;
+    unsigned long long mask;
+    int label;
+    int in_pri;
+    int out_pri;
+  };
+
+  bool _output_first;
+
+  vector<vector<sRequestMask> > _requests;
+  vector<int> _requesting_inputs;
+
+  // round-robin pointers of the input and output arbiters
+  vector<int> _input_pointer;
+  vector<int> _output_pointer;
+
+  // best request offered to each output and input arbiter so far, with
+  // one bit per arbiter that has been offered any request
+  vector<int> _out_best_input;
+  vector<int> _out_best_pri;
+  vector<int> _out_best_in_pri;
+  vector<unsigned long long> _output_offered;
+  vector<int> _in_best_output;
+  vector<int> _in_best_pri;
+  vector<unsigned long long> _input_offered;
+
+  sRequestMask const * _FindRequest( int in, int out ) const;
+  int _InputArbitrate( int in, sRequestMask const * * req ) const;
+  void _OfferOutput( int out, int in, int out_pri, int in_pri );
+  void _OfferInput( int in, int out, int in_pri );
+  void _Grant( int in, int out );
+
+public:
+
+  VCMaskAllocator( Module *parent, const string& name,
+		   int inputs, int outputs, bool output_first );
+
+  void Clear( );
+
+  int  ReadRequest( int in, int out ) const;
+  bool ReadRequest( sRequest &req, int in, int out ) const;
+
+  void AddRequest( int in, int out, int label = 1, 
+		   int in_pri = 0, int out_pri = 0 );
+  void AddRequestMask( int in, int first, unsigned long long mask,
+		       int label = 1, int in_pri = 0, int out_pri = 0 );
+  void RemoveRequest( int in, int out, int label = 1 );
+
+  void Allocate( );
+
+  bool OutputHasRequests( int out ) const;
+  bool InputHasRequests( int in ) const;
+
+  int NumOutputRequests( int out ) const;
+  int NumInputRequests( int in ) const;
+
+  void PrintRequests( ostream * os = NULL ) const;
+
+  void Serialize( Checkpoint & cp );
+
+};
+
+#endif
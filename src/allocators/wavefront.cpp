@@ -33,10 +33,11 @@
 #include "booksim.hpp"
 
 #include "wavefront.hpp"
+#include "checkpoint.hpp"
 
 Wavefront::Wavefront( Module *parent, const string& name,
 		      int inputs, int outputs, bool skip_diags ) :
-  DenseAllocator( parent, name, inputs, outputs ),
+  BitmapAllocator( parent, name, inputs, outputs ),
   _last_in(-1), _last_out(-1), _skip_diags(skip_diags), 
   _square(max(inputs, outputs)), _pri(0), _num_requests(0)
 {
@@ -45,7 +46,7 @@ Wavefront::Wavefront( Module *parent, const string& name,
 void Wavefront::AddRequest( int in, int out, int label, 
 			    int in_pri, int out_pri )
 {
-  DenseAllocator::AddRequest(in, out, label, in_pri, out_pri);
+  BitmapAllocator::AddRequest(in, out, label, in_pri, out_pri);
   _num_requests++;
   _last_in = in;
   _last_out = out;
@@ -82,9 +83,9 @@ void Wavefront::Allocate( )
 	  int input = ( ( _pri + p ) + ( _square - output ) ) % _square;
 	  if ( ( input < _inputs ) && ( output < _outputs ) && 
 	       ( _inmatch[input] == -1 ) && ( _outmatch[output] == -1 ) &&
-	       ( _request[input][output].label != -1 ) &&
-	       ( _request[input][output].in_pri == iter->second ) &&
-	       ( _request[input][output].out_pri == iter->first ) ) {
+	       _HasRequest( input, output ) &&
+	       ( _Request( input, output ).in_pri == iter->second ) &&
+	       ( _Request( input, output ).out_pri == iter->first ) ) {
 	    // Grant!
 	    _inmatch[input] = output;
 	    _outmatch[output] = input;
@@ -108,4 +109,7 @@ void Wavefront::Allocate( )
   _pri = ( ( _skip_diags ? first_diag : _pri ) + 1 ) % _square;
 }
 
-
+void Wavefront::Serialize( Checkpoint & cp )
+{
+  cp.Sync( _pri );
+}
@@ -38,6 +38,8 @@
 
 #include "module.hpp"
 
+class Checkpoint;
+
 class Arbiter : public Module {
 
 protected:
@@ -75,6 +77,9 @@ public:
 
   virtual void Clear();
 
+  // save or restore the priority state that is kept across cycles
+  virtual void Serialize( Checkpoint & cp ) { }
+
   inline int LastWinner() const {
     return _selected;
   }
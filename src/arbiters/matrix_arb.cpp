@@ -32,6 +32,7 @@
 // ----------------------------------------------------------------------
 
 #include "matrix_arb.hpp"
+#include "checkpoint.hpp"
 #include <iostream>
 using namespace std ;
 
@@ -119,3 +120,8 @@ void MatrixArbiter::Clear()
   _last_req = -1;
   Arbiter::Clear();
 }
+
+void MatrixArbiter::Serialize( Checkpoint & cp )
+{
+  cp.Sync( _matrix ) ;
+}
@@ -32,6 +32,7 @@
 // ----------------------------------------------------------------------
 
 #include "tree_arb.hpp"
+#include "checkpoint.hpp"
 #include <iostream>
 #include <sstream>
 
@@ -117,3 +118,11 @@ void TreeArbiter::Clear()
   _global_arbiter->Clear();
   Arbiter::Clear();
 }
+
+void TreeArbiter::Serialize( Checkpoint & cp )
+{
+  for(int i = 0; i < (int)_group_arbiters.size(); ++i) {
+    _group_arbiters[i]->Serialize(cp);
+  }
+  _global_arbiter->Serialize(cp);
+}
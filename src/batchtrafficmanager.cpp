@@ -40,6 +40,10 @@ BatchTrafficManager::BatchTrafficManager( const Configuration &config,
    _overall_max_batch_time(0)
 {
 
+  if(!config.GetStr("flow_file").empty()) {
+    Error( "Flow files are not supported in batch mode." );
+  }
+
   _max_outstanding = config.GetInt ("max_outstanding_requests");  
 
   _batch_size = config.GetInt( "batch_size" );
@@ -69,6 +73,18 @@ void BatchTrafficManager::_RetireFlit( Flit *f, int dest )
   TrafficManager::_RetireFlit(f, dest);
 }
 
+// every source sends a full batch, regardless of the injection rate
+bool BatchTrafficManager::_SourceActive( int source, int cl ) const
+{
+  return true;
+}
+
+// batches do not use the injection processes
+int BatchTrafficManager::_QuietCalls( int source, int cl ) const
+{
+  return 0;
+}
+
 int BatchTrafficManager::_IssuePacket( int source, int cl )
 {
   int result = 0;
@@ -85,7 +101,7 @@ int BatchTrafficManager::_IssuePacket( int source, int cl )
 	  (_requestsOutstanding[source] < _max_outstanding))) {
 	
 	//coin toss to determine request type.
-	result = (RandomFloat() < 0.5) ? 2 : 1;
+	result = (_packet_random[source][cl].Float() < 0.5) ? 2 : 1;
       
 	_requestsOutstanding[source]++;
       }
@@ -94,7 +110,7 @@ int BatchTrafficManager::_IssuePacket( int source, int cl )
     if((_packet_seq_no[source] < _batch_size) && 
        ((_max_outstanding <= 0) || 
 	(_requestsOutstanding[source] < _max_outstanding))) {
-      result = _GetNextPacketSize(cl);
+      result = _GetNextPacketSize(source, cl);
       _requestsOutstanding[source]++;
     }
   }
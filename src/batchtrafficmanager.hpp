@@ -53,6 +53,8 @@ protected:
 
   virtual void _RetireFlit( Flit *f, int dest );
 
+  virtual bool _SourceActive( int source, int cl ) const;
+  virtual int _QuietCalls( int source, int cl ) const;
   virtual int _IssuePacket( int source, int cl );
   virtual void _ClearStats( );
   virtual bool _SingleSim( );
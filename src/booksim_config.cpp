@@ -46,6 +46,8 @@ BookSimConfig::BookSimConfig( )
 
   // Physical sub-networks
   _int_map["subnets"] = 1;
+  // step each sub-network on its own thread
+  _int_map["parallel_subnets"] = 0;
 
   //==== Topology options =======================
   AddStrField( "topology", "torus" );
@@ -178,6 +180,13 @@ BookSimConfig::BookSimConfig( )
 
   AddStrField( "injection_process", "bernoulli" );
 
+  // periodic flows (source, dest, class, period, ...) that replace the
+  // injection processes and traffic patterns
+  AddStrField( "flow_file", "" );
+
+  // binary packet trace replayed by sim_type = trace
+  AddStrField( "trace_file", "" );
+
   _float_map["burst_alpha"] = 0.5; // burst interval
   _float_map["burst_beta"]  = 0.5; // burst length
   _float_map["burst_r1"] = -1.0; // burst rate
@@ -256,7 +265,20 @@ BookSimConfig::BookSimConfig( )
   AddStrField("acc_stopping_thres", ""); // workaround to allow for vector specification
 
   _int_map["sim_count"]     = 1;   // number of simulations to perform
+  _int_map["sim_jobs"]      = 1;   // concurrent simulations (0: one per CPU)
+
+  // injection rates of a load sweep, either {r1,r2,...} or {min:step:max};
+  // empty runs a single simulation at injection_rate
+  AddStrField("sweep_rates", "");
+  _int_map["sweep_jobs"]    = 0;   // concurrent sweep points (0: one per CPU)
+  // fork all sweep points from one simulation warmed up at the first rate
+  _int_map["sweep_warm_start"] = 0;
 
+  // save the simulation state to checkpoint_file every checkpoint_period
+  // sample periods, and continue a simulation from a saved checkpoint
+  AddStrField("checkpoint_file", "");
+  _int_map["checkpoint_period"] = 0;
+  AddStrField("resume_from", "");
 
   _int_map["include_queuing"] =1; // non-zero includes source queuing latency
 
@@ -270,10 +292,19 @@ BookSimConfig::BookSimConfig( )
 
   _int_map["print_activity"] = 0;
 
+  // number of threads used to evaluate the routers and channels of each
+  // network; results are identical to a single-threaded run
+  _int_map["network_threads"] = 1;
+
   _int_map["print_csv_results"] = 0;
 
   _int_map["deadlock_warn_timeout"] = 256;
 
+  // skip over cycles in which the network is empty and no injection process
+  // can fire; only takes effect for processes that predict their next
+  // injection (not request-reply traffic)
+  _int_map["idle_fast_forward"] = 0;
+
   _int_map["viewer_trace"] = 0;
 
   AddStrField("watch_file", "");
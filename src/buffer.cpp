@@ -30,6 +30,7 @@
 #include "globals.hpp"
 #include "booksim.hpp"
 #include "buffer.hpp"
+#include "checkpoint.hpp"
 
 Buffer::Buffer( const Configuration& config, int outputs, 
 		Module *parent, const string& name ) :
@@ -50,6 +51,14 @@ Module( parent, name ), _occupancy(0)
     _vc[i] = new VC(config, outputs, this, vc_name.str( ) );
   }
 
+  // each VC gets room for an even share of the buffer; under a shared
+  // buffer policy, a VC that holds more moves its flits to its own array
+  int const vc_capacity = RingBuffer<Flit::Handle>::RoundCapacity(_size / num_vcs);
+  _storage.resize(num_vcs * vc_capacity);
+  for(int i = 0; i < num_vcs; ++i) {
+    _vc[i]->AttachStorage(&_storage[i * vc_capacity], vc_capacity);
+  }
+
 #ifdef TRACK_BUFFERS
   int classes = config.GetInt("classes");
   _class_occupancy.resize(classes, 0);
@@ -75,6 +84,17 @@ void Buffer::AddFlit( int vc, Flit *f )
 #endif
 }
 
+void Buffer::Serialize(Checkpoint & cp)
+{
+  cp.Sync(_occupancy);
+  for(size_t vc = 0; vc < _vc.size(); ++vc) {
+    _vc[vc]->Serialize(cp);
+  }
+#ifdef TRACK_BUFFERS
+  cp.Sync(_class_occupancy);
+#endif
+}
+
 void Buffer::Display( ostream & os ) const
 {
   for(vector<VC*>::const_iterator i = _vc.begin(); i != _vc.end(); ++i) {
@@ -43,6 +43,9 @@ class Buffer : public Module {
 
   vector<VC*> _vc;
 
+  // flit storage of all VCs, one power-of-two slice per VC
+  vector<Flit::Handle> _storage;
+
 #ifdef TRACK_BUFFERS
   vector<int> _class_occupancy;
 #endif
@@ -156,6 +159,8 @@ public:
 #endif
 
   void Display( ostream & os = cout ) const;
+
+  void Serialize( Checkpoint & cp );
 };
 
 #endif 
@@ -39,6 +39,7 @@
 
 #include "booksim.hpp"
 #include "buffer_state.hpp"
+#include "checkpoint.hpp"
 #include "random_utils.hpp"
 #include "globals.hpp"
 
@@ -261,6 +262,13 @@ int BufferState::SharedBufferPolicy::LimitFor(int vc) const
   return (_private_buf_size[i] + _shared_buf_size);
 }
 
+void BufferState::SharedBufferPolicy::Serialize(Checkpoint & cp)
+{
+  cp.Sync(_private_buf_occupancy);
+  cp.Sync(_shared_buf_occupancy);
+  cp.Sync(_reserved_slots);
+}
+
 BufferState::LimitedSharedBufferPolicy::LimitedSharedBufferPolicy(Configuration const & config, BufferState * parent, const string & name)
   : SharedBufferPolicy(config, parent, name), _active_vcs(0)
 {
@@ -307,6 +315,13 @@ int BufferState::LimitedSharedBufferPolicy::LimitFor(int vc) const
   return min(SharedBufferPolicy::LimitFor(vc), _max_held_slots);
 }
 
+void BufferState::LimitedSharedBufferPolicy::Serialize(Checkpoint & cp)
+{
+  SharedBufferPolicy::Serialize(cp);
+  cp.Sync(_active_vcs);
+  cp.Sync(_max_held_slots);
+}
+
 BufferState::DynamicLimitedSharedBufferPolicy::DynamicLimitedSharedBufferPolicy(Configuration const & config, BufferState * parent, const string & name)
   : LimitedSharedBufferPolicy(config, parent, name)
 {
@@ -489,6 +504,16 @@ int BufferState::FeedbackSharedBufferPolicy::LimitFor(int vc) const
   return min(SharedBufferPolicy::LimitFor(vc), _ComputeMaxSlots(vc));
 }
 
+void BufferState::FeedbackSharedBufferPolicy::Serialize(Checkpoint & cp)
+{
+  SharedBufferPolicy::Serialize(cp);
+  cp.Sync(_occupancy_limit);
+  cp.Sync(_round_trip_time);
+  cp.Sync(_flit_sent_time);
+  cp.Sync(_min_latency);
+  cp.Sync(_total_mapped_size);
+}
+
 BufferState::SimpleFeedbackSharedBufferPolicy::SimpleFeedbackSharedBufferPolicy(Configuration const & config, BufferState * parent, const string & name)
   : FeedbackSharedBufferPolicy(config, parent, name)
 {
@@ -536,6 +561,12 @@ void BufferState::SimpleFeedbackSharedBufferPolicy::FreeSlotFor(int vc)
   SharedBufferPolicy::FreeSlotFor(vc);
 }
 
+void BufferState::SimpleFeedbackSharedBufferPolicy::Serialize(Checkpoint & cp)
+{
+  FeedbackSharedBufferPolicy::Serialize(cp);
+  cp.Sync(_pending_credits);
+}
+
 BufferState::BufferState( const Configuration& config, Module *parent, const string& name ) : 
   Module( parent, name ), _occupancy(0)
 {
@@ -557,6 +588,8 @@ BufferState::BufferState( const Configuration& config, Module *parent, const str
   _last_id.resize(_vcs, -1);
   _last_pid.resize(_vcs, -1);
 
+  _UpdateMasks();
+
 #ifdef TRACK_BUFFERS
   _classes = config.GetInt("classes");
   _outstanding_classes.resize(_vcs);
@@ -573,10 +606,14 @@ void BufferState::ProcessCredit( Credit const * const c )
 {
   assert( c );
 
-  set<int>::iterator iter = c->vc.begin();
-  while(iter != c->vc.end()) {
+  _occupancy -= c->vc.size();
+  if(_occupancy < 0) {
+    Error("Buffer occupancy fell below zero.");
+  }
+
+  for(unsigned long long bits = c->vc.bits(); bits; bits &= bits - 1) {
 
-    int const vc = *iter;
+    int const vc = __builtin_ctzll(bits);
 
     assert( ( vc >= 0 ) && ( vc < _vcs ) );
 
@@ -586,19 +623,19 @@ void BufferState::ProcessCredit( Credit const * const c )
       err << "Received credit for idle VC " << vc;
       Error( err.str() );
     }
-    --_occupancy;
-    if(_occupancy < 0) {
-      Error("Buffer occupancy fell below zero.");
-    }
     --_vc_occupancy[vc];
     if(_vc_occupancy[vc] < 0) {
       ostringstream err;
       err << "Buffer occupancy fell below zero for VC " << vc;
       Error(err.str());
     }
-    if(_wait_for_tail_credit && !_vc_occupancy[vc] && _tail_sent[vc]) {
-      assert(_in_use_by[vc] >= 0);
-      _in_use_by[vc] = -1;
+    if(!_vc_occupancy[vc]) {
+      _empty_vcs |= 1ULL << vc;
+      if(_wait_for_tail_credit && _tail_sent[vc]) {
+	assert(_in_use_by[vc] >= 0);
+	_in_use_by[vc] = -1;
+	_available_vcs |= 1ULL << vc;
+      }
     }
 
 #ifdef TRACK_BUFFERS
@@ -611,8 +648,6 @@ void BufferState::ProcessCredit( Credit const * const c )
 #endif
 
     _buffer_policy->FreeSlotFor(vc);
-
-    ++iter;
   }
 }
 
@@ -629,6 +664,7 @@ void BufferState::SendingFlit( Flit const * const f )
   }
 
   ++_vc_occupancy[vc];
+  _empty_vcs &= ~(1ULL << vc);
   
   _buffer_policy->SendingFlit(f);
   
@@ -643,6 +679,7 @@ void BufferState::SendingFlit( Flit const * const f )
     if ( !_wait_for_tail_credit ) {
       assert(_in_use_by[vc] >= 0);
       _in_use_by[vc] = -1;
+      _available_vcs |= 1ULL << vc;
     }
   }
   _last_id[vc] = f->id;
@@ -659,10 +696,43 @@ void BufferState::TakeBuffer( int vc, int tag )
     Error( err.str() );
   }
   _in_use_by[vc] = tag;
+  _available_vcs &= ~(1ULL << vc);
   _tail_sent[vc] = false;
   _buffer_policy->TakeBuffer(vc);
 }
 
+void BufferState::Serialize( Checkpoint & cp )
+{
+  cp.Sync(_occupancy);
+  cp.Sync(_vc_occupancy);
+  _buffer_policy->Serialize(cp);
+  cp.Sync(_in_use_by);
+  cp.Sync(_tail_sent);
+  cp.Sync(_last_id);
+  cp.Sync(_last_pid);
+#ifdef TRACK_BUFFERS
+  cp.Sync(_outstanding_classes);
+  cp.Sync(_class_occupancy);
+#endif
+  if(cp.Loading()) {
+    _UpdateMasks();
+  }
+}
+
+void BufferState::_UpdateMasks( )
+{
+  _available_vcs = 0;
+  _empty_vcs = 0;
+  for(int vc = 0; vc < _vcs; ++vc) {
+    if(_in_use_by[vc] < 0) {
+      _available_vcs |= 1ULL << vc;
+    }
+    if(!_vc_occupancy[vc]) {
+      _empty_vcs |= 1ULL << vc;
+    }
+  }
+}
+
 void BufferState::Display( ostream & os ) const
 {
   os << FullName() << " :" << endl;
@@ -36,6 +36,8 @@
 #include "credit.hpp"
 #include "config_utils.hpp"
 
+class Checkpoint;
+
 class BufferState : public Module {
   
   class BufferPolicy : public Module {
@@ -52,6 +54,8 @@ class BufferState : public Module {
     virtual int AvailableFor(int vc = 0) const = 0;
     virtual int LimitFor(int vc = 0) const = 0;
 
+    virtual void Serialize(Checkpoint & cp) {}
+
     static BufferPolicy * New(Configuration const & config, 
 			      BufferState * parent, const string & name);
   };
@@ -86,6 +90,7 @@ class BufferState : public Module {
     virtual bool IsFullFor(int vc = 0) const;
     virtual int AvailableFor(int vc = 0) const;
     virtual int LimitFor(int vc = 0) const;
+    virtual void Serialize(Checkpoint & cp);
   };
 
   class LimitedSharedBufferPolicy : public SharedBufferPolicy {
@@ -102,6 +107,7 @@ class BufferState : public Module {
     virtual bool IsFullFor(int vc = 0) const;
     virtual int AvailableFor(int vc = 0) const;
     virtual int LimitFor(int vc = 0) const;
+    virtual void Serialize(Checkpoint & cp);
   };
     
   class DynamicLimitedSharedBufferPolicy : public LimitedSharedBufferPolicy {
@@ -144,6 +150,7 @@ class BufferState : public Module {
     virtual bool IsFullFor(int vc = 0) const;
     virtual int AvailableFor(int vc = 0) const;
     virtual int LimitFor(int vc = 0) const;
+    virtual void Serialize(Checkpoint & cp);
   };
   
   class SimpleFeedbackSharedBufferPolicy : public FeedbackSharedBufferPolicy {
@@ -154,6 +161,7 @@ class BufferState : public Module {
 				     BufferState * parent, const string & name);
     virtual void SendingFlit(Flit const * const f);
     virtual void FreeSlotFor(int vc = 0);
+    virtual void Serialize(Checkpoint & cp);
   };
   
   bool _wait_for_tail_credit;
@@ -166,6 +174,12 @@ class BufferState : public Module {
   
   vector<int> _in_use_by;
   vector<bool> _tail_sent;
+
+  // one bit per VC that is not in use or that holds no flits
+  unsigned long long _available_vcs;
+  unsigned long long _empty_vcs;
+
+  void _UpdateMasks( );
   vector<int> _last_id;
   vector<int> _last_pid;
 
@@ -212,6 +226,12 @@ public:
     assert( ( vc >= 0 ) && ( vc < _vcs ) );
     return _in_use_by[vc] < 0;
   }
+  inline unsigned long long AvailableVCs( ) const {
+    return _available_vcs;
+  }
+  inline unsigned long long EmptyVCs( ) const {
+    return _empty_vcs;
+  }
   inline int UsedBy(int vc = 0) const {
     assert( ( vc >= 0 ) && ( vc < _vcs ) );
     return _in_use_by[vc];
@@ -234,6 +254,8 @@ public:
 #endif
 
   void Display( ostream & os = cout ) const;
+
+  void Serialize( Checkpoint & cp );
 };
 
 #endif 
@@ -37,17 +37,19 @@
 #ifndef _CHANNEL_HPP
 #define _CHANNEL_HPP
 
-#include <queue>
 #include <cassert>
 
 #include "globals.hpp"
 #include "module.hpp"
 #include "timed_module.hpp"
+#include "timing_wheel.hpp"
+#include "ring_buffer.hpp"
+#include "checkpoint.hpp"
 
 using namespace std;
 
 template<typename T>
-class Channel : public TimedModule {
+class Channel : public TimedModule, public TimingWheel::Client {
 public:
   Channel(Module * parent, string const & name);
   virtual ~Channel() {}
@@ -62,21 +64,42 @@ public:
   // Receive data
   virtual T * Receive(); 
   
+  // Module that reads this channel's output
+  void SetReceiver(TimedModule * receiver) { _receiver = receiver; }
+
+  // Hand delivery over to a shared timing wheel; WriteOutputs() then has
+  // nothing left to do
+  void SetTimingWheel(TimingWheel * wheel) { _wheel = wheel; }
+
   virtual void ReadInputs();
   virtual void Evaluate() {}
   virtual void WriteOutputs();
 
+  virtual void Expire(int time);
+
+  virtual bool IsIdle() const {
+    return !_input && (_wheel || (!_output && _wait_queue.empty()));
+  }
+
+  virtual void Serialize(Checkpoint & cp);
+
 protected:
+  TimedModule * _receiver;
+  TimingWheel * _wheel;
   int _delay;
   T * _input;
   T * _output;
-  queue<pair<int, T *> > _wait_queue;
+  int _output_time;
+  RingBuffer<pair<int, T *> > _wait_queue;
+
+  virtual void _Deliver();
 
 };
 
 template<typename T>
 Channel<T>::Channel(Module * parent, string const & name)
-  : TimedModule(parent, name), _delay(1), _input(0), _output(0) {
+  : TimedModule(parent, name), _receiver(0), _wheel(0), _delay(1), _input(0),
+    _output(0), _output_time(-1), _wait_queue(1) {
 }
 
 template<typename T>
@@ -85,11 +108,16 @@ void Channel<T>::SetLatency(int cycles) {
     Error("Channel must have positive delay.");
   }
   _delay = cycles ;
+  // one item enters per cycle and stays for the channel delay
+  _wait_queue.Reserve(_delay);
 }
 
 template<typename T>
 void Channel<T>::Send(T * data) {
   _input = data;
+  if(data) {
+    Wakeup();
+  }
 }
 
 template<typename T>
@@ -100,13 +128,20 @@ T * Channel<T>::Receive() {
 template<typename T>
 void Channel<T>::ReadInputs() {
   if(_input) {
-    _wait_queue.push(make_pair(GetSimTime() + _delay - 1, _input));
+    int const time = GetSimTime() + _delay - 1;
+    _wait_queue.push_back(make_pair(time, _input));
     _input = 0;
+    if(_wheel) {
+      _wheel->Schedule(time, this);
+    }
   }
 }
 
 template<typename T>
 void Channel<T>::WriteOutputs() {
+  if(_wheel) {
+    return;
+  }
   _output = 0;
   if(_wait_queue.empty()) {
     return;
@@ -117,9 +152,50 @@ void Channel<T>::WriteOutputs() {
     return;
   }
   assert(GetSimTime() == time);
-  _output = item.second;
+  _Deliver();
+}
+
+template<typename T>
+void Channel<T>::Expire(int time) {
+  // an item stays on the output for exactly one cycle
+  if(_output_time != time) {
+    _output = 0;
+  }
+  if(!_wait_queue.empty() && (_wait_queue.front().first == time)) {
+    _Deliver();
+  }
+}
+
+template<typename T>
+void Channel<T>::_Deliver() {
+  _output = _wait_queue.front().second;
   assert(_output);
-  _wait_queue.pop();
+  _wait_queue.pop_front();
+  _output_time = GetSimTime();
+  if(_wheel) {
+    _wheel->Schedule(_output_time + 1, this);
+  }
+  if(_receiver) {
+    _receiver->Wakeup();
+  }
+}
+
+template<typename T>
+void Channel<T>::Serialize(Checkpoint & cp) {
+  cp.Sync(_input);
+  cp.Sync(_output);
+  cp.Sync(_output_time);
+  cp.Sync(_wait_queue);
+  if(cp.Loading() && _wheel) {
+    // the timing wheel starts out empty, so put back the clearing of the
+    // current output and every pending delivery
+    if(_output) {
+      _wheel->Schedule(_output_time + 1, this);
+    }
+    for(size_t i = 0; i < _wait_queue.size(); ++i) {
+      _wheel->Schedule(_wait_queue[i].first, this);
+    }
+  }
 }
 
 #endif
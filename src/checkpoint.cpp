@@ -0,0 +1,236 @@
+// $Id$
+
+/*
+ Copyright (c) 2007-2012, Trustees of The Leland Stanford Junior University
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ Redistributions of source code must retain the above copyright notice, this 
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice, this
+ list of conditions and the following disclaimer in the documentation and/or
+ other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE 
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*checkpoint.cpp
+ *
+ *Binary snapshot of the complete simulation state
+ *
+ */
+
+#include <iostream>
+#include <cstdlib>
+#include <cstdio>
+
+#include "booksim.hpp"
+#include "checkpoint.hpp"
+#include "flit.hpp"
+#include "credit.hpp"
+#include "packet_reply_info.hpp"
+#include "outputset.hpp"
+
+Checkpoint::Checkpoint( string const & filename, bool loading )
+  : _filename(filename), _loading(loading)
+{
+  if ( _loading ) {
+    _file = fopen( _filename.c_str( ), "rb" );
+  } else {
+    _file = fopen( ( _filename + ".tmp" ).c_str( ), "wb" );
+  }
+  if ( !_file ) {
+    cerr << "Error: Unable to open checkpoint file " << _filename << endl;
+    exit(-1);
+  }
+}
+
+Checkpoint::~Checkpoint( )
+{
+  if ( _file ) {
+    fclose( _file );
+  }
+}
+
+void Checkpoint::Commit( )
+{
+  assert( !_loading );
+  if ( ( fclose( _file ) != 0 ) ||
+       ( rename( ( _filename + ".tmp" ).c_str( ), _filename.c_str( ) ) != 0 ) ) {
+    cerr << "Error: Unable to write checkpoint file " << _filename << endl;
+    exit(-1);
+  }
+  _file = NULL;
+}
+
+void Checkpoint::_Transfer( void * data, size_t size )
+{
+  size_t const done = _loading ?
+    fread( data, size, 1, _file ) :
+    fwrite( data, size, 1, _file );
+  if ( done != 1 ) {
+    cerr << "Error: Unable to " << ( _loading ? "read" : "write" )
+	 << " checkpoint file " << _filename << endl;
+    exit(-1);
+  }
+}
+
+size_t Checkpoint::_Size( size_t size )
+{
+  unsigned long long value = size;
+  Sync( value );
+  return value;
+}
+
+void Checkpoint::Check( int value, string const & what )
+{
+  int saved = value;
+  Sync( saved );
+  if ( saved != value ) {
+    cerr << "Error: Checkpoint file " << _filename << " was saved with "
+	 << what << " = " << saved << ", not " << value << endl;
+    exit(-1);
+  }
+}
+
+void Checkpoint::Sync( vector<bool> & values )
+{
+  values.resize( _Size( values.size( ) ) );
+  for ( size_t i = 0; i < values.size( ); ++i ) {
+    bool value = values[i];
+    Sync( value );
+    values[i] = value;
+  }
+}
+
+bool Checkpoint::_SyncReference( void * & p )
+{
+  // -1 stands for NULL, a known index for an object that was transferred
+  // before, and the next free index for an object that follows
+  int index = -1;
+  bool fresh = false;
+  if ( !_loading && p ) {
+    map<void const *, int>::const_iterator match = _saved.find( p );
+    if ( match != _saved.end( ) ) {
+      index = match->second;
+    } else {
+      index = _saved.size( );
+      _saved[p] = index;
+      fresh = true;
+    }
+  }
+  Sync( index );
+  if ( _loading ) {
+    if ( index < 0 ) {
+      p = NULL;
+    } else if ( index < (int)_loaded.size( ) ) {
+      p = _loaded[index];
+    } else if ( index == (int)_loaded.size( ) ) {
+      fresh = true;
+    } else {
+      cerr << "Error: Checkpoint file " << _filename << " is corrupt" << endl;
+      exit(-1);
+    }
+  }
+  return fresh;
+}
+
+void Checkpoint::Sync( Flit * & f )
+{
+  void * p = f;
+  if ( !_SyncReference( p ) ) {
+    f = (Flit *)p;
+    return;
+  }
+  if ( _loading ) {
+    f = Flit::New( );
+    _loaded.push_back( f );
+  } else if ( f->data ) {
+    cerr << "Error: Flits carrying data cannot be checkpointed" << endl;
+    exit(-1);
+  }
+  Sync( f->type );
+  Sync( f->vc );
+  Sync( f->cl );
+  Sync( f->head );
+  Sync( f->tail );
+  Sync( f->ctime );
+  Sync( f->itime );
+  Sync( f->atime );
+  Sync( f->id );
+  Sync( f->pid );
+  Sync( f->record );
+  Sync( f->src );
+  Sync( f->dest );
+  Sync( f->pri );
+  Sync( f->hops );
+  Sync( f->watch );
+  Sync( f->subnetwork );
+  Sync( f->slot );
+  Sync( f->packet_slot );
+  Sync( f->intm );
+  Sync( f->ph );
+  Sync( f->draws );
+  Sync( f->la_route_set );
+}
+
+void Checkpoint::Sync( Credit * & c )
+{
+  void * p = c;
+  if ( !_SyncReference( p ) ) {
+    c = (Credit *)p;
+    return;
+  }
+  if ( _loading ) {
+    c = Credit::New( );
+    _loaded.push_back( c );
+  }
+  Sync( c->vc );
+  Sync( c->head );
+  Sync( c->tail );
+  Sync( c->id );
+}
+
+void Checkpoint::Sync( PacketReplyInfo * & r )
+{
+  void * p = r;
+  if ( !_SyncReference( p ) ) {
+    r = (PacketReplyInfo *)p;
+    return;
+  }
+  if ( _loading ) {
+    r = PacketReplyInfo::New( );
+    _loaded.push_back( r );
+  }
+  Sync( r->source );
+  Sync( r->time );
+  Sync( r->record );
+  Sync( r->type );
+}
+
+void Checkpoint::Sync( OutputSet & output_set )
+{
+  // elements are rebuilt through the public interface, which keeps the
+  // set's ordering (and collapsing) rules in one place
+  vector<OutputSet::sSetElement> elements( output_set.begin( ),
+					   output_set.end( ) );
+  Sync( elements );
+  if ( _loading ) {
+    output_set.Clear( );
+    for ( size_t i = 0; i < elements.size( ); ++i ) {
+      output_set.AddRange( elements[i].output_port, elements[i].vc_start,
+			   elements[i].vc_end, elements[i].pri );
+    }
+  }
+}
@@ -0,0 +1,191 @@
+// $Id$
+
+/*
+ Copyright (c) 2007-2012, Trustees of The Leland Stanford Junior University
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ Redistributions of source code must retain the above copyright notice, this 
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice, this
+ list of conditions and the following disclaimer in the documentation and/or
+ other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE 
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*checkpoint.hpp
+ *
+ *Binary snapshot of the complete simulation state. The same Sync() calls
+ *write a value when a checkpoint is saved and overwrite it when one is
+ *loaded, so every class describes its state once (in its Serialize()
+ *method) for both directions.
+ *
+ *Flits, credits and reply records are written in full the first time a
+ *pointer to them is seen and by index afterwards, so objects that are
+ *referenced from several places are restored as a single object.
+ *
+ *Checkpoints are only meant to be read back by the same binary with the
+ *same configuration.
+ *
+ */
+
+#ifndef _CHECKPOINT_HPP_
+#define _CHECKPOINT_HPP_
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <deque>
+#include <list>
+#include <queue>
+#include <map>
+#include <set>
+
+#include "ring_buffer.hpp"
+
+using namespace std;
+
+class Flit;
+class Credit;
+class PacketReplyInfo;
+class OutputSet;
+
+class Checkpoint {
+
+public:
+
+  // open a checkpoint for saving (written to a temporary file and moved to
+  // the given name by Commit()) or loading
+  Checkpoint( string const & filename, bool loading );
+  ~Checkpoint( );
+
+  inline bool Loading( ) const {
+    return _loading;
+  }
+
+  // move a completely written checkpoint into place
+  void Commit( );
+
+  // save a value that is determined by the configuration, or verify that it
+  // matches when loading
+  void Check( int value, string const & what );
+
+  // plain values
+  template<class T> void Sync( T & value ) {
+    _Transfer( &value, sizeof(T) );
+  }
+
+  // containers
+  template<class A, class B> void Sync( pair<A, B> & value ) {
+    Sync( value.first );
+    Sync( value.second );
+  }
+  template<class T> void Sync( vector<T> & values ) {
+    values.resize( _Size( values.size( ) ) );
+    for ( size_t i = 0; i < values.size( ); ++i ) {
+      Sync( values[i] );
+    }
+  }
+  void Sync( vector<bool> & values );
+  template<class T> void Sync( deque<T> & values ) {
+    values.resize( _Size( values.size( ) ) );
+    for ( size_t i = 0; i < values.size( ); ++i ) {
+      Sync( values[i] );
+    }
+  }
+  template<class T> void Sync( list<T> & values ) {
+    values.resize( _Size( values.size( ) ) );
+    for ( typename list<T>::iterator iter = values.begin( );
+	  iter != values.end( );
+	  ++iter ) {
+      Sync( *iter );
+    }
+  }
+  template<class T> void Sync( queue<T> & values ) {
+    deque<T> items;
+    if ( !_loading ) {
+      queue<T> copy = values;
+      while ( !copy.empty( ) ) {
+	items.push_back( copy.front( ) );
+	copy.pop( );
+      }
+    }
+    Sync( items );
+    if ( _loading ) {
+      values = queue<T>( items );
+    }
+  }
+  template<class T> void Sync( RingBuffer<T> & values ) {
+    size_t const size = _Size( values.size( ) );
+    if ( _loading ) {
+      values.clear( );
+      for ( size_t i = 0; i < size; ++i ) {
+	values.push_back( T( ) );
+      }
+    }
+    for ( size_t i = 0; i < size; ++i ) {
+      Sync( values[i] );
+    }
+  }
+  template<class K, class V> void Sync( map<K, V> & values ) {
+    vector<pair<K, V> > items( values.begin( ), values.end( ) );
+    Sync( items );
+    if ( _loading ) {
+      values.clear( );
+      values.insert( items.begin( ), items.end( ) );
+    }
+  }
+  template<class K> void Sync( set<K> & values ) {
+    vector<K> items( values.begin( ), values.end( ) );
+    Sync( items );
+    if ( _loading ) {
+      values.clear( );
+      values.insert( items.begin( ), items.end( ) );
+    }
+  }
+
+  // objects owned by the flit, credit and reply pools
+  void Sync( Flit * & f );
+  void Sync( Credit * & c );
+  void Sync( PacketReplyInfo * & p );
+
+  void Sync( OutputSet & output_set );
+
+private:
+
+  string _filename;
+  bool _loading;
+  FILE * _file;
+
+  // pooled objects seen so far, in order of appearance
+  map<void const *, int> _saved;
+  vector<void *> _loaded;
+
+  void _Transfer( void * data, size_t size );
+  size_t _Size( size_t size );
+
+  // returns true if the object behind the pointer still needs to be
+  // transferred
+  bool _SyncReference( void * & p );
+
+  // any other pointer cannot be stored in a checkpoint
+  template<class T> void Sync( T * & p );
+
+  Checkpoint( Checkpoint const & );
+  Checkpoint & operator=( Checkpoint const & );
+
+};
+
+#endif
@@ -30,12 +30,18 @@
  *A class for credits
  */
 
+#include <pthread.h>
+
 #include "booksim.hpp"
 #include "credit.hpp"
 
 stack<Credit *> Credit::_all;
 stack<Credit *> Credit::_free;
 
+// routers allocate and release credits during evaluation, which may run on
+// several threads at once (see network_threads)
+static pthread_mutex_t _pool_lock = PTHREAD_MUTEX_INITIALIZER;
+
 Credit::Credit()
 {
   Reset();
@@ -51,6 +57,7 @@ void Credit::Reset()
 
 Credit * Credit::New() {
   Credit * c;
+  pthread_mutex_lock(&_pool_lock);
   if(_free.empty()) {
     c = new Credit();
     _all.push(c);
@@ -59,11 +66,14 @@ Credit * Credit::New() {
     c->Reset();
     _free.pop();
   }
+  pthread_mutex_unlock(&_pool_lock);
   return c;
 }
 
 void Credit::Free() {
+  pthread_mutex_lock(&_pool_lock);
   _free.push(this);
+  pthread_mutex_unlock(&_pool_lock);
 }
 
 void Credit::FreeAll() {
@@ -28,14 +28,44 @@
 #ifndef _CREDIT_HPP_
 #define _CREDIT_HPP_
 
-#include <set>
+#include <cassert>
 #include <stack>
 
+// set of virtual channels, stored as a bitmask
+class VCMask {
+
+  unsigned long long _bits;
+
+public:
+
+  static const int MAX_VCS = 64;
+
+  VCMask( ) : _bits(0) {}
+
+  inline void clear( ) { _bits = 0; }
+  inline void insert( int vc ) {
+    assert( ( vc >= 0 ) && ( vc < MAX_VCS ) );
+    _bits |= 1ULL << vc;
+  }
+  inline bool empty( ) const { return !_bits; }
+  inline int size( ) const { return __builtin_popcountll( _bits ); }
+
+  // lowest VC in the set; the set must not be empty
+  inline int first( ) const {
+    assert( _bits );
+    return __builtin_ctzll( _bits );
+  }
+
+  // for iterating over the set: clear the lowest bit after visiting it
+  inline unsigned long long bits( ) const { return _bits; }
+
+};
+
 class Credit {
 
 public:
 
-  set<int> vc;
+  VCMask vc;
 
   // these are only used by the event router
   bool head, tail;
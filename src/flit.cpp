@@ -37,8 +37,8 @@
 #include "booksim.hpp"
 #include "flit.hpp"
 
-stack<Flit *> Flit::_all;
-stack<Flit *> Flit::_free;
+vector<Flit *> Flit::_blocks;
+vector<Flit::Handle> Flit::_free;
 
 ostream& operator<<( ostream& os, const Flit& f )
 {
@@ -79,29 +79,37 @@ void Flit::Reset()
   pri = 0;
   intm =-1;
   ph = -1;
+  draws = 0;
+  slot = -1;
+  packet_slot = -1;
   data = 0;
 }  
 
 Flit * Flit::New() {
-  Flit * f;
   if(_free.empty()) {
-    f = new Flit;
-    _all.push(f);
-  } else {
-    f = _free.top();
-    f->Reset();
-    _free.pop();
+    Handle const base = _blocks.size() << _block_bits;
+    Flit * const block = new Flit[_block_size];
+    _blocks.push_back(block);
+    // hand out the new block in ascending order
+    for(int i = _block_size - 1; i >= 0; --i) {
+      block[i]._handle = base + i;
+      _free.push_back(base + i);
+    }
   }
+  Flit * f = Lookup(_free.back());
+  _free.pop_back();
+  f->Reset();
   return f;
 }
 
 void Flit::Free() {
-  _free.push(this);
+  _free.push_back(_handle);
 }
 
 void Flit::FreeAll() {
-  while(!_all.empty()) {
-    delete _all.top();
-    _all.pop();
+  for(size_t i = 0; i < _blocks.size(); ++i) {
+    delete [] _blocks[i];
   }
+  _blocks.clear();
+  _free.clear();
 }
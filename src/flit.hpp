@@ -29,10 +29,11 @@
 #define _FLIT_HPP_
 
 #include <iostream>
-#include <stack>
+#include <vector>
 
 #include "booksim.hpp"
 #include "outputset.hpp"
+#include "random_utils.hpp"
 
 class Flit {
 
@@ -44,39 +45,58 @@ public:
 		  WRITE_REQUEST = 2,
 		  WRITE_REPLY   = 3,
                   ANY_TYPE      = 4 };
-  FlitType type;
+
+  // compact reference to a flit, valid until the flit is freed
+  typedef unsigned int Handle;
+
+  // Fields read by every router pipeline stage come first, so they share
+  // the flit's first cache line
 
   int vc;
 
   int cl;
 
+  int  dest;
+
+  int  pri;
+
   bool head;
   bool tail;
-  
-  int  ctime;
-  int  itime;
-  int  atime;
+
+  FlitType type;
 
   int  id;
   int  pid;
 
-  bool record;
-
   int  src;
-  int  dest;
-
-  int  pri;
-
-  int  hops;
-  bool watch;
   int  subnetwork;
-  
+
   // intermediate destination (if any)
   mutable int intm;
 
   // phase in multi-phase algorithms
   mutable int ph;
 
+  // number of random numbers drawn for routing decisions
+  mutable int draws;
+
+  int  hops;
+
+  // Statistics and debugging fields
+
+  bool record;
+  bool watch;
+  
+  int  ctime;
+  int  itime;
+  int  atime;
+
+  // position in the traffic manager's table of flits in flight
+  int  slot;
+  // handle of the packet in the traffic manager's table of partially
+  // retired packets (multi-flit packets only)
+  int  packet_slot;
+
   // Fields for arbitrary data
   void* data ;
 
@@ -85,6 +105,19 @@ public:
 
   void Reset();
 
+  // Returns a random integer in the range [0,max] for a routing decision;
+  // each flit draws from a stream of its own, so routing does not depend on
+  // the order in which routers are evaluated
+  inline int RandomInt( int max ) const {
+    return (int)( RandomBits( random_routing, id, 0, draws++ ) % 
+		  (unsigned long long)( max + 1 ) );
+  }
+
+  inline Handle GetHandle() const { return _handle; }
+  static inline Flit * Lookup( Handle handle ) {
+    return &_blocks[handle >> _block_bits][handle & (_block_size - 1)];
+  }
+
   static Flit * New();
   void Free();
   static void FreeAll();
@@ -94,8 +127,14 @@ private:
   Flit();
   ~Flit() {}
 
-  static stack<Flit *> _all;
-  static stack<Flit *> _free;
+  Handle _handle;
+
+  // flits are allocated in blocks of consecutive handles
+  static const int _block_bits = 10;
+  static const int _block_size = 1 << _block_bits;
+
+  static vector<Flit *> _blocks;
+  static vector<Handle> _free;
 
 };
 
@@ -81,11 +81,17 @@ void FlitChannel::ReadInputs() {
   Channel<Flit>::ReadInputs();
 }
 
-void FlitChannel::WriteOutputs() {
-  Channel<Flit>::WriteOutputs();
-  if(_output && _output->watch) {
+void FlitChannel::_Deliver() {
+  Channel<Flit>::_Deliver();
+  if(_output->watch) {
     *gWatchOut << GetSimTime() << " | " << FullName() << " | "
 	       << "Completed channel traversal for flit " << _output->id
 	       << "." << endl;
   }
 }
+
+void FlitChannel::Serialize(Checkpoint & cp) {
+  Channel<Flit>::Serialize(cp);
+  cp.Sync(_active);
+  cp.Sync(_idle);
+}
@@ -76,7 +76,12 @@ public:
   virtual void Send(Flit * flit);
 
   virtual void ReadInputs();
-  virtual void WriteOutputs();
+
+  virtual void Serialize(Checkpoint & cp);
+
+protected:
+
+  virtual void _Deliver();
 
 private:
   
@@ -0,0 +1,178 @@
+// $Id$
+
+/*
+ Copyright (c) 2007-2012, Trustees of The Leland Stanford Junior University
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ Redistributions of source code must retain the above copyright notice, this 
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice, this
+ list of conditions and the following disclaimer in the documentation and/or
+ other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE 
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <cstdlib>
+#include <cassert>
+
+#include "flow_table.hpp"
+#include "random_utils.hpp"
+#include "checkpoint.hpp"
+
+FlowTable::FlowTable( string const & filename, int nodes, int classes )
+  : _nodes(nodes), _classes(classes)
+{
+  ifstream in(filename.c_str());
+  if(!in) {
+    cout << "Error: Unable to open flow file: " << filename << endl;
+    exit(-1);
+  }
+
+  string line;
+  int line_num = 0;
+  while(getline(in, line)) {
+    ++line_num;
+    size_t const comment = line.find("//");
+    if(comment != string::npos) {
+      line.erase(comment);
+    }
+    istringstream fields(line);
+    sFlow f;
+    if(!(fields >> f.source)) {
+      continue;
+    }
+    if(!(fields >> f.dest >> f.cl >> f.period)) {
+      cout << "Error: Missing fields in line " << line_num
+	   << " of flow file: " << filename << endl;
+      exit(-1);
+    }
+    int value;
+    f.phase = (fields >> value) ? value : 0;
+    f.size = (fields >> value) ? value : -1;
+    f.jitter = (fields >> value) ? value : 0;
+    if((f.source < 0) || (f.source >= nodes) || 
+       (f.dest < 0) || (f.dest >= nodes) ||
+       (f.cl < 0) || (f.cl >= classes) ||
+       (f.period < 1) || (f.phase < 0) ||
+       ((f.size < 1) && (f.size != -1)) ||
+       (f.jitter < 0) || (f.jitter >= f.period)) {
+      cout << "Error: Invalid flow in line " << line_num
+	   << " of flow file: " << filename << endl;
+      exit(-1);
+    }
+    _flows.push_back(f);
+  }
+
+  if(_flows.empty()) {
+    cout << "Error: No flows in flow file: " << filename << endl;
+    exit(-1);
+  }
+
+  _active.resize(_nodes * _classes, false);
+  for(size_t i = 0; i < _flows.size(); ++i) {
+    _active[_flows[i].source * _classes + _flows[i].cl] = true;
+  }
+
+  _base.resize(_flows.size());
+  _release.resize(_flows.size());
+  for(size_t i = 0; i < _flows.size(); ++i) {
+    _random.push_back(RandomStream(random_flow, (int)i));
+  }
+}
+
+void FlowTable::_Schedule( int flow )
+{
+  int const jitter = _flows[flow].jitter;
+  _release[flow] = _base[flow] + ((jitter > 0) ? _random[flow].Int(jitter) : 0);
+}
+
+void FlowTable::Reset( )
+{
+  _pending.clear();
+  _ready.clear();
+  for(size_t flow = 0; flow < _flows.size(); ++flow) {
+    _base[flow] = _flows[flow].phase;
+    _Schedule(flow);
+    _pending.push_back(make_pair(_release[flow], (int)flow));
+  }
+  make_heap(_pending.begin(), _pending.end(), greater<pair<int, int> >());
+}
+
+void FlowTable::Release( int time )
+{
+  while(!_pending.empty() && (_pending.front().first <= time)) {
+    int const flow = _pending.front().second;
+    pop_heap(_pending.begin(), _pending.end(), greater<pair<int, int> >());
+    _pending.pop_back();
+    _ready[_flows[flow].source * _classes + _flows[flow].cl].push_back(flow);
+  }
+}
+
+int FlowTable::NextReady( int queue ) const
+{
+  map<int, vector<int> >::const_iterator iter = _ready.upper_bound(queue);
+  return (iter == _ready.end()) ? -1 : iter->first;
+}
+
+int FlowTable::NextRelease( ) const
+{
+  return _pending.empty() ? numeric_limits<int>::max() : _pending.front().first;
+}
+
+int FlowTable::Pop( int queue, int time, int * release )
+{
+  map<int, vector<int> >::iterator iter = _ready.find(queue);
+  assert(iter != _ready.end());
+  vector<int> & flows = iter->second;
+
+  // earliest release first, ties in file order
+  size_t first = 0;
+  for(size_t i = 1; i < flows.size(); ++i) {
+    if(make_pair(_release[flows[i]], flows[i]) < 
+       make_pair(_release[flows[first]], flows[first])) {
+      first = i;
+    }
+  }
+  int const flow = flows[first];
+  *release = _release[flow];
+
+  _base[flow] += _flows[flow].period;
+  _Schedule(flow);
+  if(_release[flow] > time) {
+    flows.erase(flows.begin() + first);
+    if(flows.empty()) {
+      _ready.erase(iter);
+    }
+    _pending.push_back(make_pair(_release[flow], flow));
+    push_heap(_pending.begin(), _pending.end(), greater<pair<int, int> >());
+  }
+  return flow;
+}
+
+void FlowTable::Serialize( Checkpoint & cp )
+{
+  cp.Check((int)_flows.size(), "number of flows");
+  cp.Sync(_base);
+  cp.Sync(_release);
+  cp.Sync(_random);
+  cp.Sync(_pending);
+  cp.Sync(_ready);
+}
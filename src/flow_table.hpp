@@ -0,0 +1,134 @@
+// $Id$
+
+/*
+ Copyright (c) 2007-2012, Trustees of The Leland Stanford Junior University
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ Redistributions of source code must retain the above copyright notice, this 
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice, this
+ list of conditions and the following disclaimer in the documentation and/or
+ other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE 
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+/*flow_table.hpp
+ *
+ *Periodic flows read from a file, one flow per line:
+ *
+ *  source dest class period [phase [size [jitter]]]
+ *
+ *The k-th packet of a flow is released at phase + k * period plus a
+ *uniformly drawn delay of at most jitter cycles. A size of -1 uses the
+ *packet size of the class. Text after "//" is ignored.
+ *
+ *Each flow's next release time is computed when its previous packet is
+ *generated, so the cost per cycle is proportional to the packets due
+ *rather than to the number of (source, class) pairs.
+ *
+ */
+
+#ifndef _FLOW_TABLE_HPP_
+#define _FLOW_TABLE_HPP_
+
+#include <string>
+#include <vector>
+#include <map>
+
+#include "random_utils.hpp"
+
+using namespace std;
+
+class Checkpoint;
+
+class FlowTable {
+
+public:
+
+  struct sFlow {
+    int source;
+    int dest;
+    int cl;
+    int period;
+    int phase;
+    int size;
+    int jitter;
+  };
+
+  FlowTable( string const & filename, int nodes, int classes );
+
+  // schedule the first packet of every flow
+  void Reset( );
+
+  // make every packet released at or before time due at its source
+  void Release( int time );
+
+  // the first (source, class) queue after the given one that has a packet
+  // due, or -1; queues are numbered source * classes + class
+  int NextReady( int queue ) const;
+
+  // whether any flow injects into the given queue
+  inline bool Active( int queue ) const {
+    return _active[queue];
+  }
+
+  inline bool Ready( int queue ) const {
+    return _ready.count( queue ) > 0;
+  }
+  inline bool HasReady( ) const {
+    return !_ready.empty( );
+  }
+
+  // release time of the earliest packet that is not due yet
+  int NextRelease( ) const;
+
+  // take the earliest due packet of the given queue and schedule the next
+  // packet of its flow; returns the flow and stores the release time
+  int Pop( int queue, int time, int * release );
+
+  inline sFlow const & GetFlow( int flow ) const {
+    return _flows[flow];
+  }
+
+  void Serialize( Checkpoint & cp );
+
+private:
+
+  int _nodes;
+  int _classes;
+
+  vector<sFlow> _flows;
+
+  // queues that at least one flow injects into
+  vector<bool> _active;
+
+  // period-aligned and actual release time of each flow's next packet
+  vector<int> _base;
+  vector<int> _release;
+
+  // random number stream for the jitter of each flow
+  vector<RandomStream> _random;
+
+  // min-heap of (release, flow) for packets that are not due yet
+  vector<pair<int, int> > _pending;
+
+  // flows with a packet due, by queue
+  map<int, vector<int> > _ready;
+
+  void _Schedule( int flow );
+
+};
+
+#endif
@@ -33,11 +33,6 @@
 
 /*all declared in main.cpp*/
 
-int GetSimTime();
-
-class Stats;
-Stats * GetStats(const std::string & name);
-
 extern bool gPrintActivity;
 
 extern int gK;
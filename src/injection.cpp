@@ -29,12 +29,15 @@
 #include <vector>
 #include <cassert>
 #include <limits>
+#include <cmath>
+#include <algorithm>
 #include "random_utils.hpp"
 #include "injection.hpp"
+#include "checkpoint.hpp"
 
 using namespace std;
 
-InjectionProcess::InjectionProcess(int nodes, double rate)
+InjectionProcess::InjectionProcess(int nodes, double rate, int cl)
   : _nodes(nodes), _rate(rate)
 {
   if(nodes <= 0) {
@@ -46,6 +49,9 @@ InjectionProcess::InjectionProcess(int nodes, double rate)
 	 << endl;
     exit(-1);
   }
+  for(int n = 0; n < nodes; ++n) {
+    _random.push_back(RandomStream(random_injection, n, cl));
+  }
 }
 
 void InjectionProcess::reset()
@@ -53,9 +59,41 @@ void InjectionProcess::reset()
 
 }
 
+bool InjectionProcess::active(int source) const
+{
+  return (_rate > 0.0);
+}
+
+int InjectionProcess::quiet(int source, int cl) const
+{
+  return -1;
+}
+
+void InjectionProcess::skip(int source, int cl, int calls)
+{
+  assert(calls == 0);
+}
+
+void InjectionProcess::set_rate(double rate)
+{
+  if((rate < 0.0) || (rate > 1.0)) {
+    cout << "Error: Injection process must have load between 0.0 and 1.0."
+	 << endl;
+    exit(-1);
+  }
+  _rate = rate;
+}
+
+void InjectionProcess::serialize(Checkpoint & cp)
+{
+  cp.Sync(_rate);
+  cp.Sync(_random);
+}
+
 InjectionProcess * InjectionProcess::New(string const & inject, int nodes, 
 					 double load, 
-					 Configuration const * const config)
+					 Configuration const * const config,
+					 int cl)
 {
   string process_name;
   string param_str;
@@ -75,7 +113,7 @@ InjectionProcess * InjectionProcess::New(string const & inject, int nodes,
 
   InjectionProcess * result = NULL;
   if(process_name == "bernoulli") {
-    result = new BernoulliInjectionProcess(nodes, load);
+    result = new BernoulliInjectionProcess(nodes, load, cl);
   } else if(process_name == "on_off") {
     bool missing_params = false;
     double alpha = numeric_limits<double>::quiet_NaN();
@@ -124,9 +162,8 @@ InjectionProcess * InjectionProcess::New(string const & inject, int nodes,
 	initial[n] = RandomInt(1);
       }
     }
-    result = new OnOffInjectionProcess(nodes, load, alpha, beta, r1, initial);
-  } else if(process_name == "customizedinjectionprocess") {
-    result=new CustomizedInjectionProcess(nodes,load);
+    result = new OnOffInjectionProcess(nodes, load, alpha, beta, r1, initial, 
+				       cl);
   } else {
     cout << "Invalid injection process: " << inject << endl;
     exit(-1);
@@ -134,26 +171,88 @@ InjectionProcess * InjectionProcess::New(string const & inject, int nodes,
   return result;
 }
 
+// Number of failures before the first success in a sequence of Bernoulli 
+// trials with success probability p, drawn by inverting the geometric 
+// distribution. Gaps that do not fit an int (including p = 0) are clamped; 
+// they exceed any simulation length.
+static int GeometricGap(double p, RandomStream & random)
+{
+  if(p >= 1.0) {
+    return 0;
+  }
+  if(p <= 0.0) {
+    return numeric_limits<int>::max();
+  }
+  double const gap = floor(log(1.0 - random.Float()) / log(1.0 - p));
+  return (gap < (double)numeric_limits<int>::max()) ? 
+    (int)gap : numeric_limits<int>::max();
+}
+
 //=============================================================
 
-BernoulliInjectionProcess::BernoulliInjectionProcess(int nodes, double rate)
-  : InjectionProcess(nodes, rate)
+// Rather than drawing a random number per call to test(), each source 
+// samples the number of failing calls before its next injection; the gaps 
+// are geometrically distributed, so the injections follow the same 
+// Bernoulli process.
+BernoulliInjectionProcess::BernoulliInjectionProcess(int nodes, double rate, 
+						     int cl)
+  : InjectionProcess(nodes, rate, cl)
 {
+  reset();
+}
 
+void BernoulliInjectionProcess::reset()
+{
+  _gap.resize(_nodes);
+  for(int n = 0; n < _nodes; ++n) {
+    _gap[n] = GeometricGap(_rate, _random[n]);
+  }
 }
 
 bool BernoulliInjectionProcess::test(int source,int cl)
 {
   assert((source >= 0) && (source < _nodes));
-  return (RandomFloat() < _rate);
+  if(_gap[source] > 0) {
+    --_gap[source];
+    return false;
+  }
+  _gap[source] = GeometricGap(_rate, _random[source]);
+  return true;
+}
+
+int BernoulliInjectionProcess::quiet(int source,int cl) const
+{
+  assert((source >= 0) && (source < _nodes));
+  return _gap[source];
+}
+
+void BernoulliInjectionProcess::skip(int source,int cl,int calls)
+{
+  assert((source >= 0) && (source < _nodes));
+  assert((calls >= 0) && (calls <= _gap[source]));
+  _gap[source] -= calls;
+}
+
+void BernoulliInjectionProcess::set_rate(double rate)
+{
+  InjectionProcess::set_rate(rate);
+  // the gaps are memoryless, so they can simply be redrawn at the new rate
+  reset();
+}
+
+void BernoulliInjectionProcess::serialize(Checkpoint & cp)
+{
+  InjectionProcess::serialize(cp);
+  cp.Sync(_gap);
 }
 
 //=============================================================
 
 OnOffInjectionProcess::OnOffInjectionProcess(int nodes, double rate, 
 					     double alpha, double beta, 
-					     double r1, vector<int> initial)
-  : InjectionProcess(nodes, rate), 
+					     double r1, vector<int> initial,
+					     int cl)
+  : InjectionProcess(nodes, rate, cl), 
     _alpha(alpha), _beta(beta), _r1(r1), _initial(initial)
 {
   assert(alpha <= 1.0);
@@ -162,21 +261,51 @@ OnOffInjectionProcess::OnOffInjectionProcess(int nodes, double rate,
   if(alpha < 0.0) {
     assert(beta >= 0.0);
     assert(r1 >= 0.0);
-    _alpha = beta * rate / (r1 - rate);
+    _derived = derived_alpha;
   } else if(beta < 0.0) {
     assert(alpha >= 0.0);
     assert(r1 >= 0.0);
-    _beta = alpha * (r1 - rate) / rate;
+    _derived = derived_beta;
   } else {
     assert(r1 < 0.0);
-    _r1 = rate * (alpha + beta) / alpha;
+    _derived = derived_r1;
   }
+  _Derive();
   reset();
 }
 
+void OnOffInjectionProcess::_Derive()
+{
+  switch(_derived) {
+  case derived_alpha:
+    _alpha = _beta * _rate / (_r1 - _rate);
+    break;
+  case derived_beta:
+    _beta = _alpha * (_r1 - _rate) / _rate;
+    break;
+  case derived_r1:
+    _r1 = _rate * (_alpha + _beta) / _alpha;
+    break;
+  }
+}
+
+// Like the Bernoulli process, each source samples how long it stays in its 
+// current state (geometric with parameter beta when on and alpha when off) 
+// and, while on, the gap to its next injection (geometric with parameter r1).
+void OnOffInjectionProcess::_Sample()
+{
+  _dwell.resize(_nodes);
+  _gap.resize(_nodes);
+  for(int n = 0; n < _nodes; ++n) {
+    _dwell[n] = GeometricGap(_state[n] ? _beta : _alpha, _random[n]);
+    _gap[n] = GeometricGap(_r1, _random[n]);
+  }
+}
+
 void OnOffInjectionProcess::reset()
 {
   _state = _initial;
+  _Sample();
 }
 
 bool OnOffInjectionProcess::test(int source,int cl)
@@ -184,234 +313,66 @@ bool OnOffInjectionProcess::test(int source,int cl)
   assert((source >= 0) && (source < _nodes));
 
   // advance state
-  _state[source] = 
-    _state[source] ? (RandomFloat() >= _beta) : (RandomFloat() < _alpha);
+  if(_dwell[source] > 0) {
+    --_dwell[source];
+  } else {
+    _state[source] = !_state[source];
+    _dwell[source] = GeometricGap(_state[source] ? _beta : _alpha, 
+				  _random[source]);
+  }
 
   // generate packet
-  return _state[source] && (RandomFloat() < _r1);
+  if(!_state[source]) {
+    return false;
+  }
+  if(_gap[source] > 0) {
+    --_gap[source];
+    return false;
+  }
+  _gap[source] = GeometricGap(_r1, _random[source]);
+  return true;
 }
 
-CustomizedInjectionProcess::CustomizedInjectionProcess(int nodes,double load): InjectionProcess(nodes,load){
-    assert((load>0)&&(load<1));
-    for (int i=0;i<26;i++)
-        counter[i]=0;
-    _nodes=nodes;
-};
+int OnOffInjectionProcess::quiet(int source,int cl) const
+{
+  assert((source >= 0) && (source < _nodes));
+  // only count calls that do not change the state
+  return _state[source] ? min(_dwell[source], _gap[source]) : _dwell[source];
+}
 
-void CustomizedInjectionProcess::reset()
+void OnOffInjectionProcess::skip(int source,int cl,int calls)
 {
-    for (int i=0;i<26;i++)
-        counter[i]=0;
+  assert((source >= 0) && (source < _nodes));
+  assert((calls >= 0) && (calls <= quiet(source, cl)));
+  _dwell[source] -= calls;
+  if(_state[source]) {
+    _gap[source] -= calls;
+  }
 }
 
-bool CustomizedInjectionProcess::test(int source,int cl){
-    if ((source==1)&&(cl==0)){
-        counter[0]++;
-        if(counter[0]%500==1){
-            return true;
-        }else{
-            return false;
-        }
-    }
-    if ((source==2)&&(cl==1)){
-        counter[1]++;
-        if(counter[1]%500==1){
-            return true;
-        }else{
-            return false;
-        }
-    }
-    if ((source==3)&&(cl==2)){
-        counter[2]++;
-        if (counter[2]%500==1){
-            return true;
-        }else{
-            return false;
-        }
-    }
-    if ((source==3)&&(cl==3)){
-        counter[3]++;
-        if (counter[3]%500==1){
-            return true;
-        }else{
-            return false;
-        }
-    }
-    if ((source==3)&&(cl==4)){
-        counter[4]++;
-        if(counter[4]%256==1){
-            return true;
-        }else{
-            return false;
-        }
-    }
-    if ((source==4)&&(cl==5)){
-        counter[5]++;
-        if(counter[5]%16==1){
-            return true;
-        }else{
-            return false;
-        }
-    }
-    if ((source==4)&&(cl==6)){
-        counter[6]++;
-        if (counter[6]%16==1){
-            return true;
-        }else{
-            return false;
-        }
-    }
-    if ((source==4)&&(cl==7)){
-        counter[7]++;
-        if (counter[7]%16==1){
-            return true;
-        }else{
-            return false;
-        }
-    }
-    if ((source==4)&&(cl==8)){
-        counter[8]++;
-        if(counter[8]%16==1){
-            return true;
-        }else{
-            return false;
-        }
-    }
-    if ((source==4)&&(cl==9)){
-        counter[9]++;
-        if(counter[9]%16==1){
-            return true;
-        }else{
-            return false;
-        }
-    }
-    if ((source==4)&&(cl==10)){
-        counter[10]++;
-        if (counter[10]%16==1){
-            return true;
-        }else{
-            return false;
-        }
-    }
-    if ((source==5)&&(cl==11)){
-        counter[11]++;
-        if (counter[11]%125==1){
-            return true;
-        }else{
-            return false;
-        }
-    }
-    if ((source==6)&&(cl==12)){
-        counter[12]++;
-        if(counter[12]%125==1){
-            return true;
-        }else{
-            return false;
-        }
-    }
-    if ((source==6)&&(cl==13)){
-        counter[13]++;
-        if(counter[13]%125==1){
-            return true;
-        }else{
-            return false;
-        }
-    }
-    if ((source==8)&&(cl==14)){
-        counter[14]++;
-        if (counter[14]%125==1){
-            return true;
-        }else{
-            return false;
-        }
-    }
-    if ((source==9)&&(cl==15)){
-        counter[15]++;
-        if (counter[15]%125==1){
-            return true;
-        }else{
-            return false;
-        }
-    }
-    if ((source==10)&&(cl==16)){
-        counter[16]++;
-        if(counter[16]%125==1){
-            return true;
-        }else{
-            return false;
-        }
-    }
-    if ((source==11)&&(cl==17)){
-        counter[17]++;
-        if(counter[17]%125==1){
-            return true;
-        }else{
-            return false;
-        }
-    }
-    if ((source==11)&&(cl==18)){
-        counter[18]++;
-        if (counter[18]%32==1){
-            return true;
-        }else{
-            return false;
-        }
-    }
-    if ((source==12)&&(cl==19)){
-        counter[19]++;
-        if (counter[19]%125==1){
-            return true;
-        }else{
-            return false;
-        }
-    }
-    if ((source==12)&&(cl==20)){
-        counter[20]++;
-        if(counter[20]%125==1){
-            return true;
-        }else{
-            return false;
-        }
-    }
-    if ((source==13)&&(cl==21)){
-        counter[21]++;
-        if(counter[21]%125==1){
-            return true;
-        }else{
-            return false;
-        }
-    }
-    if ((source==13)&&(cl==22)){
-        counter[22]++;
-        if (counter[22]%125==1){
-            return true;
-        }else{
-            return false;
-        }
-    }
-    if ((source==14)&&(cl==23)){
-        counter[23]++;
-        if (counter[23]%125==1){
-            return true;
-        }else{
-            return false;
-        }
-    }
-    if ((source==14)&&(cl==24)){
-        counter[24]++;
-        if (counter[24]%125==1){
-            return true;
-        }else{
-            return false;
-        }
-    }
-    if ((source==15)&&(cl==25)){
-        counter[25]++;
-        if (counter[25]%32==1){
-            return true;
-        }else{
-            return false;
-        }
-    }
-    return false;
+bool OnOffInjectionProcess::active(int source) const
+{
+  // a source that starts in the on state injects at r1 regardless of the 
+  // average rate
+  return (_r1 > 0.0);
+}
+
+void OnOffInjectionProcess::set_rate(double rate)
+{
+  InjectionProcess::set_rate(rate);
+  _Derive();
+  // the dwell times and gaps are memoryless, so they can simply be redrawn
+  // with the new parameters
+  _Sample();
+}
+
+void OnOffInjectionProcess::serialize(Checkpoint & cp)
+{
+  InjectionProcess::serialize(cp);
+  cp.Sync(_alpha);
+  cp.Sync(_beta);
+  cp.Sync(_r1);
+  cp.Sync(_state);
+  cp.Sync(_dwell);
+  cp.Sync(_gap);
 }
@@ -29,26 +29,51 @@
 #define _INJECTION_HPP_
 
 #include "config_utils.hpp"
+#include "random_utils.hpp"
 
 using namespace std;
 
+class Checkpoint;
+
 class InjectionProcess {
 protected:
   int _nodes;
   double _rate;
-  InjectionProcess(int nodes, double rate);
+  // one random number stream per source
+  vector<RandomStream> _random;
+  InjectionProcess(int nodes, double rate, int cl);
 public:
   virtual ~InjectionProcess() {}
   virtual bool test(int source,int cl=0) = 0;
   virtual void reset();
+  // whether test() can ever succeed for the given source at the current rate
+  virtual bool active(int source) const;
+  // number of upcoming calls to test() for the given source that are known to
+  // fail, or -1 if the process cannot predict its next injection
+  virtual int quiet(int source,int cl=0) const;
+  // advance the process as if test() had failed for the given number of calls
+  virtual void skip(int source,int cl,int calls);
+  // change the average injection rate without resetting the process state
+  virtual void set_rate(double rate);
+  // save or restore the process state
+  virtual void serialize(Checkpoint & cp);
   static InjectionProcess * New(string const & inject, int nodes, double load, 
-				Configuration const * const config = NULL);
+				Configuration const * const config = NULL,
+				int cl = 0);
 };
 
 class BernoulliInjectionProcess : public InjectionProcess {
+private:
+  // number of calls to test() that fail before the next injection
+  vector<int> _gap;
 public:
-  BernoulliInjectionProcess(int nodes, double rate);
+  BernoulliInjectionProcess(int nodes, double rate, int cl = 0);
+  virtual void reset();
   virtual bool test(int source,int cl=0);
+  virtual int quiet(int source,int cl=0) const;
+  virtual void skip(int source,int cl,int calls);
+  virtual void set_rate(double rate);
+  virtual void serialize(Checkpoint & cp);
 };
 
 class OnOffInjectionProcess : public InjectionProcess {
@@ -56,23 +81,28 @@ private:
   double _alpha;
   double _beta;
   double _r1;
+  // which of the above parameters is derived from the injection rate
+  enum eDerived { derived_alpha, derived_beta, derived_r1 };
+  eDerived _derived;
   vector<int> _initial;
   vector<int> _state;
+  // number of calls to test() that leave the state unchanged before it 
+  // flips, and number of calls in the on state that fail before the next
+  // injection
+  vector<int> _dwell;
+  vector<int> _gap;
+  void _Derive();
+  void _Sample();
 public:
   OnOffInjectionProcess(int nodes, double rate, double alpha, double beta, 
-			double r1, vector<int> initial);
+			double r1, vector<int> initial, int cl = 0);
   virtual void reset();
   virtual bool test(int source,int cl=0);
-};
-
-class CustomizedInjectionProcess: public InjectionProcess{
-private:
-    double _nodes;
-    int counter[26];
-public:
-    virtual void reset();
-    virtual bool test(int source,int cl=0);
-    CustomizedInjectionProcess(int nodes,double load);
+  virtual bool active(int source) const;
+  virtual int quiet(int source,int cl=0) const;
+  virtual void skip(int source,int cl,int calls);
+  virtual void set_rate(double rate);
+  virtual void serialize(Checkpoint & cp);
 };
 
 #endif 
@@ -38,6 +38,8 @@
 
 #include <string>
 #include <cstdlib>
+#include <cstdio>
+#include <cmath>
 #include <iostream>
 #include <fstream>
 
@@ -53,6 +55,8 @@
 #include "network.hpp"
 #include "injection.hpp"
 #include "power_module.hpp"
+#include "process_pool.hpp"
+#include "simulation_context.hpp"
 
 
 
@@ -60,22 +64,6 @@
 //Global declarations
 //////////////////////
 
- /* the current traffic manager instance */
-TrafficManager * trafficManager = NULL;
-
-int GetSimTime() {
-  return trafficManager->getTime();
-}
-
-class Stats;
-Stats * GetStats(const std::string & name) {
-  Stats* test =  trafficManager->getStats(name);
-  if(test == 0){
-    cout<<"warning statistics "<<name<<" not found"<<endl;
-  }
-  return test;
-}
-
 /* printing activity factor*/
 bool gPrintActivity;
 
@@ -94,27 +82,153 @@ ostream * gWatchOut;
 
 /////////////////////////////////////////////////////////////////////////////
 
-bool Simulate( BookSimConfig const & config )
+/* the points of a load sweep
+ *
+ * Each point runs in a forked child process that owns its traffic manager,
+ * statistics and random number state, while the networks built by the
+ * parent are shared copy-on-write.  Up to sweep_jobs points run
+ * concurrently; their logs are printed in order, followed by a summary
+ * table of all points.
+ *
+ * Points either start from scratch, in which case their results are
+ * identical to a separate run at that rate, or, with sweep_warm_start, are
+ * all forked from a single simulation once it has warmed up at the first
+ * rate of the sweep.
+ */
+class LoadSweep : public WarmupHandler {
+
+  vector<double> _rates;
+
+  ProcessPool * _pool;
+
+  static vector<string> _Titles( vector<double> const & rates );
+
+public:
+
+  LoadSweep( BookSimConfig const & config, vector<double> const & rates );
+  ~LoadSweep();
+
+  inline int Point() const { return _pool->Job(); }
+  inline double Rate() const { return _rates[Point()]; }
+
+  // simulate all points; returns the index of the point to simulate in the
+  // child processes, and -1 in the parent once all points have finished
+  int Fork();
+
+  // forks all points from the warmed-up simulation and switches each of
+  // them to its injection rate
+  virtual bool WarmedUp( TrafficManager * traffic_manager );
+
+  // pass the results of a point to the parent and end the child process
+  void Report( bool result, vector<vector<double> > const & averages );
+
+  // print the summary table; returns false if any point failed
+  bool Summarize() const;
+};
+
+LoadSweep::LoadSweep( BookSimConfig const & config, vector<double> const & rates )
+  : _rates(rates)
 {
-  vector<Network *> net;
+  _pool = new ProcessPool(_Titles(rates), config.GetInt("sweep_jobs"));
+}
 
-  int subnets = config.GetInt("subnets");
-  /*To include a new network, must register the network here
-   *add an else if statement with the name of the network
-   */
-  net.resize(subnets);
-  for (int i = 0; i < subnets; ++i) {
-    ostringstream name;
-    name << "network_" << i;
-    net[i] = Network::New( config, name.str() );
+LoadSweep::~LoadSweep()
+{
+  delete _pool;
+}
+
+vector<string> LoadSweep::_Titles( vector<double> const & rates )
+{
+  vector<string> titles;
+  for(size_t p = 0; p < rates.size(); ++p) {
+    ostringstream title;
+    title << "Load sweep: injection rate " << rates[p];
+    titles.push_back(title.str());
+  }
+  return titles;
+}
+
+int LoadSweep::Fork()
+{
+  return _pool->Fork();
+}
+
+bool LoadSweep::WarmedUp( TrafficManager * traffic_manager )
+{
+  if(Fork() < 0) {
+    return false;
   }
+  cout << "Continuing from the warmed-up state at injection rate "
+       << Rate() << endl;
+  traffic_manager->SetInjectionRate(Rate());
+  return true;
+}
+
+void LoadSweep::Report( bool result, vector<vector<double> > const & averages )
+{
+  ostringstream results;
+  results.precision(17);
+  results << result << ' ' << averages.size();
+  for(size_t c = 0; c < averages.size(); ++c) {
+    for(size_t i = 0; i < averages[c].size(); ++i) {
+      results << ' ' << averages[c][i];
+    }
+  }
+  results << endl;
+  _pool->Report(results.str());
+}
+
+bool LoadSweep::Summarize() const
+{
+  cout << "====== Load sweep summary ======" << endl
+       << "injection rate,class,packet latency,network latency,flit latency,"
+       << "injected flit rate,accepted flit rate" << endl;
+  bool result = true;
+  for(size_t p = 0; p < _rates.size(); ++p) {
+    string const & data = _pool->Results(p);
+    if(data.empty()) {
+      cout << _rates[p] << ",failed" << endl;
+      result = false;
+      continue;
+    }
+    istringstream results(data);
+    bool succeeded;
+    size_t classes;
+    results >> succeeded >> classes;
+    if(!succeeded) {
+      cout << _rates[p] << ",unstable" << endl;
+      result = false;
+      continue;
+    }
+    for(size_t c = 0; c < classes; ++c) {
+      cout << _rates[p] << ',' << c;
+      for(size_t i = 0; i < 5; ++i) {
+	double value;
+	results >> value;
+	cout << ',' << value;
+      }
+      cout << endl;
+    }
+  }
+  return result;
+}
 
+/* run a single simulation on the given networks; when simulating a point of
+ * a load sweep, the results are reported to the sweep and the function only
+ * returns in the parent process of a warm-started sweep
+ */
+bool RunSimulation( BookSimConfig const & config, vector<Network *> const & net,
+		    LoadSweep * sweep = NULL )
+{
   /*tcc and characterize are legacy
    *not sure how to use them 
    */
 
-  assert(trafficManager == NULL);
-  trafficManager = TrafficManager::New( config, net ) ;
+  TrafficManager * traffic_manager = TrafficManager::New( config, net ) ;
+
+  if(sweep && (sweep->Point() < 0)) {
+    traffic_manager->SetWarmupHandler( sweep );
+  }
 
   /*Start the simulation run
    */
@@ -124,8 +238,13 @@ bool Simulate( BookSimConfig const & config )
   total_time = 0.0;
   gettimeofday(&start_time, NULL);
 
-  bool result = trafficManager->Run() ;
+  bool result = traffic_manager->Run() ;
 
+  if(sweep && (sweep->Point() < 0)) {
+    // the warm-up simulation ends once all points forked from it finished
+    delete traffic_manager;
+    return sweep->Summarize();
+  }
 
   gettimeofday(&end_time, NULL);
   total_time = ((double)(end_time.tv_sec) + (double)(end_time.tv_usec)/1000000.0)
@@ -133,19 +252,112 @@ bool Simulate( BookSimConfig const & config )
 
   cout<<"Total run time "<<total_time<<endl;
 
-  for (int i=0; i<subnets; ++i) {
-
-    ///Power analysis
-    if(config.GetInt("sim_power") > 0){
+  ///Power analysis
+  if(config.GetInt("sim_power") > 0){
+    for (int i=0; i<(int)net.size(); ++i) {
       Power_Module pnet(net[i], config);
       pnet.run();
     }
+  }
 
-    delete net[i];
+  if(sweep) {
+    vector<vector<double> > averages;
+    for(int c = 0; c < traffic_manager->getClasses(); ++c) {
+      averages.push_back(traffic_manager->getOverallAverages(c));
+    }
+    sweep->Report(result, averages);
+  }
+
+  delete traffic_manager;
+
+  return result;
+}
+
+/* injection rates of a load sweep, given either as a list ({0.1,0.2,...})
+ * or as a range ({min:step:max})
+ */
+vector<double> SweepRates( BookSimConfig const & config )
+{
+  string rates = config.GetStr("sweep_rates");
+  size_t const colon = rates.find(':');
+  if(colon == string::npos) {
+    return tokenize_float(rates);
+  }
+  if((rates[0] == '{') && (rates[rates.size() - 1] == '}')) {
+    rates = rates.substr(1, rates.size() - 2);
+  }
+  size_t const first = rates.find(':');
+  size_t const second = rates.find(':', first + 1);
+  if(second == string::npos) {
+    cerr << "Error: Invalid sweep_rates range: " << rates << endl;
+    exit(-1);
   }
+  double const min_rate = atof(rates.substr(0, first).c_str());
+  double const step = atof(rates.substr(first + 1, second - first - 1).c_str());
+  double const max_rate = atof(rates.substr(second + 1).c_str());
+  if((step <= 0.0) || (max_rate < min_rate)) {
+    cerr << "Error: Invalid sweep_rates range: " << rates << endl;
+    exit(-1);
+  }
+  vector<double> values;
+  int const points = (int)floor((max_rate - min_rate) / step + 1e-9) + 1;
+  for(int i = 0; i < points; ++i) {
+    values.push_back(min_rate + (double)i * step);
+  }
+  return values;
+}
+
+/* simulate every injection rate of a load sweep on the same networks
+ */
+bool Sweep( BookSimConfig const & config, vector<Network *> const & net,
+	    vector<double> const & rates )
+{
+  LoadSweep sweep(config, rates);
+
+  BookSimConfig point_config = config;
+  point_config.Assign("injection_rate", string(""));
 
-  delete trafficManager;
-  trafficManager = NULL;
+  if(config.GetInt("sweep_warm_start") > 0) {
+    point_config.Assign("injection_rate", rates[0]);
+    return RunSimulation(point_config, net, &sweep);
+  }
+
+  if(sweep.Fork() < 0) {
+    return sweep.Summarize();
+  }
+  point_config.Assign("injection_rate", sweep.Rate());
+  return RunSimulation(point_config, net, &sweep);
+}
+
+bool Simulate( BookSimConfig const & config )
+{
+  SimulationContext context(config);
+
+  vector<Network *> net;
+
+  int subnets = config.GetInt("subnets");
+  /*To include a new network, must register the network here
+   *add an else if statement with the name of the network
+   */
+  net.resize(subnets);
+  for (int i = 0; i < subnets; ++i) {
+    ostringstream name;
+    name << "network_" << i;
+    net[i] = Network::New( config, name.str(), &context );
+  }
+
+  vector<double> const rates = SweepRates( config );
+
+  bool result;
+  if(rates.empty()) {
+    result = RunSimulation( config, net );
+  } else {
+    result = Sweep( config, net, rates );
+  }
+
+  for (int i=0; i<subnets; ++i) {
+    delete net[i];
+  }
 
   return result;
 }
@@ -165,7 +377,7 @@ int main( int argc, char **argv )
   
   /*initialize routing, traffic, injection functions
    */
-  InitializeRoutingMap( config );
+  InitializeRoutingMap( );
 
   gPrintActivity = (config.GetInt("print_activity") > 0);
   gTrace = (config.GetInt("viewer_trace") > 0);
@@ -45,11 +45,20 @@ Module::Module( Module *parent, const string& name )
   if ( parent ) { 
     parent->_AddChild( this );
     _fullname = parent->_fullname + "/" + name;
+    _context = parent->_context;
   } else {
     _fullname = name;
+    _context = NULL;
   }
 }
 
+Module::Module( SimulationContext *context, const string& name )
+{
+  _name     = name;
+  _fullname = name;
+  _context  = context;
+}
+
 void Module::_AddChild( Module *child )
 {
   _children.push_back( child );
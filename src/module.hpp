@@ -29,6 +29,7 @@
 #define _MODULE_HPP_
 
 #include "booksim.hpp"
+#include "simulation_context.hpp"
 
 #include <string>
 #include <vector>
@@ -39,6 +40,8 @@ private:
   string _name;
   string _fullname;
 
+  SimulationContext * _context;
+
   vector<Module *> _children;
 
 protected:
@@ -46,11 +49,15 @@ protected:
 
 public:
   Module( Module *parent, const string& name );
+  Module( SimulationContext *context, const string& name );
   virtual ~Module( ) { }
   
   inline const string & Name() const { return _name; }
   inline const string & FullName() const { return _fullname; }
 
+  inline SimulationContext * GetContext() const { return _context; }
+  inline int GetSimTime() const { return _context->GetSimTime(); }
+
   void DisplayHierarchy( int level = 0, ostream & os = cout ) const;
 
   void Error( const string& msg ) const;
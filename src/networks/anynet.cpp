@@ -55,11 +55,9 @@
 #include <sstream>
 #include <limits>
 #include <algorithm>
-//this is a hack, I can't easily get the routing talbe out of the network
-map<int, int>* global_routing_table;
 
-AnyNet::AnyNet( const Configuration &config, const string & name )
-  :  Network( config, name ){
+AnyNet::AnyNet( const Configuration &config, const string & name, SimulationContext * context )
+  :  Network( config, name, context ){
 
   router_list.resize(2);
   _ComputeSize( config );
@@ -215,25 +213,14 @@ void min_anynet( const Router *r, const Flit *f, int in_channel,
 		 OutputSet *outputs, bool inject ){
   int out_port=-1;
   if(!inject){
-    assert(global_routing_table[r->GetID()].count(f->dest)!=0);
-    out_port=global_routing_table[r->GetID()][f->dest];
+    AnyNet const * const net =
+      static_cast<AnyNet const *>(r->GetContext()->GetTopology());
+    out_port=net->GetRoute(r->GetID(), f->dest);
   }
  
 
-  int vcBegin = 0, vcEnd = gNumVCs-1;
-  if ( f->type == Flit::READ_REQUEST ) {
-    vcBegin = gReadReqBeginVC;
-    vcEnd   = gReadReqEndVC;
-  } else if ( f->type == Flit::WRITE_REQUEST ) {
-    vcBegin = gWriteReqBeginVC;
-    vcEnd   = gWriteReqEndVC;
-  } else if ( f->type ==  Flit::READ_REPLY ) {
-    vcBegin = gReadReplyBeginVC;
-    vcEnd   = gReadReplyEndVC;
-  } else if ( f->type ==  Flit::WRITE_REPLY ) {
-    vcBegin = gWriteReplyBeginVC;
-    vcEnd   = gWriteReplyEndVC;
-  }
+  int vcBegin = r->GetContext()->BeginVC(f->type);
+  int vcEnd = r->GetContext()->EndVC(f->type);
 
   outputs->Clear( );
 
@@ -246,7 +233,13 @@ void AnyNet::buildRoutingTable(){
   for(int i = 0; i<_size; i++){
     route(i);
   }
-  global_routing_table = &routing_table[0];
+}
+
+int AnyNet::GetRoute(int rID, int dest) const
+{
+  map<int, int>::const_iterator iter = routing_table[rID].find(dest);
+  assert(iter != routing_table[rID].end());
+  return iter->second;
 }
 
 
@@ -53,7 +53,7 @@ class AnyNet : public Network {
   void route(int r_start);
 
 public:
-  AnyNet( const Configuration &config, const string & name );
+  AnyNet( const Configuration &config, const string & name, SimulationContext * context );
   ~AnyNet();
 
   int GetN( ) const{ return -1;}
@@ -61,6 +61,8 @@ public:
 
   static void RegisterRoutingFunctions();
   double Capacity( ) const {return -1;}
+  //output port towards a node on a minimal route
+  int GetRoute( int rID, int dest ) const;
   void InsertRandomFaults( const Configuration &config ){}
 };
 
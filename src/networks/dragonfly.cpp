@@ -37,10 +37,8 @@
 
 #define DRAGON_LATENCY
 
-int gP, gA, gG;
-
 //calculate the hop count between src and estination
-int dragonflynew_hopcnt(int src, int dest) 
+int DragonFlyNew::HopCount(int src, int dest) const
 {
   int hopcnt;
   int dest_grp_ID, src_grp_ID; 
@@ -49,15 +47,12 @@ int dragonflynew_hopcnt(int src, int dest)
   int grp_output, dest_grp_output;
   int grp_output_RID;
 
-  int _grp_num_routers= gA;
-  int _grp_num_nodes =_grp_num_routers*gP;
-  
   dest_grp_ID = int(dest/_grp_num_nodes);
   src_grp_ID = int(src / _grp_num_nodes);
   
   //source and dest are in the same group, either 0-1 hop
   if (dest_grp_ID == src_grp_ID) {
-    if ((int)(dest / gP) == (int)(src /gP))
+    if ((int)(dest / _p) == (int)(src /_p))
       hopcnt = 0;
     else
       hopcnt = 1;
@@ -74,20 +69,20 @@ int dragonflynew_hopcnt(int src, int dest)
       grp_output = dest_grp_ID - 1;
       dest_grp_output = src_grp_ID;
     }
-    grp_output_RID = ((int) (grp_output / (gP))) + src_grp_ID * _grp_num_routers;
-    src_intm = grp_output_RID * gP;
+    grp_output_RID = ((int) (grp_output / (_p))) + src_grp_ID * _grp_num_routers;
+    src_intm = grp_output_RID * _p;
 
-    grp_output_RID = ((int) (dest_grp_output / (gP))) + dest_grp_ID * _grp_num_routers;
-    dest_intm = grp_output_RID * gP;
+    grp_output_RID = ((int) (dest_grp_output / (_p))) + dest_grp_ID * _grp_num_routers;
+    dest_intm = grp_output_RID * _p;
 
     //hop count in source group
-    if ((int)( src_intm / gP) == (int)( src / gP ) )
+    if ((int)( src_intm / _p) == (int)( src / _p ) )
       src_hopcnt = 0;
     else
       src_hopcnt = 1; 
 
     //hop count in destination group
-    if ((int)( dest_intm / gP) == (int)( dest / gP ) ){
+    if ((int)( dest_intm / _p) == (int)( dest / _p ) ){
       dest_hopcnt = 0;
     }else{
       dest_hopcnt = 1;
@@ -102,10 +97,8 @@ int dragonflynew_hopcnt(int src, int dest)
 
 
 //packet output port based on the source, destination and current location
-int dragonfly_port(int rID, int source, int dest){
-  int _grp_num_routers= gA;
-  int _grp_num_nodes =_grp_num_routers*gP;
-
+int DragonFlyNew::Port(int rID, int source, int dest) const
+{
   int out_port = -1;
   int grp_ID = int(rID / _grp_num_routers); 
   int dest_grp_ID = int(dest/_grp_num_nodes);
@@ -115,31 +108,31 @@ int dragonfly_port(int rID, int source, int dest){
   
   //which router within this group the packet needs to go to
   if (dest_grp_ID == grp_ID) {
-    grp_RID = int(dest / gP);
+    grp_RID = int(dest / _p);
   } else {
     if (grp_ID > dest_grp_ID) {
       grp_output = dest_grp_ID;
     } else {
       grp_output = dest_grp_ID - 1;
     }
-    grp_RID = int(grp_output /gP) + grp_ID * _grp_num_routers;
-    group_dest = grp_RID * gP;
+    grp_RID = int(grp_output /_p) + grp_ID * _grp_num_routers;
+    group_dest = grp_RID * _p;
   }
 
   //At the last hop
-  if (dest >= rID*gP && dest < (rID+1)*gP) {    
-    out_port = dest%gP;
+  if (dest >= rID*_p && dest < (rID+1)*_p) {    
+    out_port = dest%_p;
   } else if (grp_RID == rID) {
     //At the optical link
-    out_port = gP + (gA-1) + grp_output %(gP);
+    out_port = _p + (_a-1) + grp_output %(_p);
   } else {
     //need to route within a group
     assert(grp_RID!=-1);
 
     if (rID < grp_RID){
-      out_port = (grp_RID % _grp_num_routers) - 1 + gP;
+      out_port = (grp_RID % _grp_num_routers) - 1 + _p;
     }else{
-      out_port = (grp_RID % _grp_num_routers) + gP;
+      out_port = (grp_RID % _grp_num_routers) + _p;
     }
   }  
  
@@ -148,8 +141,8 @@ int dragonfly_port(int rID, int source, int dest){
 }
 
 
-DragonFlyNew::DragonFlyNew( const Configuration &config, const string & name ) :
-  Network( config, name )
+DragonFlyNew::DragonFlyNew( const Configuration &config, const string & name, SimulationContext * context ) :
+  Network( config, name, context )
 {
 
   _ComputeSize( config );
@@ -206,11 +199,8 @@ void DragonFlyNew::_ComputeSize( const Configuration &config )
 
 
   
-  gG = _g;
-  gP = _p;
-  gA = _a;
-  _grp_num_routers = gA;
-  _grp_num_nodes =_grp_num_routers*gP;
+  _grp_num_routers = _a;
+  _grp_num_nodes =_grp_num_routers*_p;
 
 }
 
@@ -423,12 +413,16 @@ void min_dragonflynew( const Router *r, const Flit *f, int in_channel,
   outputs->Clear( );
 
   if(inject) {
-    int inject_vc= RandomInt(gNumVCs-1);
+    int inject_vc= f->RandomInt(r->GetContext()->NumVCs()-1);
     outputs->AddRange(-1, inject_vc, inject_vc);
     return;
   }
 
-  int _grp_num_routers= gA;
+  DragonFlyNew const * const net =
+    static_cast<DragonFlyNew const *>(r->GetContext()->GetTopology());
+  int const router_nodes = net->GetP();
+
+  int _grp_num_routers= net->GetA();
 
   int dest  = f->dest;
   int rID =  r->GetID(); 
@@ -439,7 +433,7 @@ void min_dragonflynew( const Router *r, const Flit *f, int in_channel,
   int out_vc = 0;
   int dest_grp_ID=-1;
 
-  if ( in_channel < gP ) {
+  if ( in_channel < router_nodes ) {
     out_vc = 0;
     f->ph = 0;
     if (dest_grp_ID == grp_ID) {
@@ -448,16 +442,16 @@ void min_dragonflynew( const Router *r, const Flit *f, int in_channel,
   } 
 
 
-  out_port = dragonfly_port(rID, f->src, dest);
+  out_port = net->Port(rID, f->src, dest);
 
   //optical dateline
-  if (out_port >=gP + (gA-1)) {
+  if (out_port >=router_nodes + (_grp_num_routers-1)) {
     f->ph = 1;
   }  
   
   out_vc = f->ph;
   if (debug)
-    *gWatchOut << GetSimTime() << " | " << r->FullName() << " | "
+    *gWatchOut << r->GetSimTime() << " | " << r->FullName() << " | "
 	       << "	through output port : " << out_port 
 	       << " out vc: " << out_vc << endl;
   outputs->AddRange( out_port, out_vc, out_vc );
@@ -470,10 +464,10 @@ void ugal_dragonflynew( const Router *r, const Flit *f, int in_channel,
 {
   //need 3 VCs for deadlock freedom
 
-  assert(gNumVCs==3);
+  assert(r->GetContext()->NumVCs()==3);
   outputs->Clear( );
   if(inject) {
-    int inject_vc= RandomInt(gNumVCs-1);
+    int inject_vc= f->RandomInt(r->GetContext()->NumVCs()-1);
     outputs->AddRange(-1, inject_vc, inject_vc);
     return;
   }
@@ -482,9 +476,14 @@ void ugal_dragonflynew( const Router *r, const Flit *f, int in_channel,
   //negative value woudl biases it towards nonminimum routing
   int adaptive_threshold = 30;
 
-  int _grp_num_routers= gA;
-  int _grp_num_nodes =_grp_num_routers*gP;
-  int _network_size =  gA * gP * gG;
+  DragonFlyNew const * const net =
+    static_cast<DragonFlyNew const *>(r->GetContext()->GetTopology());
+  int const router_nodes = net->GetP();
+  int const num_groups = net->GetG();
+
+  int _grp_num_routers= net->GetA();
+  int _grp_num_nodes =_grp_num_routers*router_nodes;
+  int _network_size =  _grp_num_routers * router_nodes * num_groups;
 
  
   int dest  = f->dest;
@@ -506,13 +505,13 @@ void ugal_dragonflynew( const Router *r, const Flit *f, int in_channel,
   int min_router_output, nonmin_router_output;
   
   //at the source router, make the adaptive routing decision
-  if ( in_channel < gP )   {
+  if ( in_channel < router_nodes )   {
     //dest are in the same group, only use minimum routing
     if (dest_grp_ID == grp_ID) {
       f->ph = 2;
     } else {
       //select a random node
-      f->intm =RandomInt(_network_size - 1);
+      f->intm =f->RandomInt(_network_size - 1);
       intm_grp_ID = (int)(f->intm/_grp_num_nodes);
       if (debug){
 	cout<<"Intermediate node "<<f->intm<<" grp id "<<intm_grp_ID<<endl;
@@ -523,14 +522,14 @@ void ugal_dragonflynew( const Router *r, const Flit *f, int in_channel,
 	f->ph = 1;
       } else {
 	//congestion metrics using queue length, obtained by GetUsedCredit()
-	min_hopcnt = dragonflynew_hopcnt(f->src, f->dest);
-	min_router_output = dragonfly_port(rID, f->src, f->dest); 
+	min_hopcnt = net->HopCount(f->src, f->dest);
+	min_router_output = net->Port(rID, f->src, f->dest); 
       	min_queue_size = max(r->GetUsedCredit(min_router_output), 0) ; 
 
       
-	nonmin_hopcnt = dragonflynew_hopcnt(f->src, f->intm) +
-	  dragonflynew_hopcnt(f->intm,f->dest);
-	nonmin_router_output = dragonfly_port(rID, f->src, f->intm);
+	nonmin_hopcnt = net->HopCount(f->src, f->intm) +
+	  net->HopCount(f->intm,f->dest);
+	nonmin_router_output = net->Port(rID, f->src, f->intm);
 	nonmin_queue_size = max(r->GetUsedCredit(nonmin_router_output), 0);
 
 	//congestion comparison, could use hopcnt instead of 1 and 2
@@ -546,7 +545,7 @@ void ugal_dragonflynew( const Router *r, const Flit *f, int in_channel,
 
   //transition from nonminimal phase to minimal
   if(f->ph==0){
-    intm_rID= (int)(f->intm/gP);
+    intm_rID= (int)(f->intm/router_nodes);
     if( rID == intm_rID){
       f->ph = 1;
     }
@@ -554,17 +553,17 @@ void ugal_dragonflynew( const Router *r, const Flit *f, int in_channel,
 
   //port assignement based on the phase
   if(f->ph == 0){
-    out_port = dragonfly_port(rID, f->src, f->intm);
+    out_port = net->Port(rID, f->src, f->intm);
   } else if(f->ph == 1){
-    out_port = dragonfly_port(rID, f->src, f->dest);
+    out_port = net->Port(rID, f->src, f->dest);
   } else if(f->ph == 2){
-    out_port = dragonfly_port(rID, f->src, f->dest);
+    out_port = net->Port(rID, f->src, f->dest);
   } else {
     assert(false);
   }
 
   //optical dateline
-  if (f->ph == 1 && out_port >=gP + (gA-1)) {
+  if (f->ph == 1 && out_port >=router_nodes + (_grp_num_routers-1)) {
     f->ph = 2;
   }  
 
@@ -54,7 +54,7 @@ class DragonFlyNew : public Network {
 
  
 public:
-  DragonFlyNew( const Configuration &config, const string & name );
+  DragonFlyNew( const Configuration &config, const string & name, SimulationContext * context );
 
   int GetN( ) const;
   int GetK( ) const;
@@ -63,8 +63,15 @@ public:
   static void RegisterRoutingFunctions();
   void InsertRandomFaults( const Configuration &config );
 
+  inline int GetP( ) const { return _p; }
+  inline int GetA( ) const { return _a; }
+  inline int GetG( ) const { return _g; }
+
+  //hop count between two nodes on a minimal route
+  int HopCount( int src, int dest ) const;
+  //packet output port based on the source, destination and current router
+  int Port( int rID, int source, int dest ) const;
 };
-int dragonfly_port(int rID, int source, int dest);
 
 void ugal_dragonflynew( const Router *r, const Flit *f, int in_channel,
 		       OutputSet *outputs, bool inject );
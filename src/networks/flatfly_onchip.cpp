@@ -65,8 +65,8 @@ static int _ycount;
 static int _xrouter;
 static int _yrouter;
 
-FlatFlyOnChip::FlatFlyOnChip( const Configuration &config, const string & name ) :
-  Network( config, name )
+FlatFlyOnChip::FlatFlyOnChip( const Configuration &config, const string & name, SimulationContext * context ) :
+  Network( config, name, context )
 {
 
   _ComputeSize( config );
@@ -333,20 +333,8 @@ void adaptive_xyyx_flatfly( const Router *r, const Flit *f, int in_channel,
 		  OutputSet *outputs, bool inject )
 { 
   // ( Traffic Class , Routing Order ) -> Virtual Channel Range
-  int vcBegin = 0, vcEnd = gNumVCs-1;
-  if ( f->type == Flit::READ_REQUEST ) {
-    vcBegin = gReadReqBeginVC;
-    vcEnd = gReadReqEndVC;
-  } else if ( f->type == Flit::WRITE_REQUEST ) {
-    vcBegin = gWriteReqBeginVC;
-    vcEnd = gWriteReqEndVC;
-  } else if ( f->type ==  Flit::READ_REPLY ) {
-    vcBegin = gReadReplyBeginVC;
-    vcEnd = gReadReplyEndVC;
-  } else if ( f->type ==  Flit::WRITE_REPLY ) {
-    vcBegin = gWriteReplyBeginVC;
-    vcEnd = gWriteReplyEndVC;
-  }
+  int vcBegin = r->GetContext()->BeginVC(f->type);
+  int vcEnd = r->GetContext()->EndVC(f->type);
   assert(((f->vc >= vcBegin) && (f->vc <= vcEnd)) || (inject && (f->vc < 0)));
 
   int out_port;
@@ -383,7 +371,7 @@ void adaptive_xyyx_flatfly( const Router *r, const Flit *f, int in_channel,
 	} else if(credit_xy < credit_yx) {
 	  x_then_y = true;
 	} else {
-	  x_then_y = (RandomInt(1) > 0);
+	  x_then_y = (f->RandomInt(1) > 0);
 	}
       } else {
 	x_then_y =  (f->vc < (vcBegin + available_vcs));
@@ -410,20 +398,8 @@ void xyyx_flatfly( const Router *r, const Flit *f, int in_channel,
 		  OutputSet *outputs, bool inject )
 { 
   // ( Traffic Class , Routing Order ) -> Virtual Channel Range
-  int vcBegin = 0, vcEnd = gNumVCs-1;
-  if ( f->type == Flit::READ_REQUEST ) {
-    vcBegin = gReadReqBeginVC;
-    vcEnd = gReadReqEndVC;
-  } else if ( f->type == Flit::WRITE_REQUEST ) {
-    vcBegin = gWriteReqBeginVC;
-    vcEnd = gWriteReqEndVC;
-  } else if ( f->type ==  Flit::READ_REPLY ) {
-    vcBegin = gReadReplyBeginVC;
-    vcEnd = gReadReplyEndVC;
-  } else if ( f->type ==  Flit::WRITE_REPLY ) {
-    vcBegin = gWriteReplyBeginVC;
-    vcEnd = gWriteReplyEndVC;
-  }
+  int vcBegin = r->GetContext()->BeginVC(f->type);
+  int vcEnd = r->GetContext()->EndVC(f->type);
   assert(((f->vc >= vcBegin) && (f->vc <= vcEnd)) || (inject && (f->vc < 0)));
 
   int out_port;
@@ -448,7 +424,7 @@ void xyyx_flatfly( const Router *r, const Flit *f, int in_channel,
 
       // randomly select dimension order at first hop
       bool x_then_y = ((in_channel < gC) ?
-		       (RandomInt(1) > 0) : 
+		       (f->RandomInt(1) > 0) : 
 		       (f->vc < (vcBegin + available_vcs)));
 
       if(x_then_y) {
@@ -503,20 +479,8 @@ void valiant_flatfly( const Router *r, const Flit *f, int in_channel,
 		  OutputSet *outputs, bool inject )
 {
   // ( Traffic Class , Routing Order ) -> Virtual Channel Range
-  int vcBegin = 0, vcEnd = gNumVCs-1;
-  if ( f->type == Flit::READ_REQUEST ) {
-    vcBegin = gReadReqBeginVC;
-    vcEnd = gReadReqEndVC;
-  } else if ( f->type == Flit::WRITE_REQUEST ) {
-    vcBegin = gWriteReqBeginVC;
-    vcEnd = gWriteReqEndVC;
-  } else if ( f->type ==  Flit::READ_REPLY ) {
-    vcBegin = gReadReplyBeginVC;
-    vcEnd = gReadReplyEndVC;
-  } else if ( f->type ==  Flit::WRITE_REPLY ) {
-    vcBegin = gWriteReplyBeginVC;
-    vcEnd = gWriteReplyEndVC;
-  }
+  int vcBegin = r->GetContext()->BeginVC(f->type);
+  int vcEnd = r->GetContext()->EndVC(f->type);
   assert(((f->vc >= vcBegin) && (f->vc <= vcEnd)) || (inject && (f->vc < 0)));
 
   int out_port;
@@ -529,7 +493,7 @@ void valiant_flatfly( const Router *r, const Flit *f, int in_channel,
 
     if ( in_channel < gC ){
       f->ph = 0;
-      f->intm = RandomInt( powi( gK, gN )*gC-1);
+      f->intm = f->RandomInt( powi( gK, gN )*gC-1);
     }
 
     int intm = flatfly_transformation(f->intm);
@@ -572,20 +536,8 @@ void min_flatfly( const Router *r, const Flit *f, int in_channel,
 		  OutputSet *outputs, bool inject )
 {
   // ( Traffic Class , Routing Order ) -> Virtual Channel Range
-  int vcBegin = 0, vcEnd = gNumVCs-1;
-  if ( f->type == Flit::READ_REQUEST ) {
-    vcBegin = gReadReqBeginVC;
-    vcEnd = gReadReqEndVC;
-  } else if ( f->type == Flit::WRITE_REQUEST ) {
-    vcBegin = gWriteReqBeginVC;
-    vcEnd = gWriteReqEndVC;
-  } else if ( f->type ==  Flit::READ_REPLY ) {
-    vcBegin = gReadReplyBeginVC;
-    vcEnd = gReadReplyEndVC;
-  } else if ( f->type ==  Flit::WRITE_REPLY ) {
-    vcBegin = gWriteReplyBeginVC;
-    vcEnd = gWriteReplyEndVC;
-  }
+  int vcBegin = r->GetContext()->BeginVC(f->type);
+  int vcEnd = r->GetContext()->EndVC(f->type);
   assert(((f->vc >= vcBegin) && (f->vc <= vcEnd)) || (inject && (f->vc < 0)));
 
   int out_port;
@@ -627,20 +579,8 @@ void ugal_xyyx_flatfly_onchip( const Router *r, const Flit *f, int in_channel,
 			  OutputSet *outputs, bool inject )
 {
   // ( Traffic Class , Routing Order ) -> Virtual Channel Range
-  int vcBegin = 0, vcEnd = gNumVCs-1;
-  if ( f->type == Flit::READ_REQUEST ) {
-    vcBegin = gReadReqBeginVC;
-    vcEnd = gReadReqEndVC;
-  } else if ( f->type == Flit::WRITE_REQUEST ) {
-    vcBegin = gWriteReqBeginVC;
-    vcEnd = gWriteReqEndVC;
-  } else if ( f->type ==  Flit::READ_REPLY ) {
-    vcBegin = gReadReplyBeginVC;
-    vcEnd = gReadReplyEndVC;
-  } else if ( f->type ==  Flit::WRITE_REPLY ) {
-    vcBegin = gWriteReplyBeginVC;
-    vcEnd = gWriteReplyEndVC;
-  }
+  int vcBegin = r->GetContext()->BeginVC(f->type);
+  int vcEnd = r->GetContext()->EndVC(f->type);
   assert(((f->vc >= vcBegin) && (f->vc <= vcEnd)) || (inject && (f->vc < 0)));
 
   int out_port;
@@ -711,7 +651,7 @@ void ugal_xyyx_flatfly_onchip( const Router *r, const Flit *f, int in_channel,
 
       // randomly select dimension order at first hop
       bool x_then_y = ((in_channel < gC) ?
-		       (RandomInt(1) > 0) : 
+		       (f->RandomInt(1) > 0) : 
 		       (f->vc < (vcBegin + xy_available_vcs)));
 
       if (f->ph == 0) {
@@ -729,7 +669,7 @@ void ugal_xyyx_flatfly_onchip( const Router *r, const Flit *f, int in_channel,
 	_min_queucnt =   r->GetUsedCredit(tmp_out_port);
 
 	//find the nonmin router, nonmin port, nonmin count
-	_ran_intm = find_ran_intm(flatfly_transformation(f->src), dest);
+	_ran_intm = find_ran_intm(f, flatfly_transformation(f->src), dest);
 	_nonmin_hop = find_distance(flatfly_transformation(f->src),_ran_intm) +    find_distance(_ran_intm, dest);
 	if(x_then_y){
 	  tmp_out_port =  flatfly_outport(_ran_intm, rID);
@@ -826,20 +766,8 @@ void ugal_flatfly_onchip( const Router *r, const Flit *f, int in_channel,
 			  OutputSet *outputs, bool inject )
 {
   // ( Traffic Class , Routing Order ) -> Virtual Channel Range
-  int vcBegin = 0, vcEnd = gNumVCs-1;
-  if ( f->type == Flit::READ_REQUEST ) {
-    vcBegin = gReadReqBeginVC;
-    vcEnd = gReadReqEndVC;
-  } else if ( f->type == Flit::WRITE_REQUEST ) {
-    vcBegin = gWriteReqBeginVC;
-    vcEnd = gWriteReqEndVC;
-  } else if ( f->type ==  Flit::READ_REPLY ) {
-    vcBegin = gReadReplyBeginVC;
-    vcEnd = gReadReplyEndVC;
-  } else if ( f->type ==  Flit::WRITE_REPLY ) {
-    vcBegin = gWriteReplyBeginVC;
-    vcEnd = gWriteReplyEndVC;
-  }
+  int vcBegin = r->GetContext()->BeginVC(f->type);
+  int vcEnd = r->GetContext()->EndVC(f->type);
   assert(((f->vc >= vcBegin) && (f->vc <= vcEnd)) || (inject && (f->vc < 0)));
 
   int out_port;
@@ -908,10 +836,10 @@ void ugal_flatfly_onchip( const Router *r, const Flit *f, int in_channel,
 
       if (f->ph == 0) {
 	_min_hop = find_distance(flatfly_transformation(f->src),dest);
-	_ran_intm = find_ran_intm(flatfly_transformation(f->src), dest);
+	_ran_intm = find_ran_intm(f, flatfly_transformation(f->src), dest);
 	tmp_out_port =  flatfly_outport(dest, rID);
 	if (f->watch){
-	  *gWatchOut << GetSimTime() << " | " << r->FullName() << " | "
+	  *gWatchOut << r->GetSimTime() << " | " << r->FullName() << " | "
 		     << " MIN tmp_out_port: " << tmp_out_port;
 	}
 
@@ -921,7 +849,7 @@ void ugal_flatfly_onchip( const Router *r, const Flit *f, int in_channel,
 	tmp_out_port =  flatfly_outport(_ran_intm, rID);
 
 	if (f->watch){
-	  *gWatchOut << GetSimTime() << " | " << r->FullName() << " | "
+	  *gWatchOut << r->GetSimTime() << " | " << r->FullName() << " | "
 		     << " NONMIN tmp_out_port: " << tmp_out_port << endl;
 	}
 	if (_ran_intm >= rID*_concentration && _ran_intm < (rID+1)*_concentration) {
@@ -999,20 +927,8 @@ void ugal_pni_flatfly_onchip( const Router *r, const Flit *f, int in_channel,
 			      OutputSet *outputs, bool inject )
 {
   // ( Traffic Class , Routing Order ) -> Virtual Channel Range
-  int vcBegin = 0, vcEnd = gNumVCs-1;
-  if ( f->type == Flit::READ_REQUEST ) {
-    vcBegin = gReadReqBeginVC;
-    vcEnd = gReadReqEndVC;
-  } else if ( f->type == Flit::WRITE_REQUEST ) {
-    vcBegin = gWriteReqBeginVC;
-    vcEnd = gWriteReqEndVC;
-  } else if ( f->type ==  Flit::READ_REPLY ) {
-    vcBegin = gReadReplyBeginVC;
-    vcEnd = gReadReplyEndVC;
-  } else if ( f->type ==  Flit::WRITE_REPLY ) {
-    vcBegin = gWriteReplyBeginVC;
-    vcEnd = gWriteReplyEndVC;
-  }
+  int vcBegin = r->GetContext()->BeginVC(f->type);
+  int vcEnd = r->GetContext()->EndVC(f->type);
   assert(((f->vc >= vcBegin) && (f->vc <= vcEnd)) || (inject && (f->vc < 0)));
 
   int out_port;
@@ -1081,10 +997,10 @@ void ugal_pni_flatfly_onchip( const Router *r, const Flit *f, int in_channel,
 
       if (f->ph == 0) {
 	_min_hop = find_distance(flatfly_transformation(f->src),dest);
-	_ran_intm = find_ran_intm(flatfly_transformation(f->src), dest);
+	_ran_intm = find_ran_intm(f, flatfly_transformation(f->src), dest);
 	tmp_out_port =  flatfly_outport(dest, rID);
 	if (f->watch){
-	  *gWatchOut << GetSimTime() << " | " << r->FullName() << " | "
+	  *gWatchOut << r->GetSimTime() << " | " << r->FullName() << " | "
 		     << " MIN tmp_out_port: " << tmp_out_port;
 	}
 
@@ -1094,7 +1010,7 @@ void ugal_pni_flatfly_onchip( const Router *r, const Flit *f, int in_channel,
 	tmp_out_port =  flatfly_outport(_ran_intm, rID);
 
 	if (f->watch){
-	  *gWatchOut << GetSimTime() << " | " << r->FullName() << " | "
+	  *gWatchOut << r->GetSimTime() << " | " << r->FullName() << " | "
 		     << " NONMIN tmp_out_port: " << tmp_out_port << endl;
 	}
 	if (_ran_intm >= rID*_concentration && _ran_intm < (rID+1)*_concentration) {
@@ -1231,7 +1147,7 @@ int find_distance (int src, int dest) {
 //=============================================================^M
 // UGAL : find random node for load balancing
 //=============================================================^M
-int find_ran_intm (int src, int dest) {
+int find_ran_intm (const Flit * f, int src, int dest) {
   int _dim   = gN;
   int _dim_size;
   int _ran_dest = 0;
@@ -1243,7 +1159,7 @@ int find_ran_intm (int src, int dest) {
   src = (int) (src / gC);
   dest = (int) (dest / gC);
   
-  _ran_dest = RandomInt(gC - 1);
+  _ran_dest = f->RandomInt(gC - 1);
   if (debug) cout << " ............ _ran_dest : " << _ran_dest << endl;
   for (int d=0;d < _dim; d++) {
     
@@ -1255,7 +1171,7 @@ int find_ran_intm (int src, int dest) {
     } else {
       // src and dest are in the same dimension "d" + 1
       // ==> thus generate a random destination within
-      _ran_dest += RandomInt(gK - 1) * _dim_size;
+      _ran_dest += f->RandomInt(gK - 1) * _dim_size;
       if (debug) 
 	cout << "    different  dimension : " << d << " int node : " << _ran_dest << " _dim_size: " << _dim_size << endl;
     }
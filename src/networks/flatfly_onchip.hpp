@@ -55,7 +55,7 @@ class FlatFlyOnChip : public Network {
   int _InChannel( int stage, int addr, int port ) const;
 
 public:
-  FlatFlyOnChip( const Configuration &config, const string & name );
+  FlatFlyOnChip( const Configuration &config, const string & name, SimulationContext * context );
 
   int GetN( ) const;
   int GetK( ) const;
@@ -80,7 +80,7 @@ void valiant_flatfly( const Router *r, const Flit *f, int in_channel,
 			  OutputSet *outputs, bool inject );
 
 int find_distance (int src, int dest);
-int find_ran_intm (int src, int dest);
+int find_ran_intm (const Flit * f, int src, int dest);
 int flatfly_outport(int dest, int rID);
 int flatfly_transformation(int dest);
 int flatfly_outport_yx(int dest, int rID);
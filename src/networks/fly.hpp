@@ -42,7 +42,7 @@ class KNFly : public Network {
   int _InChannel( int stage, int addr, int port ) const;
  
 public:
-  KNFly( const Configuration &config, const string & name );
+  KNFly( const Configuration &config, const string & name, SimulationContext * context );
 
   int GetN( ) const;
   int GetK( ) const;
@@ -40,8 +40,8 @@
  //#include "iq_router.hpp"
 
 
-KNCube::KNCube( const Configuration &config, const string & name, bool mesh ) :
-Network( config, name )
+KNCube::KNCube( const Configuration &config, const string & name, bool mesh, SimulationContext * context ) :
+Network( config, name, context )
 {
   _mesh = mesh;
 
@@ -32,11 +32,14 @@
  *
  */
 
+#include <algorithm>
 #include <cassert>
 #include <sstream>
 
 #include "booksim.hpp"
 #include "network.hpp"
+#include "random_utils.hpp"
+#include "checkpoint.hpp"
 
 #include "kncube.hpp"
 #include "fly.hpp"
@@ -49,17 +52,29 @@
 #include "dragonfly.hpp"
 
 
-Network::Network( const Configuration &config, const string & name ) :
-  TimedModule( 0, name )
+Network::Network( const Configuration &config, const string & name, SimulationContext * context ) :
+  TimedModule( context, name )
 {
   _size     = -1; 
   _nodes    = -1; 
   _channels = -1;
   _classes  = config.GetInt("classes");
+
+  _threads  = config.GetInt("network_threads");
+  if ( _threads < 1 ) {
+    Error( "network_threads must be at least 1." );
+  }
+  // watch output has to appear in simulation order, so keep watched runs
+  // on a single thread
+  if ( gWatchOut ) {
+    _threads = 1;
+  }
+  _pool = NULL;
 }
 
 Network::~Network( )
 {
+  if ( _pool ) delete _pool;
   for ( int r = 0; r < _size; ++r ) {
     if ( _routers[r] ) delete _routers[r];
   }
@@ -77,40 +92,41 @@ Network::~Network( )
   }
 }
 
-Network * Network::New(const Configuration & config, const string & name)
+Network * Network::New(const Configuration & config, const string & name,
+			SimulationContext * context)
 {
   const string topo = config.GetStr( "topology" );
   Network * n = NULL;
   if ( topo == "torus" ) {
     KNCube::RegisterRoutingFunctions() ;
-    n = new KNCube( config, name, false );
+    n = new KNCube( config, name, false, context );
   } else if ( topo == "mesh" ) {
     KNCube::RegisterRoutingFunctions() ;
-    n = new KNCube( config, name, true );
+    n = new KNCube( config, name, true, context );
   } else if ( topo == "cmesh" ) {
     CMesh::RegisterRoutingFunctions() ;
-    n = new CMesh( config, name );
+    n = new CMesh( config, name, context );
   } else if ( topo == "fly" ) {
     KNFly::RegisterRoutingFunctions() ;
-    n = new KNFly( config, name );
+    n = new KNFly( config, name, context );
   } else if ( topo == "qtree" ) {
     QTree::RegisterRoutingFunctions() ;
-    n = new QTree( config, name );
+    n = new QTree( config, name, context );
   } else if ( topo == "tree4" ) {
     Tree4::RegisterRoutingFunctions() ;
-    n = new Tree4( config, name );
+    n = new Tree4( config, name, context );
   } else if ( topo == "fattree" ) {
     FatTree::RegisterRoutingFunctions() ;
-    n = new FatTree( config, name );
+    n = new FatTree( config, name, context );
   } else if ( topo == "flatfly" ) {
     FlatFlyOnChip::RegisterRoutingFunctions() ;
-    n = new FlatFlyOnChip( config, name );
+    n = new FlatFlyOnChip( config, name, context );
   } else if ( topo == "anynet"){
     AnyNet::RegisterRoutingFunctions() ;
-    n = new AnyNet(config, name);
+    n = new AnyNet(config, name, context);
   } else if ( topo == "dragonflynew"){
     DragonFlyNew::RegisterRoutingFunctions() ;
-    n = new DragonFlyNew(config, name);
+    n = new DragonFlyNew(config, name, context);
   } else {
     cerr << "Unknown topology: " << topo << endl;
   }
@@ -121,6 +137,9 @@ Network * Network::New(const Configuration & config, const string & name)
   if ( n && ( config.GetInt( "link_failures" ) > 0 ) ) {
     n->InsertRandomFaults( config );
   }
+  if ( n ) {
+    context->SetTopology( n );
+  }
   return n;
 }
 
@@ -179,30 +198,193 @@ void Network::_Alloc( )
   }
 }
 
-void Network::ReadInputs( )
+void Network::_Schedule( )
+{
+  _modules.assign(_timed_modules.begin(), _timed_modules.end());
+
+  if(_threads > 1) {
+    _Partition( );
+    if(_pool) {
+      return;
+    }
+  }
+
+  // every module starts out active and drops out once it reports being idle
+  int const n = _modules.size();
+  _active_set.assign((n + 63) / 64, ~0ULL);
+  if(n % 64) {
+    _active_set.back() = (1ULL << (n % 64)) - 1;
+  }
+  _wake_set.assign(_active_set.size(), 0ULL);
+  for(int i = 0; i < n; ++i) {
+    _modules[i]->SetActiveBit(&_wake_set[i / 64], i % 64);
+  }
+
+  // channel deliveries are driven by the timing wheel, so channels only need
+  // to be visited in the cycle after something was sent on them; watched
+  // runs keep the per-channel sweep so that messages stay in module order
+  if(gWatchOut) {
+    return;
+  }
+  vector<Channel<Flit> *> flit_channels;
+  flit_channels.insert(flit_channels.end(), _inject.begin(), _inject.end());
+  flit_channels.insert(flit_channels.end(), _eject.begin(), _eject.end());
+  flit_channels.insert(flit_channels.end(), _chan.begin(), _chan.end());
+  vector<CreditChannel *> credit_channels;
+  credit_channels.insert(credit_channels.end(),
+			 _inject_cred.begin(), _inject_cred.end());
+  credit_channels.insert(credit_channels.end(),
+			 _eject_cred.begin(), _eject_cred.end());
+  credit_channels.insert(credit_channels.end(),
+			 _chan_cred.begin(), _chan_cred.end());
+  int horizon = 1;
+  for(size_t c = 0; c < flit_channels.size(); ++c) {
+    horizon = max(horizon, flit_channels[c]->GetLatency() - 1);
+    flit_channels[c]->SetTimingWheel(&_wheel);
+  }
+  for(size_t c = 0; c < credit_channels.size(); ++c) {
+    horizon = max(horizon, credit_channels[c]->GetLatency() - 1);
+    credit_channels[c]->SetTimingWheel(&_wheel);
+  }
+  _wheel.SetHorizon(horizon);
+}
+
+void Network::_Partition( )
 {
+  // routers carry nearly all of the per-cycle work, so routers and channels
+  // are spread over the threads separately; each partition receives a
+  // contiguous range of both to keep neighboring modules together
+  vector<TimedModule *> routers;
+  vector<TimedModule *> channels;
   for(deque<TimedModule *>::const_iterator iter = _timed_modules.begin();
       iter != _timed_modules.end();
       ++iter) {
-    (*iter)->ReadInputs( );
+    if(dynamic_cast<Router *>(*iter)) {
+      routers.push_back(*iter);
+    } else {
+      channels.push_back(*iter);
+    }
+  }
+
+  if(_threads > (int)routers.size()) {
+    _threads = routers.size();
+  }
+  if(_threads <= 1) {
+    return;
+  }
+  _partitions.resize(_threads);
+  for(int t = 0; t < _threads; ++t) {
+    int const r_begin = (routers.size() * t) / _threads;
+    int const r_end = (routers.size() * (t + 1)) / _threads;
+    _partitions[t].insert(_partitions[t].end(),
+			  routers.begin() + r_begin, routers.begin() + r_end);
+    int const c_begin = (channels.size() * t) / _threads;
+    int const c_end = (channels.size() * (t + 1)) / _threads;
+    _partitions[t].insert(_partitions[t].end(),
+			  channels.begin() + c_begin, channels.begin() + c_end);
+  }
+
+  _pool = new ThreadPool(_threads);
+}
+
+void Network::PhaseTask::Run( int part )
+{
+  vector<TimedModule *> const & modules = _net->_partitions[part];
+  switch(_phase) {
+  case phaseReadInputs:
+    for(vector<TimedModule *>::const_iterator iter = modules.begin();
+	iter != modules.end();
+	++iter) {
+      (*iter)->ReadInputs( );
+    }
+    break;
+  case phaseEvaluate:
+    for(vector<TimedModule *>::const_iterator iter = modules.begin();
+	iter != modules.end();
+	++iter) {
+      (*iter)->Evaluate( );
+    }
+    break;
+  case phaseWriteOutputs:
+    for(vector<TimedModule *>::const_iterator iter = modules.begin();
+	iter != modules.end();
+	++iter) {
+      (*iter)->WriteOutputs( );
+    }
+    break;
+  }
+}
+
+void Network::_RunPhase( ePhase phase )
+{
+  PhaseTask task(this, phase);
+  // modules in different partitions run in no particular order relative to
+  // each other, so any draw from the shared random number generator would
+  // make the results depend on thread scheduling
+  RandomLock(true);
+  _pool->Run(&task);
+  RandomLock(false);
+}
+
+void Network::ReadInputs( )
+{
+  if(_modules.empty()) {
+    _Schedule( );
+  }
+  if(_pool) {
+    _RunPhase(phaseReadInputs);
+    return;
+  }
+  for(size_t w = 0; w < _active_set.size(); ++w) {
+    unsigned long long bits = _active_set[w];
+    while(bits) {
+      int const b = __builtin_ctzll(bits);
+      bits &= bits - 1;
+      _modules[(w << 6) + b]->ReadInputs( );
+    }
   }
 }
 
 void Network::Evaluate( )
 {
-  for(deque<TimedModule *>::const_iterator iter = _timed_modules.begin();
-      iter != _timed_modules.end();
-      ++iter) {
-    (*iter)->Evaluate( );
+  if(_pool) {
+    _RunPhase(phaseEvaluate);
+    return;
+  }
+  for(size_t w = 0; w < _active_set.size(); ++w) {
+    unsigned long long bits = _active_set[w];
+    while(bits) {
+      int const b = __builtin_ctzll(bits);
+      bits &= bits - 1;
+      _modules[(w << 6) + b]->Evaluate( );
+    }
   }
 }
 
 void Network::WriteOutputs( )
 {
-  for(deque<TimedModule *>::const_iterator iter = _timed_modules.begin();
-      iter != _timed_modules.end();
-      ++iter) {
-    (*iter)->WriteOutputs( );
+  if(_pool) {
+    _RunPhase(phaseWriteOutputs);
+    return;
+  }
+  _wheel.Advance(GetSimTime());
+  for(size_t w = 0; w < _active_set.size(); ++w) {
+    unsigned long long bits = _active_set[w];
+    while(bits) {
+      int const b = __builtin_ctzll(bits);
+      bits &= bits - 1;
+      TimedModule * const m = _modules[(w << 6) + b];
+      m->WriteOutputs( );
+      if(m->IsIdle( )) {
+	_active_set[w] &= ~(1ULL << b);
+      }
+    }
+  }
+  // a module that was woken up during this cycle has work pending for the
+  // next one, even if it looked idle above
+  for(size_t w = 0; w < _active_set.size(); ++w) {
+    _active_set[w] |= _wake_set[w];
+    _wake_set[w] = 0ULL;
   }
 }
 
@@ -250,6 +432,26 @@ double Network::Capacity( ) const
  * neceesary of the network, by default, call display on each router
  * and display the channel utilization rate
  */
+void Network::Serialize( Checkpoint & cp )
+{
+  if(_modules.empty()) {
+    _Schedule( );
+  }
+  cp.Check(_modules.size(), "number of network modules");
+  for(size_t i = 0; i < _modules.size(); ++i) {
+    _modules[i]->Serialize(cp);
+  }
+  if(cp.Loading() && !_pool) {
+    // visit everything once; modules without pending work drop out again
+    // at the end of the next cycle
+    int const n = _modules.size();
+    _active_set.assign((n + 63) / 64, ~0ULL);
+    if(n % 64) {
+      _active_set.back() = (1ULL << (n % 64)) - 1;
+    }
+  }
+}
+
 void Network::Display( ostream & os ) const
 {
   for ( int r = 0; r < _size; ++r ) {
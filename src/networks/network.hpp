@@ -41,6 +41,8 @@
 #include "channel.hpp"
 #include "config_utils.hpp"
 #include "globals.hpp"
+#include "thread_pool.hpp"
+#include "timing_wheel.hpp"
 
 typedef Channel<Credit> CreditChannel;
 
@@ -66,16 +68,48 @@ protected:
 
   deque<TimedModule *> _timed_modules;
 
+  // single-threaded evaluation only visits modules with pending work; bit i
+  // of the active set corresponds to _modules[i], so modules are still
+  // called in the order they were added. Wakeups are collected separately
+  // and merged once a cycle is complete.
+  vector<TimedModule *> _modules;
+  vector<unsigned long long> _active_set;
+  vector<unsigned long long> _wake_set;
+
+  // delivers the items in flight on all channels when single-threaded
+  TimingWheel _wheel;
+
+  // parallel evaluation: each thread owns a fixed partition of the routers
+  // and channels, and the three phases are separated by barriers
+  int _threads;
+  ThreadPool * _pool;
+  vector<vector<TimedModule *> > _partitions;
+
+  enum ePhase { phaseReadInputs, phaseEvaluate, phaseWriteOutputs };
+
+  class PhaseTask : public ThreadPool::Task {
+    Network * _net;
+    ePhase _phase;
+  public:
+    PhaseTask(Network * net, ePhase phase) : _net(net), _phase(phase) {}
+    virtual void Run(int part);
+  };
+
+  void _Schedule( );
+  void _Partition( );
+  void _RunPhase( ePhase phase );
+
   virtual void _ComputeSize( const Configuration &config ) = 0;
   virtual void _BuildNet( const Configuration &config ) = 0;
 
   void _Alloc( );
 
 public:
-  Network( const Configuration &config, const string & name );
+  Network( const Configuration &config, const string & name, SimulationContext * context );
   virtual ~Network( );
 
-  static Network *New( const Configuration &config, const string & name );
+  static Network *New( const Configuration &config, const string & name,
+		       SimulationContext * context );
 
   virtual void WriteFlit( Flit *f, int source );
   virtual Flit *ReadFlit( int dest );
@@ -94,6 +128,8 @@ public:
   virtual void Evaluate( );
   virtual void WriteOutputs( );
 
+  virtual void Serialize( Checkpoint & cp );
+
   void Display( ostream & os = cout ) const;
   void DumpChannelMap( ostream & os = cout, string const & prefix = "" ) const;
   void DumpNodeMap( ostream & os = cout, string const & prefix = "" ) const;
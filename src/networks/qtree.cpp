@@ -45,8 +45,8 @@
 #include "qtree.hpp"
 #include "misc_utils.hpp"
 
-QTree::QTree( const Configuration& config, const string & name )
-: Network ( config, name )
+QTree::QTree( const Configuration& config, const string & name, SimulationContext * context )
+: Network ( config, name, context )
 {
   _ComputeSize( config );
   _Alloc( );
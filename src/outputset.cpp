@@ -34,15 +34,12 @@
  */
 
 #include <cassert>
+#include <cstdlib>
+#include <iostream>
 
 #include "booksim.hpp"
 #include "outputset.hpp"
 
-void OutputSet::Clear( )
-{
-  _outputs.clear( );
-}
-
 void OutputSet::Add( int output_port, int vc, int pri  )
 {
   AddRange( output_port, vc, vc, pri );
@@ -50,22 +47,38 @@ void OutputSet::Add( int output_port, int vc, int pri  )
 
 void OutputSet::AddRange( int output_port, int vc_start, int vc_end, int pri )
 {
+  // keep the elements sorted by decreasing priority
+  int pos = 0;
+  while ( ( pos < _size ) && ( _outputs[pos].pri > pri ) ) {
+    ++pos;
+  }
+  if ( ( pos < _size ) && ( _outputs[pos].pri == pri ) ) {
+    return;
+  }
+  if ( _size >= MAX_ELEMENTS ) {
+    cerr << "Error: Routing function produced more than " << MAX_ELEMENTS
+	 << " output set priorities." << endl;
+    exit(-1);
+  }
+  for ( int i = _size; i > pos; --i ) {
+    _outputs[i] = _outputs[i-1];
+  }
 
-  sSetElement s;
+  sSetElement & s = _outputs[pos];
 
   s.vc_start = vc_start;
   s.vc_end   = vc_end;
   s.pri      = pri;
   s.output_port = output_port;
-  _outputs.insert( s );
+  ++_size;
 }
 
-//legacy support, for performance, just use GetSet()
+//legacy support, for performance, just iterate over the set
 int OutputSet::NumVCs( int output_port ) const
 {
   int total = 0;
-  set<sSetElement>::const_iterator i = _outputs.begin( );
-  while(i!=_outputs.end( )){
+  const_iterator i = begin( );
+  while(i!=end( )){
     if(i->output_port == output_port){
       total += (i->vc_end - i->vc_start + 1);
     }
@@ -76,8 +89,8 @@ int OutputSet::NumVCs( int output_port ) const
 
 bool OutputSet::OutputEmpty( int output_port ) const
 {
-  set<sSetElement>::const_iterator i = _outputs.begin( );
-  while(i!=_outputs.end( )){
+  const_iterator i = begin( );
+  while(i!=end( )){
     if(i->output_port == output_port){
       return false;
     }
@@ -86,12 +99,7 @@ bool OutputSet::OutputEmpty( int output_port ) const
   return true;
 }
 
-
-const set<OutputSet::sSetElement> & OutputSet::GetSet() const{
-  return _outputs;
-}
-
-//legacy support, for performance, just use GetSet()
+//legacy support, for performance, just iterate over the set
 int OutputSet::GetVC( int output_port, int vc_index, int *pri ) const
 {
 
@@ -101,8 +109,8 @@ int OutputSet::GetVC( int output_port, int vc_index, int *pri ) const
   
   if ( pri ) { *pri = -1; }
 
-  set<sSetElement>::const_iterator i = _outputs.begin( );
-  while(i!=_outputs.end( )){
+  const_iterator i = begin( );
+  while(i!=end( )){
     if(i->output_port == output_port){
       range = i->vc_end - i->vc_start + 1;
       if ( remaining >= range ) {
@@ -120,7 +128,7 @@ int OutputSet::GetVC( int output_port, int vc_index, int *pri ) const
   return vc;
 }
 
-//legacy support, for performance, just use GetSet()
+//legacy support, for performance, just iterate over the set
 bool OutputSet::GetPortVC( int *out_port, int *out_vc ) const
 {
 
@@ -128,11 +136,11 @@ bool OutputSet::GetPortVC( int *out_port, int *out_vc ) const
   bool single_output = false;
   int  used_outputs  = 0;
 
-  set<sSetElement>::const_iterator i = _outputs.begin( );
-  if(i!=_outputs.end( )){
+  const_iterator i = begin( );
+  if(i!=end( )){
     used_outputs = i->output_port;
   }
-  while(i!=_outputs.end( )){
+  while(i!=end( )){
 
     if ( i->vc_start == i->vc_end ) {
       *out_vc   = i->vc_start;
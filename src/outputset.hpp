@@ -28,8 +28,6 @@
 #ifndef _OUTPUTSET_HPP_
 #define _OUTPUTSET_HPP_
 
-#include <set>
-
 class OutputSet {
 
 
@@ -41,26 +39,34 @@ public:
     int output_port;
   };
 
-  void Clear( );
+  // routing functions use only a few distinct priorities
+  static const int MAX_ELEMENTS = 4;
+
+  typedef sSetElement const * const_iterator;
+
+  OutputSet( ) : _size(0) {}
+
+  inline void Clear( ) { _size = 0; }
   void Add( int output_port, int vc, int pri = 0 );
   void AddRange( int output_port, int vc_start, int vc_end, int pri = 0 );
 
   bool OutputEmpty( int output_port ) const;
   int NumVCs( int output_port ) const;
   
-  const set<sSetElement> & GetSet() const;
+  // elements in order of decreasing priority; of several elements with the
+  // same priority, only the first one added is kept
+  inline const_iterator begin( ) const { return _outputs; }
+  inline const_iterator end( ) const { return _outputs + _size; }
+  inline int size( ) const { return _size; }
+  inline bool empty( ) const { return !_size; }
 
   int  GetVC( int output_port,  int vc_index, int *pri = 0 ) const;
   bool GetPortVC( int *out_port, int *out_vc ) const;
 private:
-  set<sSetElement> _outputs;
+  int _size;
+  sSetElement _outputs[MAX_ELEMENTS];
 };
 
-inline bool operator<(const OutputSet::sSetElement & se1, 
-	       const OutputSet::sSetElement & se2) {
-  return se1.pri > se2.pri; // higher priorities first!
-}
-
 #endif
 
 
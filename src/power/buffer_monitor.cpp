@@ -28,6 +28,7 @@
 #include "buffer_monitor.hpp"
 
 #include "flit.hpp"
+#include "checkpoint.hpp"
 
 BufferMonitor::BufferMonitor( int inputs, int classes ) 
 : _cycles(0), _inputs(inputs), _classes(classes) {
@@ -65,6 +66,12 @@ void BufferMonitor::display(ostream & os) const {
   }
 }
 
+void BufferMonitor::Serialize( Checkpoint & cp ) {
+  cp.Sync( _cycles ) ;
+  cp.Sync( _reads ) ;
+  cp.Sync( _writes ) ;
+}
+
 ostream & operator<<( ostream & os, BufferMonitor const & obj ) {
   obj.display(os);
   return os ;
@@ -28,6 +28,7 @@
 #include "switch_monitor.hpp"
 
 #include "flit.hpp"
+#include "checkpoint.hpp"
 
 SwitchMonitor::SwitchMonitor( int inputs, int outputs, int classes )
 : _cycles(0), _inputs(inputs), _outputs(outputs), _classes(classes) {
@@ -61,6 +62,11 @@ void SwitchMonitor::display(ostream & os) const {
   }
 }
 
+void SwitchMonitor::Serialize( Checkpoint & cp ) {
+  cp.Sync( _cycles ) ;
+  cp.Sync( _event ) ;
+}
+
 ostream & operator<<( ostream & os, SwitchMonitor const & obj ) {
   obj.display(os);
   return os ;
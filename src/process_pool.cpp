@@ -0,0 +1,171 @@
+// $Id$
+
+/*
+ Copyright (c) 2007-2012, Trustees of The Leland Stanford Junior University
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ Redistributions of source code must retain the above copyright notice, this 
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice, this
+ list of conditions and the following disclaimer in the documentation and/or
+ other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE 
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*process_pool.cpp
+ *
+ *Runs jobs in forked child processes
+ *
+ */
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <iostream>
+#include <cstdlib>
+#include <cassert>
+
+#include "process_pool.hpp"
+
+ProcessPool::ProcessPool( vector<string> const & titles, int jobs )
+  : _titles(titles), _jobs(jobs), _job(-1), _started(0), _printed(0),
+    _running(0)
+{
+  if(_jobs <= 0) {
+    _jobs = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if(_jobs <= 0) {
+      _jobs = 1;
+    }
+  }
+
+  int const count = _titles.size();
+  _pids.resize(count, -1);
+  _logs.resize(count, NULL);
+  _pipes.resize(count, -1);
+  _finished.resize(count, false);
+  _results.resize(count);
+}
+
+int ProcessPool::Fork( )
+{
+  int const count = _titles.size();
+
+  while(_printed < count) {
+
+    while((_running < _jobs) && (_started < count)) {
+
+      int const j = _started++;
+
+      _logs[j] = tmpfile();
+      int fds[2];
+      if(!_logs[j] || (pipe(fds) < 0)) {
+	cerr << "Error: Unable to set up " << _titles[j] << endl;
+	exit(-1);
+      }
+
+      // don't let the children inherit (and repeat) buffered output
+      cout.flush();
+      fflush(stdout);
+
+      pid_t const pid = fork();
+      if(pid < 0) {
+	cerr << "Error: Unable to fork " << _titles[j] << endl;
+	exit(-1);
+      }
+
+      if(pid == 0) {
+	close(fds[0]);
+	dup2(fileno(_logs[j]), STDOUT_FILENO);
+	_pipes[j] = fds[1];
+	_job = j;
+	return j;
+      }
+
+      close(fds[1]);
+      _pids[j] = pid;
+      _pipes[j] = fds[0];
+      ++_running;
+    }
+
+    _Collect();
+  }
+
+  return -1;
+}
+
+void ProcessPool::_Collect( )
+{
+  int const count = _titles.size();
+
+  int status;
+  pid_t const pid = wait(&status);
+  if(pid < 0) {
+    cerr << "Error: Lost track of child processes" << endl;
+    exit(-1);
+  }
+  int j = 0;
+  while((j < _started) && (_pids[j] != pid)) {
+    ++j;
+  }
+  if(j == _started) {
+    return;
+  }
+  --_running;
+  _finished[j] = true;
+
+  string data;
+  char buffer[4096];
+  ssize_t n;
+  while((n = read(_pipes[j], buffer, sizeof(buffer))) > 0) {
+    data.append(buffer, n);
+  }
+  close(_pipes[j]);
+
+  if(WIFEXITED(status) && (WEXITSTATUS(status) == 0)) {
+    _results[j] = data;
+  }
+
+  // print the logs of all jobs finished so far, in order
+  while((_printed < count) && _finished[_printed]) {
+    cout << "====== " << _titles[_printed] << " ======" << endl;
+    rewind(_logs[_printed]);
+    while((n = fread(buffer, 1, sizeof(buffer), _logs[_printed])) > 0) {
+      cout.write(buffer, n);
+    }
+    fclose(_logs[_printed]);
+    ++_printed;
+  }
+}
+
+void ProcessPool::Report( string const & results )
+{
+  assert(_job >= 0);
+
+  size_t written = 0;
+  while(written < results.size()) {
+    ssize_t const n = write(_pipes[_job], results.c_str() + written,
+			    results.size() - written);
+    if(n <= 0) {
+      break;
+    }
+    written += n;
+  }
+  close(_pipes[_job]);
+
+  cout.flush();
+  fflush(NULL);
+  _exit(0);
+}
@@ -0,0 +1,95 @@
+// $Id$
+
+/*
+ Copyright (c) 2007-2012, Trustees of The Leland Stanford Junior University
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ Redistributions of source code must retain the above copyright notice, this 
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice, this
+ list of conditions and the following disclaimer in the documentation and/or
+ other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE 
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*process_pool.hpp
+ *
+ *Runs a number of jobs in forked child processes, a limited number at a
+ *time. Each child inherits the complete simulator state of the parent,
+ *writes its log to a temporary file and passes a result string back to
+ *the parent through a pipe. The logs are printed in job order as soon as
+ *all earlier jobs have finished.
+ *
+ */
+
+#ifndef _PROCESS_POOL_HPP_
+#define _PROCESS_POOL_HPP_
+
+#include <sys/types.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+class ProcessPool {
+
+public:
+
+  // the title of each job is printed above its log; jobs <= 0 runs one job
+  // per available processor at a time
+  ProcessPool( vector<string> const & titles, int jobs );
+
+  // index of the job run by this process, -1 in the parent
+  inline int Job( ) const {
+    return _job;
+  }
+
+  // run all jobs; returns the index of the job to run in each child process,
+  // and -1 in the parent once all jobs have finished
+  int Fork( );
+
+  // pass the results of a job to the parent and end the child process
+  void Report( string const & results );
+
+  // results reported by a job, empty if it ended without reporting
+  inline string const & Results( int job ) const {
+    return _results[job];
+  }
+
+private:
+
+  vector<string> _titles;
+  int _jobs;
+
+  int _job;
+
+  vector<pid_t> _pids;
+  vector<FILE *> _logs;
+  vector<int> _pipes;
+  vector<bool> _finished;
+  vector<string> _results;
+
+  int _started;
+  int _printed;
+  int _running;
+
+  void _Collect( );
+
+};
+
+#endif
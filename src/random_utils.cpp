@@ -27,12 +27,23 @@
 
 #include "random_utils.hpp"
 #include <algorithm>
+#include <iostream>
+#include <cstdlib>
 #include <cassert>
 
 extern long ran_x[];
 extern double ran_u[];
 #define KK 100
 
+int gRandomLocked = 0;
+
+void RandomLockViolation( ) {
+  std::cerr << "Error: Random number drawn during parallel network evaluation; "
+	    << "this configuration requires network_threads = 1 and "
+	    << "parallel_subnets = 0." << std::endl;
+  exit(-1);
+}
+
 void SaveRandomState( std::vector<long> & save_x, std::vector<double> & save_u ) {
   save_x.assign(ran_x, ran_x + KK);
   save_u.assign(ran_u, ran_u + KK);
@@ -44,3 +55,43 @@ void RestoreRandomState( std::vector<long> const & save_x, std::vector<double> c
   assert(save_u.size() == KK);
   std::copy(save_u.begin(), save_u.end(), ran_u);
 }
+
+static long gRandomStreamSeed = 0;
+
+void RandomStreamSeed( long seed ) {
+  gRandomStreamSeed = seed;
+}
+
+long RandomStreamGetSeed( ) {
+  return gRandomStreamSeed;
+}
+
+static inline void PhiloxRound( unsigned int ctr[4], unsigned int const key[2] ) {
+  unsigned long long const p0 = 0xD2511F53ULL * ctr[0];
+  unsigned long long const p1 = 0xCD9E8D57ULL * ctr[2];
+  unsigned int const hi0 = (unsigned int)( p0 >> 32 );
+  unsigned int const lo0 = (unsigned int)p0;
+  unsigned int const hi1 = (unsigned int)( p1 >> 32 );
+  unsigned int const lo1 = (unsigned int)p1;
+  ctr[0] = hi1 ^ ctr[1] ^ key[0];
+  ctr[1] = lo1;
+  ctr[2] = hi0 ^ ctr[3] ^ key[1];
+  ctr[3] = lo0;
+}
+
+unsigned long long RandomBits( int component, int index, int sub, 
+			       unsigned long long counter ) {
+  unsigned long long const seed = (unsigned long long)gRandomStreamSeed;
+  unsigned int key[2] = { (unsigned int)seed, 
+			  (unsigned int)( seed >> 32 ) ^ (unsigned int)component };
+  unsigned int ctr[4] = { (unsigned int)counter, (unsigned int)( counter >> 32 ),
+			  (unsigned int)index, (unsigned int)sub };
+  for ( int round = 0; round < 10; ++round ) {
+    if ( round > 0 ) {
+      key[0] += 0x9E3779B9U;
+      key[1] += 0xBB67AE85U;
+    }
+    PhiloxRound( ctr, key );
+  }
+  return ( (unsigned long long)ctr[1] << 32 ) | ctr[0];
+}
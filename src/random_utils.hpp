@@ -31,11 +31,20 @@
 #include <vector>
 
 // interface to Knuth's RANARRAY RNG
+extern int gRandomLocked;
+void   RandomLockViolation( );
 void   ran_start(long seed);
 long   ran_next( );
 void   ranf_start(long seed);
 double ranf_next( );
 
+// complete state of both generators, including numbers that were generated
+// but not drawn yet (used for checkpoints)
+void   ran_get_state(std::vector<long> & state);
+void   ran_set_state(std::vector<long> const & state);
+void   ranf_get_state(std::vector<double> & state);
+void   ranf_set_state(std::vector<double> const & state);
+
 inline void RandomSeed( long seed ) {
   ran_start( seed );
   ranf_start( seed );
@@ -60,6 +69,54 @@ inline double RandomFloat( double max ) {
   return ( ranf_next( ) * max );
 }
 
+// Forbids use of the generator while modules are evaluated concurrently;
+// locks nest, so concurrently running owners can each take one
+inline void RandomLock( bool lock ) {
+  __sync_fetch_and_add(&gRandomLocked, lock ? 1 : -1);
+}
+
+// Counter-based random number streams (Philox4x32-10, Salmon et al., SC'11).
+// A stream is keyed by the seed set with RandomStreamSeed(), the component 
+// that draws from it and two indices within that component (e.g. node and 
+// class). Its n-th number depends only on the key and n, so every stream is 
+// independent of all others and of the order in which they are drawn from, 
+// and blocks of numbers can be generated independently of each other.
+
+enum eRandomComponent { random_injection = 1,  // injection processes
+			random_traffic,        // traffic patterns
+			random_packet,         // packet type, size and subnet
+			random_routing,        // routing decisions, per flit
+			random_flow };         // flow file jitter
+
+void RandomStreamSeed( long seed );
+long RandomStreamGetSeed( );
+
+// the 64 random bits at the given position of a stream
+unsigned long long RandomBits( int component, int index, int sub, 
+			       unsigned long long counter );
+
+class RandomStream {
+  int _component;
+  int _index;
+  int _sub;
+  unsigned long long _counter;
+public:
+  RandomStream( int component = 0, int index = 0, int sub = 0 )
+    : _component( component ), _index( index ), _sub( sub ), _counter( 0 ) { }
+
+  inline unsigned long long Bits( ) {
+    return RandomBits( _component, _index, _sub, _counter++ );
+  }
+  // Returns a random integer in the range [0,max]
+  inline int Int( int max ) {
+    return (int)( Bits( ) % (unsigned long long)( max + 1 ) );
+  }
+  // Returns a random floating-point value in the range [0,1)
+  inline double Float( ) {
+    return (double)( Bits( ) >> 11 ) * ( 1.0 / 9007199254740992.0 );
+  }
+};
+
 // Saves the current generator state
 void SaveRandomState( std::vector<long> & save_x, std::vector<double> & save_u );
 
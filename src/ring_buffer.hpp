@@ -0,0 +1,188 @@
+// $Id$
+
+/*
+ Copyright (c) 2007-2012, Trustees of The Leland Stanford Junior University
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ Redistributions of source code must retain the above copyright notice, this 
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice, this
+ list of conditions and the following disclaimer in the documentation and/or
+ other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE 
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*ring_buffer.hpp
+ *
+ *A FIFO queue stored in a single power-of-two sized array. Elements are
+ *addressed by masking a running head index, so pushing and popping never
+ *allocate once the buffer has been sized for the largest occupancy the
+ *owner expects; if that estimate is exceeded, the buffer doubles in size.
+ *
+ *The array is either owned by the buffer or attached from outside, which
+ *lets a router keep the queues of all its ports in one contiguous block.
+ *An attached buffer that overflows moves its contents to its own array.
+ *
+ *Iterators walk the queue from front to back and stay valid as long as no
+ *element is pushed.
+ *
+ */
+
+#ifndef _RING_BUFFER_HPP_
+#define _RING_BUFFER_HPP_
+
+#include <cassert>
+#include <vector>
+
+using namespace std;
+
+template<class T>
+class RingBuffer {
+
+  T * _items;
+  vector<T> _storage;
+  size_t _mask;
+  size_t _head;
+  size_t _size;
+
+  void _Resize( size_t capacity ) {
+    vector<T> storage( RoundCapacity( capacity ) );
+    for ( size_t i = 0; i < _size; ++i ) {
+      storage[i] = (*this)[i];
+    }
+    _storage.swap( storage );
+    _items = &_storage[0];
+    _mask = _storage.size( ) - 1;
+    _head = 0;
+  }
+
+  void _Copy( RingBuffer const & buffer ) {
+    _size = 0;
+    _Resize( buffer._mask + 1 );
+    for ( size_t i = 0; i < buffer._size; ++i ) {
+      _items[i] = buffer[i];
+    }
+    _size = buffer._size;
+  }
+
+public:
+
+  class iterator {
+    RingBuffer * _buffer;
+    size_t _index;
+  public:
+    iterator( RingBuffer * buffer, size_t index )
+      : _buffer(buffer), _index(index) {}
+    inline T & operator*( ) const { return (*_buffer)[_index]; }
+    inline T * operator->( ) const { return &(*_buffer)[_index]; }
+    inline iterator & operator++( ) { ++_index; return *this; }
+    inline bool operator==( iterator const & iter ) const {
+      return _index == iter._index;
+    }
+    inline bool operator!=( iterator const & iter ) const {
+      return _index != iter._index;
+    }
+  };
+
+  // smallest capacity a buffer holding the given number of elements uses
+  static size_t RoundCapacity( size_t size ) {
+    size_t capacity = 1;
+    while ( capacity < size ) {
+      capacity <<= 1;
+    }
+    return capacity;
+  }
+
+  RingBuffer( size_t capacity = 1 ) : _items(0), _mask(0), _head(0), _size(0) {
+    _Resize( capacity );
+  }
+  RingBuffer( RingBuffer const & buffer )
+    : _items(0), _mask(0), _head(0), _size(0) {
+    _Copy( buffer );
+  }
+  RingBuffer & operator=( RingBuffer const & buffer ) {
+    if ( this != &buffer ) {
+      _Copy( buffer );
+    }
+    return *this;
+  }
+
+  // make room for at least the given number of elements
+  void Reserve( size_t capacity ) {
+    if ( capacity > _mask + 1 ) {
+      _Resize( capacity );
+    }
+  }
+
+  // use the given array of RoundCapacity() elements, which must outlive
+  // the buffer, instead of an owned one
+  void Attach( T * storage, size_t capacity ) {
+    assert( _size == 0 );
+    assert( capacity == RoundCapacity( capacity ) );
+    _items = storage;
+    vector<T>( ).swap( _storage );
+    _mask = capacity - 1;
+    _head = 0;
+  }
+
+  inline size_t capacity( ) const { return _mask + 1; }
+  inline size_t size( ) const { return _size; }
+  inline bool empty( ) const { return _size == 0; }
+  inline bool full( ) const { return _size > _mask; }
+
+  inline T & operator[]( size_t i ) {
+    assert( i < _size );
+    return _items[( _head + i ) & _mask];
+  }
+  inline T const & operator[]( size_t i ) const {
+    assert( i < _size );
+    return _items[( _head + i ) & _mask];
+  }
+
+  inline T & front( ) {
+    assert( _size > 0 );
+    return _items[_head];
+  }
+  inline T const & front( ) const {
+    assert( _size > 0 );
+    return _items[_head];
+  }
+  inline T & back( ) { return (*this)[_size - 1]; }
+  inline T const & back( ) const { return (*this)[_size - 1]; }
+
+  inline iterator begin( ) { return iterator( this, 0 ); }
+  inline iterator end( ) { return iterator( this, _size ); }
+
+  inline void push_back( T const & item ) {
+    if ( _size > _mask ) {
+      _Resize( 2 * ( _mask + 1 ) );
+    }
+    _items[( _head + _size ) & _mask] = item;
+    ++_size;
+  }
+  inline void pop_front( ) {
+    assert( _size > 0 );
+    _head = ( _head + 1 ) & _mask;
+    --_size;
+  }
+  inline void clear( ) {
+    _head = 0;
+    _size = 0;
+  }
+
+};
+
+#endif
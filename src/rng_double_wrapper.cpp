@@ -25,10 +25,48 @@
  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
+#include <algorithm>
+#include <cassert>
+
+#include "random_utils.hpp"
+
 #define main rng_double_main
 #include "rng-double.c"
 
 double ranf_next( )
 {
+  if(gRandomLocked) {
+    RandomLockViolation( );
+  }
   return ranf_arr_next( );
 }
+
+void ranf_get_state(std::vector<double> & state)
+{
+  // generator state, followed by the generated numbers that were not drawn
+  // yet and the position of the next one
+  state.assign(ran_u, ran_u + KK);
+  state.insert(state.end(), ranf_arr_buf, ranf_arr_buf + QUALITY);
+  if(ranf_arr_ptr == &ranf_arr_dummy) {
+    state.push_back(-1);
+  } else if(ranf_arr_ptr == &ranf_arr_started) {
+    state.push_back(-2);
+  } else {
+    state.push_back(ranf_arr_ptr - ranf_arr_buf);
+  }
+}
+
+void ranf_set_state(std::vector<double> const & state)
+{
+  assert(state.size() == KK + QUALITY + 1);
+  std::copy(state.begin(), state.begin() + KK, ran_u);
+  std::copy(state.begin() + KK, state.begin() + KK + QUALITY, ranf_arr_buf);
+  long const pos = (long)state.back();
+  if(pos == -1) {
+    ranf_arr_ptr = &ranf_arr_dummy;
+  } else if(pos == -2) {
+    ranf_arr_ptr = &ranf_arr_started;
+  } else {
+    ranf_arr_ptr = ranf_arr_buf + pos;
+  }
+}
@@ -25,10 +25,48 @@
  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
+#include <algorithm>
+#include <cassert>
+
+#include "random_utils.hpp"
+
 #define main rng_main
 #include "rng.c"
 
 long ran_next( )
 {
+  if(gRandomLocked) {
+    RandomLockViolation( );
+  }
   return ran_arr_next( );
 }
+
+void ran_get_state(std::vector<long> & state)
+{
+  // generator state, followed by the generated numbers that were not drawn
+  // yet and the position of the next one
+  state.assign(ran_x, ran_x + KK);
+  state.insert(state.end(), ran_arr_buf, ran_arr_buf + QUALITY);
+  if(ran_arr_ptr == &ran_arr_dummy) {
+    state.push_back(-1);
+  } else if(ran_arr_ptr == &ran_arr_started) {
+    state.push_back(-2);
+  } else {
+    state.push_back(ran_arr_ptr - ran_arr_buf);
+  }
+}
+
+void ran_set_state(std::vector<long> const & state)
+{
+  assert(state.size() == KK + QUALITY + 1);
+  std::copy(state.begin(), state.begin() + KK, ran_x);
+  std::copy(state.begin() + KK, state.begin() + KK + QUALITY, ran_arr_buf);
+  long const pos = (long)state.back();
+  if(pos == -1) {
+    ran_arr_ptr = &ran_arr_dummy;
+  } else if(pos == -2) {
+    ran_arr_ptr = &ran_arr_started;
+  } else {
+    ran_arr_ptr = ran_arr_buf + pos;
+  }
+}
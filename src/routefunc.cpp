@@ -54,41 +54,18 @@
 
 map<string, tRoutingFunction> gRoutingFunctionMap;
 
-/* Global information used by routing functions */
-
-int gNumVCs;
-
 /* Add more functions here
  *
  */
 
-// ============================================================
-//  Balfour-Schultz
-int gReadReqBeginVC, gReadReqEndVC;
-int gWriteReqBeginVC, gWriteReqEndVC;
-int gReadReplyBeginVC, gReadReplyEndVC;
-int gWriteReplyBeginVC, gWriteReplyEndVC;
-
 // ============================================================
 //  QTree: Nearest Common Ancestor
 // ===
 void qtree_nca( const Router *r, const Flit *f,
 		int in_channel, OutputSet* outputs, bool inject)
 {
-  int vcBegin = 0, vcEnd = gNumVCs-1;
-  if ( f->type == Flit::READ_REQUEST ) {
-    vcBegin = gReadReqBeginVC;
-    vcEnd = gReadReqEndVC;
-  } else if ( f->type == Flit::WRITE_REQUEST ) {
-    vcBegin = gWriteReqBeginVC;
-    vcEnd = gWriteReqEndVC;
-  } else if ( f->type ==  Flit::READ_REPLY ) {
-    vcBegin = gReadReplyBeginVC;
-    vcEnd = gReadReplyEndVC;
-  } else if ( f->type ==  Flit::WRITE_REPLY ) {
-    vcBegin = gWriteReplyBeginVC;
-    vcEnd = gWriteReplyEndVC;
-  }
+  int vcBegin = r->GetContext()->BeginVC(f->type);
+  int vcEnd = r->GetContext()->EndVC(f->type);
   assert(((f->vc >= vcBegin) && (f->vc <= vcEnd)) || (inject && (f->vc < 0)));
 
   int out_port;
@@ -126,20 +103,8 @@ void qtree_nca( const Router *r, const Flit *f,
 void tree4_anca( const Router *r, const Flit *f,
 		 int in_channel, OutputSet* outputs, bool inject)
 {
-  int vcBegin = 0, vcEnd = gNumVCs-1;
-  if ( f->type == Flit::READ_REQUEST ) {
-    vcBegin = gReadReqBeginVC;
-    vcEnd = gReadReqEndVC;
-  } else if ( f->type == Flit::WRITE_REQUEST ) {
-    vcBegin = gWriteReqBeginVC;
-    vcEnd = gWriteReqEndVC;
-  } else if ( f->type ==  Flit::READ_REPLY ) {
-    vcBegin = gReadReplyBeginVC;
-    vcEnd = gReadReplyEndVC;
-  } else if ( f->type ==  Flit::WRITE_REPLY ) {
-    vcBegin = gWriteReplyBeginVC;
-    vcEnd = gWriteReplyEndVC;
-  }
+  int vcBegin = r->GetContext()->BeginVC(f->type);
+  int vcEnd = r->GetContext()->EndVC(f->type);
   assert(((f->vc >= vcBegin) && (f->vc <= vcEnd)) || (inject && (f->vc < 0)));
 
   int range = 1;
@@ -161,7 +126,7 @@ void tree4_anca( const Router *r, const Flit *f,
     
     if ( rH == 0 ) {
       dest /= 16;
-      out_port = 2 * dest + RandomInt(1);
+      out_port = 2 * dest + f->RandomInt(1);
     } else if ( rH == 1 ) {
       dest /= 4;
       if ( dest / 4 == rP / 2 )
@@ -196,20 +161,8 @@ void tree4_anca( const Router *r, const Flit *f,
 void tree4_nca( const Router *r, const Flit *f,
 		int in_channel, OutputSet* outputs, bool inject)
 {
-  int vcBegin = 0, vcEnd = gNumVCs-1;
-  if ( f->type == Flit::READ_REQUEST ) {
-    vcBegin = gReadReqBeginVC;
-    vcEnd = gReadReqEndVC;
-  } else if ( f->type == Flit::WRITE_REQUEST ) {
-    vcBegin = gWriteReqBeginVC;
-    vcEnd = gWriteReqEndVC;
-  } else if ( f->type ==  Flit::READ_REPLY ) {
-    vcBegin = gReadReplyBeginVC;
-    vcEnd = gReadReplyEndVC;
-  } else if ( f->type ==  Flit::WRITE_REPLY ) {
-    vcBegin = gWriteReplyBeginVC;
-    vcEnd = gWriteReplyEndVC;
-  }
+  int vcBegin = r->GetContext()->BeginVC(f->type);
+  int vcEnd = r->GetContext()->EndVC(f->type);
   assert(((f->vc >= vcBegin) && (f->vc <= vcEnd)) || (inject && (f->vc < 0)));
 
   int out_port;
@@ -229,18 +182,18 @@ void tree4_nca( const Router *r, const Flit *f,
     
     if ( rH == 0 ) {
       dest /= 16;
-      out_port = 2 * dest + RandomInt(1);
+      out_port = 2 * dest + f->RandomInt(1);
     } else if ( rH == 1 ) {
       dest /= 4;
       if ( dest / 4 == rP / 2 )
 	out_port = dest % 4;
       else
-	out_port = gK + RandomInt(gK-1);
+	out_port = gK + f->RandomInt(gK-1);
     } else {
       if ( dest/4 == rP )
 	out_port = dest % 4;
       else
-	out_port = gK + RandomInt(1);
+	out_port = gK + f->RandomInt(1);
     }
     
     //  cout << "Router("<<rH<<","<<rP<<"): id= " << f->id << " dest= " << f->dest << " out_port = "
@@ -259,20 +212,8 @@ void tree4_nca( const Router *r, const Flit *f,
 void fattree_nca( const Router *r, const Flit *f,
                int in_channel, OutputSet* outputs, bool inject)
 {
-  int vcBegin = 0, vcEnd = gNumVCs-1;
-  if ( f->type == Flit::READ_REQUEST ) {
-    vcBegin = gReadReqBeginVC;
-    vcEnd = gReadReqEndVC;
-  } else if ( f->type == Flit::WRITE_REQUEST ) {
-    vcBegin = gWriteReqBeginVC;
-    vcEnd = gWriteReqEndVC;
-  } else if ( f->type ==  Flit::READ_REPLY ) {
-    vcBegin = gReadReplyBeginVC;
-    vcEnd = gReadReplyEndVC;
-  } else if ( f->type ==  Flit::WRITE_REPLY ) {
-    vcBegin = gWriteReplyBeginVC;
-    vcEnd = gWriteReplyEndVC;
-  }
+  int vcBegin = r->GetContext()->BeginVC(f->type);
+  int vcEnd = r->GetContext()->EndVC(f->type);
   assert(((f->vc >= vcBegin) && (f->vc <= vcEnd)) || (inject && (f->vc < 0)));
 
   int out_port;
@@ -309,7 +250,7 @@ void fattree_nca( const Router *r, const Flit *f,
     } else {
       //up ports are numbered last
       assert(in_channel<gK);//came from a up channel
-      out_port = gK+RandomInt(gK-1);
+      out_port = gK+f->RandomInt(gK-1);
     }
   }  
   outputs->Clear( );
@@ -324,20 +265,8 @@ void fattree_anca( const Router *r, const Flit *f,
                 int in_channel, OutputSet* outputs, bool inject)
 {
 
-  int vcBegin = 0, vcEnd = gNumVCs-1;
-  if ( f->type == Flit::READ_REQUEST ) {
-    vcBegin = gReadReqBeginVC;
-    vcEnd = gReadReqEndVC;
-  } else if ( f->type == Flit::WRITE_REQUEST ) {
-    vcBegin = gWriteReqBeginVC;
-    vcEnd = gWriteReqEndVC;
-  } else if ( f->type ==  Flit::READ_REPLY ) {
-    vcBegin = gReadReplyBeginVC;
-    vcEnd = gReadReplyEndVC;
-  } else if ( f->type ==  Flit::WRITE_REPLY ) {
-    vcBegin = gWriteReplyBeginVC;
-    vcEnd = gWriteReplyEndVC;
-  }
+  int vcBegin = r->GetContext()->BeginVC(f->type);
+  int vcEnd = r->GetContext()->EndVC(f->type);
   assert(((f->vc >= vcBegin) && (f->vc <= vcEnd)) || (inject && (f->vc < 0)));
 
 
@@ -377,8 +306,8 @@ void fattree_anca( const Router *r, const Flit *f,
       //up ports are numbered last
       assert(in_channel<gK);//came from a up channel
       out_port = gK;
-      int random1 = RandomInt(gK-1); // Chose two ports out of the possible at random, compare loads, choose one.
-      int random2 = RandomInt(gK-1);
+      int random1 = f->RandomInt(gK-1); // Chose two ports out of the possible at random, compare loads, choose one.
+      int random2 = f->RandomInt(gK-1);
       if (r->GetUsedCredit(out_port + random1) > r->GetUsedCredit(out_port + random2)){
 	out_port = out_port + random2;
       }else{
@@ -404,20 +333,8 @@ int dor_next_mesh( int cur, int dest, bool descending = false );
 void adaptive_xy_yx_mesh( const Router *r, const Flit *f, 
 		 int in_channel, OutputSet *outputs, bool inject )
 {
-  int vcBegin = 0, vcEnd = gNumVCs-1;
-  if ( f->type == Flit::READ_REQUEST ) {
-    vcBegin = gReadReqBeginVC;
-    vcEnd = gReadReqEndVC;
-  } else if ( f->type == Flit::WRITE_REQUEST ) {
-    vcBegin = gWriteReqBeginVC;
-    vcEnd = gWriteReqEndVC;
-  } else if ( f->type ==  Flit::READ_REPLY ) {
-    vcBegin = gReadReplyBeginVC;
-    vcEnd = gReadReplyEndVC;
-  } else if ( f->type ==  Flit::WRITE_REPLY ) {
-    vcBegin = gWriteReplyBeginVC;
-    vcEnd = gWriteReplyEndVC;
-  }
+  int vcBegin = r->GetContext()->BeginVC(f->type);
+  int vcEnd = r->GetContext()->EndVC(f->type);
   assert(((f->vc >= vcBegin) && (f->vc <= vcEnd)) || (inject && (f->vc < 0)));
 
   int out_port;
@@ -453,7 +370,7 @@ void adaptive_xy_yx_mesh( const Router *r, const Flit *f,
       } else if(credit_xy < credit_yx) {
 	x_then_y = true;
       } else {
-	x_then_y = (RandomInt(1) > 0);
+	x_then_y = (f->RandomInt(1) > 0);
       }
     }
     
@@ -476,20 +393,8 @@ void adaptive_xy_yx_mesh( const Router *r, const Flit *f,
 void xy_yx_mesh( const Router *r, const Flit *f, 
 		 int in_channel, OutputSet *outputs, bool inject )
 {
-  int vcBegin = 0, vcEnd = gNumVCs-1;
-  if ( f->type == Flit::READ_REQUEST ) {
-    vcBegin = gReadReqBeginVC;
-    vcEnd = gReadReqEndVC;
-  } else if ( f->type == Flit::WRITE_REQUEST ) {
-    vcBegin = gWriteReqBeginVC;
-    vcEnd = gWriteReqEndVC;
-  } else if ( f->type ==  Flit::READ_REPLY ) {
-    vcBegin = gReadReplyBeginVC;
-    vcEnd = gReadReplyEndVC;
-  } else if ( f->type ==  Flit::WRITE_REPLY ) {
-    vcBegin = gWriteReplyBeginVC;
-    vcEnd = gWriteReplyEndVC;
-  }
+  int vcBegin = r->GetContext()->BeginVC(f->type);
+  int vcEnd = r->GetContext()->EndVC(f->type);
   assert(((f->vc >= vcBegin) && (f->vc <= vcEnd)) || (inject && (f->vc < 0)));
 
   int out_port;
@@ -513,7 +418,7 @@ void xy_yx_mesh( const Router *r, const Flit *f,
     //  into the network
     bool x_then_y = ((in_channel < 2*gN) ?
 		     (f->vc < (vcBegin + available_vcs)) :
-		     (RandomInt(1) > 0));
+		     (f->RandomInt(1) > 0));
 
     if(x_then_y) {
       out_port = dor_next_mesh( r->GetID(), f->dest, false );
@@ -570,7 +475,7 @@ int dor_next_mesh( int cur, int dest, bool descending )
 
 //=============================================================
 
-void dor_next_torus( int cur, int dest, int in_port,
+void dor_next_torus( const Flit *f, int cur, int dest, int in_port,
 		     int *out_port, int *partition,
 		     bool balance = false )
 {
@@ -592,7 +497,7 @@ void dor_next_torus( int cur, int dest, int in_port,
       dist2 = gK - 2 * ( ( dest - cur + gK ) % gK );
       
       if ( ( dist2 > 0 ) || 
-	   ( ( dist2 == 0 ) && ( RandomInt( 1 ) ) ) ) {
+	   ( ( dist2 == 0 ) && ( f->RandomInt( 1 ) ) ) ) {
 	*out_port = 2*dim_left;     // Right
 	dir = 0;
       } else {
@@ -614,7 +519,7 @@ void dor_next_torus( int cur, int dest, int in_port,
 		      ( ( dir == 1 ) && ( cur >  (gK-1)/2 ) && ( dest <= (gK-1)/2 ) ) ) {
 	    *partition = 0;
 	  } else {
-	    *partition = RandomInt( 1 ); // use either VC set
+	    *partition = f->RandomInt( 1 ); // use either VC set
 	  }
 	} else {
 	  // Deterministic, fixed dateline between nodes k-1 and 0
@@ -644,24 +549,12 @@ void dim_order_mesh( const Router *r, const Flit *f, int in_channel, OutputSet *
 {
   int out_port = inject ? -1 : dor_next_mesh( r->GetID( ), f->dest );
   
-  int vcBegin = 0, vcEnd = gNumVCs-1;
-  if ( f->type == Flit::READ_REQUEST ) {
-    vcBegin = gReadReqBeginVC;
-    vcEnd = gReadReqEndVC;
-  } else if ( f->type == Flit::WRITE_REQUEST ) {
-    vcBegin = gWriteReqBeginVC;
-    vcEnd = gWriteReqEndVC;
-  } else if ( f->type ==  Flit::READ_REPLY ) {
-    vcBegin = gReadReplyBeginVC;
-    vcEnd = gReadReplyEndVC;
-  } else if ( f->type ==  Flit::WRITE_REPLY ) {
-    vcBegin = gWriteReplyBeginVC;
-    vcEnd = gWriteReplyEndVC;
-  }
+  int vcBegin = r->GetContext()->BeginVC(f->type);
+  int vcEnd = r->GetContext()->EndVC(f->type);
   assert(((f->vc >= vcBegin) && (f->vc <= vcEnd)) || (inject && (f->vc < 0)));
 
   if ( !inject && f->watch ) {
-    *gWatchOut << GetSimTime() << " | " << r->FullName() << " | "
+    *gWatchOut << r->GetSimTime() << " | " << r->FullName() << " | "
 	       << "Adding VC range [" 
 	       << vcBegin << "," 
 	       << vcEnd << "]"
@@ -683,20 +576,8 @@ void dim_order_ni_mesh( const Router *r, const Flit *f, int in_channel, OutputSe
 {
   int out_port = inject ? -1 : dor_next_mesh( r->GetID( ), f->dest );
   
-  int vcBegin = 0, vcEnd = gNumVCs-1;
-  if ( f->type == Flit::READ_REQUEST ) {
-    vcBegin = gReadReqBeginVC;
-    vcEnd = gReadReqEndVC;
-  } else if ( f->type == Flit::WRITE_REQUEST ) {
-    vcBegin = gWriteReqBeginVC;
-    vcEnd = gWriteReqEndVC;
-  } else if ( f->type ==  Flit::READ_REPLY ) {
-    vcBegin = gReadReplyBeginVC;
-    vcEnd = gReadReplyEndVC;
-  } else if ( f->type ==  Flit::WRITE_REPLY ) {
-    vcBegin = gWriteReplyBeginVC;
-    vcEnd = gWriteReplyEndVC;
-  }
+  int vcBegin = r->GetContext()->BeginVC(f->type);
+  int vcEnd = r->GetContext()->EndVC(f->type);
   assert(((f->vc >= vcBegin) && (f->vc <= vcEnd)) || (inject && (f->vc < 0)));
 
   // at the destination router, we don't need to separate VCs by destination
@@ -711,7 +592,7 @@ void dim_order_ni_mesh( const Router *r, const Flit *f, int in_channel, OutputSe
   }
   
   if( !inject && f->watch ) {
-    *gWatchOut << GetSimTime() << " | " << r->FullName() << " | "
+    *gWatchOut << r->GetSimTime() << " | " << r->FullName() << " | "
 	       << "Adding VC range [" 
 	       << vcBegin << "," 
 	       << vcEnd << "]"
@@ -733,20 +614,8 @@ void dim_order_pni_mesh( const Router *r, const Flit *f, int in_channel, OutputS
 {
   int out_port = inject ? -1 : dor_next_mesh( r->GetID(), f->dest );
   
-  int vcBegin = 0, vcEnd = gNumVCs-1;
-  if ( f->type == Flit::READ_REQUEST ) {
-    vcBegin = gReadReqBeginVC;
-    vcEnd = gReadReqEndVC;
-  } else if ( f->type == Flit::WRITE_REQUEST ) {
-    vcBegin = gWriteReqBeginVC;
-    vcEnd = gWriteReqEndVC;
-  } else if ( f->type ==  Flit::READ_REPLY ) {
-    vcBegin = gReadReplyBeginVC;
-    vcEnd = gReadReplyEndVC;
-  } else if ( f->type ==  Flit::WRITE_REPLY ) {
-    vcBegin = gWriteReplyBeginVC;
-    vcEnd = gWriteReplyEndVC;
-  }
+  int vcBegin = r->GetContext()->BeginVC(f->type);
+  int vcEnd = r->GetContext()->EndVC(f->type);
   assert(((f->vc >= vcBegin) && (f->vc <= vcEnd)) || (inject && (f->vc < 0)));
 
   if(inject || (r->GetID() != f->dest)) {
@@ -766,7 +635,7 @@ void dim_order_pni_mesh( const Router *r, const Flit *f, int in_channel, OutputS
   }
 
   if( !inject && f->watch ) {
-    *gWatchOut << GetSimTime() << " | " << r->FullName() << " | "
+    *gWatchOut << r->GetSimTime() << " | " << r->FullName() << " | "
 	       << "Adding VC range [" 
 	       << vcBegin << "," 
 	       << vcEnd << "]"
@@ -786,7 +655,7 @@ void dim_order_pni_mesh( const Router *r, const Flit *f, int in_channel, OutputS
 
 // Random intermediate in the minimal quadrant defined
 // by the source and destination
-int rand_min_intr_mesh( int src, int dest )
+int rand_min_intr_mesh( const Flit *f, int src, int dest )
 {
   int dist;
 
@@ -797,9 +666,9 @@ int rand_min_intr_mesh( int src, int dest )
     dist = ( dest % gK ) - ( src % gK );
 
     if ( dist > 0 ) {
-      intm += offset * ( ( src % gK ) + RandomInt( dist ) );
+      intm += offset * ( ( src % gK ) + f->RandomInt( dist ) );
     } else {
-      intm += offset * ( ( dest % gK ) + RandomInt( -dist ) );
+      intm += offset * ( ( dest % gK ) + f->RandomInt( -dist ) );
     }
 
     offset *= gK;
@@ -813,20 +682,8 @@ int rand_min_intr_mesh( int src, int dest )
 
 void romm_mesh( const Router *r, const Flit *f, int in_channel, OutputSet *outputs, bool inject )
 {
-  int vcBegin = 0, vcEnd = gNumVCs-1;
-  if ( f->type == Flit::READ_REQUEST ) {
-    vcBegin = gReadReqBeginVC;
-    vcEnd = gReadReqEndVC;
-  } else if ( f->type == Flit::WRITE_REQUEST ) {
-    vcBegin = gWriteReqBeginVC;
-    vcEnd = gWriteReqEndVC;
-  } else if ( f->type ==  Flit::READ_REPLY ) {
-    vcBegin = gReadReplyBeginVC;
-    vcEnd = gReadReplyEndVC;
-  } else if ( f->type ==  Flit::WRITE_REPLY ) {
-    vcBegin = gWriteReplyBeginVC;
-    vcEnd = gWriteReplyEndVC;
-  }
+  int vcBegin = r->GetContext()->BeginVC(f->type);
+  int vcEnd = r->GetContext()->EndVC(f->type);
   assert(((f->vc >= vcBegin) && (f->vc <= vcEnd)) || (inject && (f->vc < 0)));
 
   int out_port;
@@ -839,7 +696,7 @@ void romm_mesh( const Router *r, const Flit *f, int in_channel, OutputSet *outpu
 
     if ( in_channel == 2*gN ) {
       f->ph   = 0;  // Phase 0
-      f->intm = rand_min_intr_mesh( f->src, f->dest );
+      f->intm = rand_min_intr_mesh( f, f->src, f->dest );
     } 
 
     if ( ( f->ph == 0 ) && ( r->GetID( ) == f->intm ) ) {
@@ -874,20 +731,8 @@ void romm_mesh( const Router *r, const Flit *f, int in_channel, OutputSet *outpu
 
 void romm_ni_mesh( const Router *r, const Flit *f, int in_channel, OutputSet *outputs, bool inject )
 {
-  int vcBegin = 0, vcEnd = gNumVCs-1;
-  if ( f->type == Flit::READ_REQUEST ) {
-    vcBegin = gReadReqBeginVC;
-    vcEnd = gReadReqEndVC;
-  } else if ( f->type == Flit::WRITE_REQUEST ) {
-    vcBegin = gWriteReqBeginVC;
-    vcEnd = gWriteReqEndVC;
-  } else if ( f->type ==  Flit::READ_REPLY ) {
-    vcBegin = gReadReplyBeginVC;
-    vcEnd = gReadReplyEndVC;
-  } else if ( f->type ==  Flit::WRITE_REPLY ) {
-    vcBegin = gWriteReplyBeginVC;
-    vcEnd = gWriteReplyEndVC;
-  }
+  int vcBegin = r->GetContext()->BeginVC(f->type);
+  int vcEnd = r->GetContext()->EndVC(f->type);
   assert(((f->vc >= vcBegin) && (f->vc <= vcEnd)) || (inject && (f->vc < 0)));
 
   // at the destination router, we don't need to separate VCs by destination
@@ -911,7 +756,7 @@ void romm_ni_mesh( const Router *r, const Flit *f, int in_channel, OutputSet *ou
 
     if ( in_channel == 2*gN ) {
       f->ph   = 0;  // Phase 0
-      f->intm = rand_min_intr_mesh( f->src, f->dest );
+      f->intm = rand_min_intr_mesh( f, f->src, f->dest );
     } 
 
     if ( ( f->ph == 0 ) && ( r->GetID( ) == f->intm ) ) {
@@ -931,20 +776,8 @@ void romm_ni_mesh( const Router *r, const Flit *f, int in_channel, OutputSet *ou
 
 void min_adapt_mesh( const Router *r, const Flit *f, int in_channel, OutputSet *outputs, bool inject )
 {
-  int vcBegin = 0, vcEnd = gNumVCs-1;
-  if ( f->type == Flit::READ_REQUEST ) {
-    vcBegin = gReadReqBeginVC;
-    vcEnd = gReadReqEndVC;
-  } else if ( f->type == Flit::WRITE_REQUEST ) {
-    vcBegin = gWriteReqBeginVC;
-    vcEnd = gWriteReqEndVC;
-  } else if ( f->type ==  Flit::READ_REPLY ) {
-    vcBegin = gReadReplyBeginVC;
-    vcEnd = gReadReplyEndVC;
-  } else if ( f->type ==  Flit::WRITE_REPLY ) {
-    vcBegin = gWriteReplyBeginVC;
-    vcEnd = gWriteReplyEndVC;
-  }
+  int vcBegin = r->GetContext()->BeginVC(f->type);
+  int vcEnd = r->GetContext()->EndVC(f->type);
   assert(((f->vc >= vcBegin) && (f->vc <= vcEnd)) || (inject && (f->vc < 0)));
 
   outputs->Clear( );
@@ -972,7 +805,7 @@ void min_adapt_mesh( const Router *r, const Flit *f, int in_channel, OutputSet *
   outputs->AddRange( out_port, 0, vcBegin, vcBegin );
   
   if ( f->watch ) {
-      *gWatchOut << GetSimTime() << " | " << r->FullName() << " | "
+      *gWatchOut << r->GetSimTime() << " | " << r->FullName() << " | "
 		  << "Adding VC range [" 
 		  << vcBegin << "," 
 		  << vcBegin << "]"
@@ -993,7 +826,7 @@ void min_adapt_mesh( const Router *r, const Flit *f, int in_channel, OutputSet *
 	// Add minimal direction in dimension 'n'
 	if ( ( cur % gK ) < ( dest % gK ) ) { // Right
 	  if ( f->watch ) {
-	    *gWatchOut << GetSimTime() << " | " << r->FullName() << " | "
+	    *gWatchOut << r->GetSimTime() << " | " << r->FullName() << " | "
 			<< "Adding VC range [" 
 		       << (vcBegin+1) << "," 
 			<< vcEnd << "]"
@@ -1007,7 +840,7 @@ void min_adapt_mesh( const Router *r, const Flit *f, int in_channel, OutputSet *
 	  outputs->AddRange( 2*n, vcBegin+1, vcEnd, 1 ); 
 	} else { // Left
 	  if ( f->watch ) {
-	    *gWatchOut << GetSimTime() << " | " << r->FullName() << " | "
+	    *gWatchOut << r->GetSimTime() << " | " << r->FullName() << " | "
 			<< "Adding VC range [" 
 		       << (vcBegin+1) << "," 
 			<< vcEnd << "]"
@@ -1031,20 +864,8 @@ void min_adapt_mesh( const Router *r, const Flit *f, int in_channel, OutputSet *
 
 void planar_adapt_mesh( const Router *r, const Flit *f, int in_channel, OutputSet *outputs, bool inject )
 {
-  int vcBegin = 0, vcEnd = gNumVCs-1;
-  if ( f->type == Flit::READ_REQUEST ) {
-    vcBegin = gReadReqBeginVC;
-    vcEnd = gReadReqEndVC;
-  } else if ( f->type == Flit::WRITE_REQUEST ) {
-    vcBegin = gWriteReqBeginVC;
-    vcEnd = gWriteReqEndVC;
-  } else if ( f->type ==  Flit::READ_REPLY ) {
-    vcBegin = gReadReplyBeginVC;
-    vcEnd = gReadReplyEndVC;
-  } else if ( f->type ==  Flit::WRITE_REPLY ) {
-    vcBegin = gWriteReplyBeginVC;
-    vcEnd = gWriteReplyEndVC;
-  }
+  int vcBegin = r->GetContext()->BeginVC(f->type);
+  int vcEnd = r->GetContext()->EndVC(f->type);
   assert(((f->vc >= vcBegin) && (f->vc <= vcEnd)) || (inject && (f->vc < 0)));
 
   outputs->Clear( );
@@ -1084,7 +905,7 @@ void planar_adapt_mesh( const Router *r, const Flit *f, int in_channel, OutputSe
     assert( n < gN );
 
     if ( f->watch ) {
-      *gWatchOut << GetSimTime() << " | " << r->FullName() << " | "
+      *gWatchOut << r->GetSimTime() << " | " << r->FullName() << " | "
 		  << "PLANAR ADAPTIVE: flit " << f->id 
 		  << " in adaptive plane " << n << "." << endl;
     }
@@ -1101,7 +922,7 @@ void planar_adapt_mesh( const Router *r, const Flit *f, int in_channel, OutputSe
 	fault = false;
 
 	if ( f->watch ) {
-	  *gWatchOut << GetSimTime() << " | " << r->FullName() << " | "
+	  *gWatchOut << r->GetSimTime() << " | " << r->FullName() << " | "
 		      << "PLANAR ADAPTIVE: increasing in dimension " << n
 		      << "." << endl;
 	}
@@ -1115,7 +936,7 @@ void planar_adapt_mesh( const Router *r, const Flit *f, int in_channel, OutputSe
 	fault = false;
 
 	if ( f->watch ) {
-	  *gWatchOut << GetSimTime() << " | " << r->FullName() << " | "
+	  *gWatchOut << r->GetSimTime() << " | " << r->FullName() << " | "
 		      << "PLANAR ADAPTIVE: decreasing in dimension " << n
 		      << "." << endl;
 	}
@@ -1154,7 +975,7 @@ void planar_adapt_mesh( const Router *r, const Flit *f, int in_channel, OutputSe
       }
 
       if ( f->watch ) {
-	*gWatchOut << GetSimTime() << " | " << r->FullName() << " | "
+	*gWatchOut << r->GetSimTime() << " | " << r->FullName() << " | "
 		    << "PLANAR ADAPTIVE: avoiding 180 in dimension " << n
 		    << "." << endl;
       }
@@ -1176,7 +997,7 @@ void planar_adapt_mesh( const Router *r, const Flit *f, int in_channel, OutputSe
 	d1_min_c = 2*n + 1;
 	atedge = true;
       } else {
-	d1_min_c = 2*n + RandomInt( 1 ); // random misroute
+	d1_min_c = 2*n + f->RandomInt( 1 ); // random misroute
 
 	if ( d1_min_c  == in_channel ) { // don't 180
 	  d1_min_c = in_channel ^ 1;
@@ -1208,20 +1029,8 @@ void limited_adapt_mesh( const Router *r, const Flit *f, int in_channel, OutputS
 {
   outputs->Clear( );
 
-  int vcBegin = 0, vcEnd = gNumVCs-1;
-  if ( f->type == Flit::READ_REQUEST ) {
-    vcBegin = gReadReqBeginVC;
-    vcEnd = gReadReqEndVC;
-  } else if ( f->type == Flit::WRITE_REQUEST ) {
-    vcBegin = gWriteReqBeginVC;
-    vcEnd = gWriteReqEndVC;
-  } else if ( f->type ==  Flit::READ_REPLY ) {
-    vcBegin = gReadReplyBeginVC;
-    vcEnd = gReadReplyEndVC;
-  } else if ( f->type ==  Flit::WRITE_REPLY ) {
-    vcBegin = gWriteReplyBeginVC;
-    vcEnd = gWriteReplyEndVC;
-  }
+  int vcBegin = r->GetContext()->BeginVC(f->type);
+  int vcEnd = r->GetContext()->EndVC(f->type);
   assert(((f->vc >= vcBegin) && (f->vc <= vcEnd)) || (inject && (f->vc < 0)));
 
   if ( inject ) {
@@ -1275,20 +1084,8 @@ void limited_adapt_mesh( const Router *r, const Flit *f, int in_channel, OutputS
 
 void valiant_mesh( const Router *r, const Flit *f, int in_channel, OutputSet *outputs, bool inject )
 {
-  int vcBegin = 0, vcEnd = gNumVCs-1;
-  if ( f->type == Flit::READ_REQUEST ) {
-    vcBegin = gReadReqBeginVC;
-    vcEnd = gReadReqEndVC;
-  } else if ( f->type == Flit::WRITE_REQUEST ) {
-    vcBegin = gWriteReqBeginVC;
-    vcEnd = gWriteReqEndVC;
-  } else if ( f->type ==  Flit::READ_REPLY ) {
-    vcBegin = gReadReplyBeginVC;
-    vcEnd = gReadReplyEndVC;
-  } else if ( f->type ==  Flit::WRITE_REPLY ) {
-    vcBegin = gWriteReplyBeginVC;
-    vcEnd = gWriteReplyEndVC;
-  }
+  int vcBegin = r->GetContext()->BeginVC(f->type);
+  int vcEnd = r->GetContext()->EndVC(f->type);
   assert(((f->vc >= vcBegin) && (f->vc <= vcEnd)) || (inject && (f->vc < 0)));
 
   int out_port;
@@ -1301,7 +1098,7 @@ void valiant_mesh( const Router *r, const Flit *f, int in_channel, OutputSet *ou
 
     if ( in_channel == 2*gN ) {
       f->ph   = 0;  // Phase 0
-      f->intm = RandomInt( gNodes - 1 );
+      f->intm = f->RandomInt( gNodes - 1 );
     }
 
     if ( ( f->ph == 0 ) && ( r->GetID( ) == f->intm ) ) {
@@ -1336,20 +1133,8 @@ void valiant_mesh( const Router *r, const Flit *f, int in_channel, OutputSet *ou
 
 void valiant_torus( const Router *r, const Flit *f, int in_channel, OutputSet *outputs, bool inject )
 {
-  int vcBegin = 0, vcEnd = gNumVCs-1;
-  if ( f->type == Flit::READ_REQUEST ) {
-    vcBegin = gReadReqBeginVC;
-    vcEnd = gReadReqEndVC;
-  } else if ( f->type == Flit::WRITE_REQUEST ) {
-    vcBegin = gWriteReqBeginVC;
-    vcEnd = gWriteReqEndVC;
-  } else if ( f->type ==  Flit::READ_REPLY ) {
-    vcBegin = gReadReplyBeginVC;
-    vcEnd = gReadReplyEndVC;
-  } else if ( f->type ==  Flit::WRITE_REPLY ) {
-    vcBegin = gWriteReplyBeginVC;
-    vcEnd = gWriteReplyEndVC;
-  }
+  int vcBegin = r->GetContext()->BeginVC(f->type);
+  int vcEnd = r->GetContext()->EndVC(f->type);
   assert(((f->vc >= vcBegin) && (f->vc <= vcEnd)) || (inject && (f->vc < 0)));
 
   int out_port;
@@ -1363,7 +1148,7 @@ void valiant_torus( const Router *r, const Flit *f, int in_channel, OutputSet *o
     int phase;
     if ( in_channel == 2*gN ) {
       phase   = 0;  // Phase 0
-      f->intm = RandomInt( gNodes - 1 );
+      f->intm = f->RandomInt( gNodes - 1 );
     } else {
       phase = f->ph / 2;
     }
@@ -1374,7 +1159,7 @@ void valiant_torus( const Router *r, const Flit *f, int in_channel, OutputSet *o
     }
   
     int ring_part;
-    dor_next_torus( r->GetID( ), (phase == 0) ? f->intm : f->dest, in_channel,
+    dor_next_torus( f, r->GetID( ), (phase == 0) ? f->intm : f->dest, in_channel,
 		    &out_port, &ring_part, false );
 
     f->ph = 2 * phase + ring_part;
@@ -1415,20 +1200,8 @@ void valiant_torus( const Router *r, const Flit *f, int in_channel, OutputSet *o
 void valiant_ni_torus( const Router *r, const Flit *f, int in_channel, 
 		       OutputSet *outputs, bool inject )
 {
-  int vcBegin = 0, vcEnd = gNumVCs-1;
-  if ( f->type == Flit::READ_REQUEST ) {
-    vcBegin = gReadReqBeginVC;
-    vcEnd = gReadReqEndVC;
-  } else if ( f->type == Flit::WRITE_REQUEST ) {
-    vcBegin = gWriteReqBeginVC;
-    vcEnd = gWriteReqEndVC;
-  } else if ( f->type ==  Flit::READ_REPLY ) {
-    vcBegin = gReadReplyBeginVC;
-    vcEnd = gReadReplyEndVC;
-  } else if ( f->type ==  Flit::WRITE_REPLY ) {
-    vcBegin = gWriteReplyBeginVC;
-    vcEnd = gWriteReplyEndVC;
-  }
+  int vcBegin = r->GetContext()->BeginVC(f->type);
+  int vcEnd = r->GetContext()->EndVC(f->type);
   assert(((f->vc >= vcBegin) && (f->vc <= vcEnd)) || (inject && (f->vc < 0)));
 
   // at the destination router, we don't need to separate VCs by destination
@@ -1453,7 +1226,7 @@ void valiant_ni_torus( const Router *r, const Flit *f, int in_channel,
     int phase;
     if ( in_channel == 2*gN ) {
       phase   = 0;  // Phase 0
-      f->intm = RandomInt( gNodes - 1 );
+      f->intm = f->RandomInt( gNodes - 1 );
     } else {
       phase = f->ph / 2;
     }
@@ -1464,7 +1237,7 @@ void valiant_ni_torus( const Router *r, const Flit *f, int in_channel,
     }
   
     int ring_part;
-    dor_next_torus( r->GetID( ), (f->ph == 0) ? f->intm : f->dest, in_channel,
+    dor_next_torus( f, r->GetID( ), (f->ph == 0) ? f->intm : f->dest, in_channel,
 		    &out_port, &ring_part, false );
 
     f->ph = 2 * phase + ring_part;
@@ -1494,7 +1267,7 @@ void valiant_ni_torus( const Router *r, const Flit *f, int in_channel,
     }
 
     if (f->watch) {
-      *gWatchOut << GetSimTime() << " | " << r->FullName() << " | "
+      *gWatchOut << r->GetSimTime() << " | " << r->FullName() << " | "
 		 << "Adding VC range [" 
 		 << vcBegin << "," 
 		 << vcEnd << "]"
@@ -1517,20 +1290,8 @@ void valiant_ni_torus( const Router *r, const Flit *f, int in_channel,
 void dim_order_torus( const Router *r, const Flit *f, int in_channel, 
 		      OutputSet *outputs, bool inject )
 {
-  int vcBegin = 0, vcEnd = gNumVCs-1;
-  if ( f->type == Flit::READ_REQUEST ) {
-    vcBegin = gReadReqBeginVC;
-    vcEnd = gReadReqEndVC;
-  } else if ( f->type == Flit::WRITE_REQUEST ) {
-    vcBegin = gWriteReqBeginVC;
-    vcEnd = gWriteReqEndVC;
-  } else if ( f->type ==  Flit::READ_REPLY ) {
-    vcBegin = gReadReplyBeginVC;
-    vcEnd = gReadReplyEndVC;
-  } else if ( f->type ==  Flit::WRITE_REPLY ) {
-    vcBegin = gWriteReplyBeginVC;
-    vcEnd = gWriteReplyEndVC;
-  }
+  int vcBegin = r->GetContext()->BeginVC(f->type);
+  int vcEnd = r->GetContext()->EndVC(f->type);
   assert(((f->vc >= vcBegin) && (f->vc <= vcEnd)) || (inject && (f->vc < 0)));
 
   int out_port;
@@ -1544,7 +1305,7 @@ void dim_order_torus( const Router *r, const Flit *f, int in_channel,
     int cur  = r->GetID( );
     int dest = f->dest;
 
-    dor_next_torus( cur, dest, in_channel,
+    dor_next_torus( f, cur, dest, in_channel,
 		    &out_port, &f->ph, false );
 
 
@@ -1562,7 +1323,7 @@ void dim_order_torus( const Router *r, const Flit *f, int in_channel,
     }
 
     if ( f->watch ) {
-      *gWatchOut << GetSimTime() << " | " << r->FullName() << " | "
+      *gWatchOut << r->GetSimTime() << " | " << r->FullName() << " | "
 		 << "Adding VC range [" 
 		 << vcBegin << "," 
 		 << vcEnd << "]"
@@ -1585,20 +1346,8 @@ void dim_order_torus( const Router *r, const Flit *f, int in_channel,
 void dim_order_ni_torus( const Router *r, const Flit *f, int in_channel, 
 			 OutputSet *outputs, bool inject )
 {
-  int vcBegin = 0, vcEnd = gNumVCs-1;
-  if ( f->type == Flit::READ_REQUEST ) {
-    vcBegin = gReadReqBeginVC;
-    vcEnd = gReadReqEndVC;
-  } else if ( f->type == Flit::WRITE_REQUEST ) {
-    vcBegin = gWriteReqBeginVC;
-    vcEnd = gWriteReqEndVC;
-  } else if ( f->type ==  Flit::READ_REPLY ) {
-    vcBegin = gReadReplyBeginVC;
-    vcEnd = gReadReplyEndVC;
-  } else if ( f->type ==  Flit::WRITE_REPLY ) {
-    vcBegin = gWriteReplyBeginVC;
-    vcEnd = gWriteReplyEndVC;
-  }
+  int vcBegin = r->GetContext()->BeginVC(f->type);
+  int vcEnd = r->GetContext()->EndVC(f->type);
   assert(((f->vc >= vcBegin) && (f->vc <= vcEnd)) || (inject && (f->vc < 0)));
 
   int out_port;
@@ -1612,7 +1361,7 @@ void dim_order_ni_torus( const Router *r, const Flit *f, int in_channel,
     int cur  = r->GetID( );
     int dest = f->dest;
 
-    dor_next_torus( cur, dest, in_channel,
+    dor_next_torus( f, cur, dest, in_channel,
 		    &out_port, NULL, false );
 
     // at the destination router, we don't need to separate VCs by destination
@@ -1627,7 +1376,7 @@ void dim_order_ni_torus( const Router *r, const Flit *f, int in_channel,
     }
 
     if ( f->watch ) {
-      *gWatchOut << GetSimTime() << " | " << r->FullName() << " | "
+      *gWatchOut << r->GetSimTime() << " | " << r->FullName() << " | "
 		 << "Adding VC range [" 
 		 << vcBegin << "," 
 		 << vcEnd << "]"
@@ -1650,20 +1399,8 @@ void dim_order_ni_torus( const Router *r, const Flit *f, int in_channel,
 void dim_order_bal_torus( const Router *r, const Flit *f, int in_channel, 
 			  OutputSet *outputs, bool inject )
 {
-  int vcBegin = 0, vcEnd = gNumVCs-1;
-  if ( f->type == Flit::READ_REQUEST ) {
-    vcBegin = gReadReqBeginVC;
-    vcEnd = gReadReqEndVC;
-  } else if ( f->type == Flit::WRITE_REQUEST ) {
-    vcBegin = gWriteReqBeginVC;
-    vcEnd = gWriteReqEndVC;
-  } else if ( f->type ==  Flit::READ_REPLY ) {
-    vcBegin = gReadReplyBeginVC;
-    vcEnd = gReadReplyEndVC;
-  } else if ( f->type ==  Flit::WRITE_REPLY ) {
-    vcBegin = gWriteReplyBeginVC;
-    vcEnd = gWriteReplyEndVC;
-  }
+  int vcBegin = r->GetContext()->BeginVC(f->type);
+  int vcEnd = r->GetContext()->EndVC(f->type);
   assert(((f->vc >= vcBegin) && (f->vc <= vcEnd)) || (inject && (f->vc < 0)));
 
   int out_port;
@@ -1677,7 +1414,7 @@ void dim_order_bal_torus( const Router *r, const Flit *f, int in_channel,
     int cur  = r->GetID( );
     int dest = f->dest;
 
-    dor_next_torus( cur, dest, in_channel,
+    dor_next_torus( f, cur, dest, in_channel,
 		    &out_port, &f->ph, true );
 
     // at the destination router, we don't need to separate VCs by ring partition
@@ -1695,7 +1432,7 @@ void dim_order_bal_torus( const Router *r, const Flit *f, int in_channel,
     }
 
     if ( f->watch ) {
-      *gWatchOut << GetSimTime() << " | " << r->FullName() << " | "
+      *gWatchOut << r->GetSimTime() << " | " << r->FullName() << " | "
 		 << "Adding VC range [" 
 		 << vcBegin << "," 
 		 << vcEnd << "]"
@@ -1717,20 +1454,8 @@ void dim_order_bal_torus( const Router *r, const Flit *f, int in_channel,
 
 void min_adapt_torus( const Router *r, const Flit *f, int in_channel, OutputSet *outputs, bool inject )
 {
-  int vcBegin = 0, vcEnd = gNumVCs-1;
-  if ( f->type == Flit::READ_REQUEST ) {
-    vcBegin = gReadReqBeginVC;
-    vcEnd = gReadReqEndVC;
-  } else if ( f->type == Flit::WRITE_REQUEST ) {
-    vcBegin = gWriteReqBeginVC;
-    vcEnd = gWriteReqEndVC;
-  } else if ( f->type ==  Flit::READ_REPLY ) {
-    vcBegin = gReadReplyBeginVC;
-    vcEnd = gReadReplyEndVC;
-  } else if ( f->type ==  Flit::WRITE_REPLY ) {
-    vcBegin = gWriteReplyBeginVC;
-    vcEnd = gWriteReplyEndVC;
-  }
+  int vcBegin = r->GetContext()->BeginVC(f->type);
+  int vcEnd = r->GetContext()->EndVC(f->type);
   assert(((f->vc >= vcBegin) && (f->vc <= vcEnd)) || (inject && (f->vc < 0)));
 
   outputs->Clear( );
@@ -1764,7 +1489,7 @@ void min_adapt_torus( const Router *r, const Flit *f, int in_channel, OutputSet
 	int dist2 = gK - 2 * ( ( ( dest % gK ) - ( cur % gK ) + gK ) % gK );
 	
 	if ( dist2 > 0 ) { /*) || 
-			     ( ( dist2 == 0 ) && ( RandomInt( 1 ) ) ) ) {*/
+			     ( ( dist2 == 0 ) && ( f->RandomInt( 1 ) ) ) ) {*/
 	  outputs->AddRange( 2*n, vcBegin+3, vcBegin+3, 1 ); // Right
 	} else {
 	  outputs->AddRange( 2*n + 1, vcBegin+3, vcBegin+3, 1 ); // Left
@@ -1778,11 +1503,11 @@ void min_adapt_torus( const Router *r, const Flit *f, int in_channel, OutputSet
     // DOR for the escape channel (VCs 0-1), low priority --- 
     // trick the algorithm with the in channel.  want VC assignment
     // as if we had injected at this node
-    dor_next_torus( r->GetID( ), f->dest, 2*gN,
+    dor_next_torus( f, r->GetID( ), f->dest, 2*gN,
 		    &out_port, &f->ph, false );
   } else {
     // DOR for the escape channel (VCs 0-1), low priority 
-    dor_next_torus( cur, dest, in_channel,
+    dor_next_torus( f, cur, dest, in_channel,
 		    &out_port, &f->ph, false );
   }
 
@@ -1798,20 +1523,8 @@ void min_adapt_torus( const Router *r, const Flit *f, int in_channel, OutputSet
 void dest_tag_fly( const Router *r, const Flit *f, int in_channel, 
 		   OutputSet *outputs, bool inject )
 {
-  int vcBegin = 0, vcEnd = gNumVCs-1;
-  if ( f->type == Flit::READ_REQUEST ) {
-    vcBegin = gReadReqBeginVC;
-    vcEnd = gReadReqEndVC;
-  } else if ( f->type == Flit::WRITE_REQUEST ) {
-    vcBegin = gWriteReqBeginVC;
-    vcEnd = gWriteReqEndVC;
-  } else if ( f->type ==  Flit::READ_REPLY ) {
-    vcBegin = gReadReplyBeginVC;
-    vcEnd = gReadReplyEndVC;
-  } else if ( f->type ==  Flit::WRITE_REPLY ) {
-    vcBegin = gWriteReplyBeginVC;
-    vcEnd = gWriteReplyEndVC;
-  }
+  int vcBegin = r->GetContext()->BeginVC(f->type);
+  int vcEnd = r->GetContext()->EndVC(f->type);
   assert(((f->vc >= vcBegin) && (f->vc <= vcEnd)) || (inject && (f->vc < 0)));
 
   int out_port;
@@ -1914,47 +1627,8 @@ void chaos_mesh( const Router *r, const Flit *f,
 
 //=============================================================
 
-void InitializeRoutingMap( const Configuration & config )
+void InitializeRoutingMap( )
 {
-
-  gNumVCs = config.GetInt( "num_vcs" );
-
-  //
-  // traffic class partitions
-  //
-  gReadReqBeginVC    = config.GetInt("read_request_begin_vc");
-  if(gReadReqBeginVC < 0) {
-    gReadReqBeginVC = 0;
-  }
-  gReadReqEndVC      = config.GetInt("read_request_end_vc");
-  if(gReadReqEndVC < 0) {
-    gReadReqEndVC = gNumVCs / 2 - 1;
-  }
-  gWriteReqBeginVC   = config.GetInt("write_request_begin_vc");
-  if(gWriteReqBeginVC < 0) {
-    gWriteReqBeginVC = 0;
-  }
-  gWriteReqEndVC     = config.GetInt("write_request_end_vc");
-  if(gWriteReqEndVC < 0) {
-    gWriteReqEndVC = gNumVCs / 2 - 1;
-  }
-  gReadReplyBeginVC  = config.GetInt("read_reply_begin_vc");
-  if(gReadReplyBeginVC < 0) {
-    gReadReplyBeginVC = gNumVCs / 2;
-  }
-  gReadReplyEndVC    = config.GetInt("read_reply_end_vc");
-  if(gReadReplyEndVC < 0) {
-    gReadReplyEndVC = gNumVCs - 1;
-  }
-  gWriteReplyBeginVC = config.GetInt("write_reply_begin_vc");
-  if(gWriteReplyBeginVC < 0) {
-    gWriteReplyBeginVC = gNumVCs / 2;
-  }
-  gWriteReplyEndVC   = config.GetInt("write_reply_end_vc");
-  if(gWriteReplyEndVC < 0) {
-    gWriteReplyEndVC = gNumVCs - 1;
-  }
-
   /* Register routing functions here */
 
   // ===================================================
@@ -35,14 +35,8 @@
 
 typedef void (*tRoutingFunction)( const Router *, const Flit *, int in_channel, OutputSet *, bool );
 
-void InitializeRoutingMap( const Configuration & config );
+void InitializeRoutingMap( );
 
 extern map<string, tRoutingFunction> gRoutingFunctionMap;
 
-extern int gNumVCs;
-extern int gReadReqBeginVC, gReadReqEndVC;
-extern int gWriteReqBeginVC, gWriteReqEndVC;
-extern int gReadReplyBeginVC, gReadReplyEndVC;
-extern int gWriteReplyBeginVC, gWriteReplyEndVC;
-
 #endif
@@ -32,6 +32,7 @@
 #include <iostream>
 #include <iomanip>
 #include <cstdlib>
+#include <cmath>
 #include <cassert>
 #include <limits>
 
@@ -46,6 +47,7 @@
 #include "allocator.hpp"
 #include "switch_monitor.hpp"
 #include "buffer_monitor.hpp"
+#include "checkpoint.hpp"
 
 IQRouter::IQRouter( Configuration const & config, Module *parent, 
 		    string const & name, int id, int inputs, int outputs )
@@ -157,11 +159,37 @@ IQRouter::IQRouter( Configuration const & config, Module *parent,
   _noq_next_vc_start.resize(_inputs, vector<int>(_vcs, -1));
   _noq_next_vc_end.resize(_inputs, vector<int>(_vcs, -1));
 
+  // Pipeline stages; every VC waits in at most one entry per stage (plus
+  // the one being re-queued during an update), while credits and flits
+  // stay in their stage for the duration of its delay
+  _in_queue_flits.resize(_inputs, NULL);
+  _proc_credits.Reserve(_outputs * (_credit_delay + 1));
+  _route_vcs.Reserve(_inputs * _vcs + 1);
+  _vc_alloc_vcs.Reserve(_inputs * _vcs + 1);
+  _sw_hold_vcs.Reserve(_inputs * _vcs + 1);
+  _sw_alloc_vcs.Reserve(_inputs * _vcs + 1);
+  _crossbar_flits.Reserve(_inputs * _input_speedup * (_crossbar_delay + 1));
+  _out_queue_credits.resize(_inputs, NULL);
+
   // Output queues
   _output_buffer_size = config.GetInt("output_buffer_size");
   _output_buffer.resize(_outputs); 
   _credit_buffer.resize(_inputs); 
 
+  // the queues of all ports share one block; besides the configured limit,
+  // an output queue has to take the flits that are still in the crossbar
+  // when it fills up, and an unbounded one grows as needed
+  int const output_capacity = RingBuffer<Flit *>::RoundCapacity(max(_output_buffer_size, 0) + (_crossbar_delay + 1) * _output_speedup);
+  _output_buffer_storage.resize(_outputs * output_capacity);
+  for(int output = 0; output < _outputs; ++output) {
+    _output_buffer[output].Attach(&_output_buffer_storage[output * output_capacity], output_capacity);
+  }
+  int const credit_capacity = RingBuffer<Credit *>::RoundCapacity(int(ceil(_internal_speedup)) + 1);
+  _credit_buffer_storage.resize(_inputs * credit_capacity);
+  for(int input = 0; input < _inputs; ++input) {
+    _credit_buffer[input].Attach(&_credit_buffer_storage[input * credit_capacity], credit_capacity);
+  }
+
   // Switch configuration (when held for multiple cycles)
   _hold_switch_for_packet = (config.GetInt("hold_switch_for_packet") > 0);
   _switch_hold_in.resize(_inputs*_input_speedup, -1);
@@ -223,6 +251,26 @@ void IQRouter::ReadInputs( )
   _active = _active || have_flits || have_credits;
 }
 
+bool IQRouter::IsIdle( ) const
+{
+  // a fractional internal speedup carries state from one cycle to the next
+  // even when there is nothing to do
+  if(_active || (_internal_speedup != floor(_internal_speedup))) {
+    return false;
+  }
+  for(int output = 0; output < _outputs; ++output) {
+    if(!_output_buffer[output].empty()) {
+      return false;
+    }
+  }
+  for(int input = 0; input < _inputs; ++input) {
+    if(!_credit_buffer[input].empty()) {
+      return false;
+    }
+  }
+  return true;
+}
+
 void IQRouter::_InternalStep( )
 {
   if(!_active) {
@@ -310,7 +358,8 @@ bool IQRouter::_ReceiveFlits( )
 		   << " from channel at input " << input
 		   << "." << endl;
       }
-      _in_queue_flits.insert(make_pair(input, f));
+      assert(!_in_queue_flits[input]);
+      _in_queue_flits[input] = f;
       activity = true;
     }
   }
@@ -323,8 +372,7 @@ bool IQRouter::_ReceiveCredits( )
   for(int output = 0; output < _outputs; ++output) {  
     Credit * const c = _output_credits[output]->Receive();
     if(c) {
-      _proc_credits.push_back(make_pair(GetSimTime() + _credit_delay, 
-					make_pair(c, output)));
+      _proc_credits.push_back(sPendingCredit(GetSimTime() + _credit_delay, c, output));
       activity = true;
     }
   }
@@ -338,15 +386,13 @@ bool IQRouter::_ReceiveCredits( )
 
 void IQRouter::_InputQueuing( )
 {
-  for(map<int, Flit *>::const_iterator iter = _in_queue_flits.begin();
-      iter != _in_queue_flits.end();
-      ++iter) {
+  for(int input = 0; input < _inputs; ++input) {
 
-    int const input = iter->first;
-    assert((input >= 0) && (input < _inputs));
-
-    Flit * const f = iter->second;
-    assert(f);
+    Flit * const f = _in_queue_flits[input];
+    if(!f) {
+      continue;
+    }
+    _in_queue_flits[input] = NULL;
 
     int const vc = f->vc;
     assert((vc >= 0) && (vc < _vcs));
@@ -383,7 +429,7 @@ void IQRouter::_InputQueuing( )
       assert(_switch_hold_vc[input*_input_speedup + vc%_input_speedup] != vc);
       if(_routing_delay) {
 	cur_buf->SetState(vc, VC::routing);
-	_route_vcs.push_back(make_pair(-1, make_pair(input, vc)));
+	_route_vcs.push_back(sPipelineVC(-1, input, vc));
       } else {
 	if(f->watch) {
 	  *gWatchOut << GetSimTime() << " | " << FullName() << " | "
@@ -395,12 +441,10 @@ void IQRouter::_InputQueuing( )
 	cur_buf->SetRouteSet(vc, &f->la_route_set);
 	cur_buf->SetState(vc, VC::vc_alloc);
 	if(_speculative) {
-	  _sw_alloc_vcs.push_back(make_pair(-1, make_pair(make_pair(input, vc),
-							  -1)));
+	  _sw_alloc_vcs.push_back(sPipelineVC(-1, input, vc));
 	}
 	if(_vc_allocator) {
-	  _vc_alloc_vcs.push_back(make_pair(-1, make_pair(make_pair(input, vc), 
-							  -1)));
+	  _vc_alloc_vcs.push_back(sPipelineVC(-1, input, vc));
 	}
 	if(_noq) {
 	  _UpdateNOQ(input, vc, f);
@@ -409,36 +453,33 @@ void IQRouter::_InputQueuing( )
     } else if((cur_buf->GetState(vc) == VC::active) &&
 	      (cur_buf->FrontFlit(vc) == f)) {
       if(_switch_hold_vc[input*_input_speedup + vc%_input_speedup] == vc) {
-	_sw_hold_vcs.push_back(make_pair(-1, make_pair(make_pair(input, vc),
-						       -1)));
+	_sw_hold_vcs.push_back(sPipelineVC(-1, input, vc));
       } else {
-	_sw_alloc_vcs.push_back(make_pair(-1, make_pair(make_pair(input, vc), 
-							-1)));
+	_sw_alloc_vcs.push_back(sPipelineVC(-1, input, vc));
       }
     }
   }
-  _in_queue_flits.clear();
 
   while(!_proc_credits.empty()) {
 
-    pair<int, pair<Credit *, int> > const & item = _proc_credits.front();
+    sPendingCredit const & item = _proc_credits.front();
 
-    int const time = item.first;
+    int const time = item.time;
     if(GetSimTime() < time) {
       break;
     }
 
-    Credit * const c = item.second.first;
+    Credit * const c = item.c;
     assert(c);
 
-    int const output = item.second.second;
+    int const output = item.output;
     assert((output >= 0) && (output < _outputs));
     
     BufferState * const dest_buf = _next_buf[output];
     
 #ifdef TRACK_FLOWS
-    for(set<int>::const_iterator iter = c->vc.begin(); iter != c->vc.end(); ++iter) {
-      int const vc = *iter;
+    for(unsigned long long bits = c->vc.bits(); bits; bits &= bits - 1) {
+      int const vc = __builtin_ctzll(bits);
       assert(!_outstanding_classes[output][vc].empty());
       int cl = _outstanding_classes[output][vc].front();
       _outstanding_classes[output][vc].pop();
@@ -462,19 +503,19 @@ void IQRouter::_RouteEvaluate( )
 {
   assert(_routing_delay);
 
-  for(deque<pair<int, pair<int, int> > >::iterator iter = _route_vcs.begin();
+  for(RingBuffer<sPipelineVC>::iterator iter = _route_vcs.begin();
       iter != _route_vcs.end();
       ++iter) {
     
-    int const time = iter->first;
+    int const time = iter->time;
     if(time >= 0) {
       break;
     }
-    iter->first = GetSimTime() + _routing_delay - 1;
+    iter->time = GetSimTime() + _routing_delay - 1;
     
-    int const input = iter->second.first;
+    int const input = iter->input;
     assert((input >= 0) && (input < _inputs));
-    int const vc = iter->second.second;
+    int const vc = iter->vc;
     assert((vc >= 0) && (vc < _vcs));
 
     Buffer const * const cur_buf = _buf[input];
@@ -502,17 +543,17 @@ void IQRouter::_RouteUpdate( )
 
   while(!_route_vcs.empty()) {
 
-    pair<int, pair<int, int> > const & item = _route_vcs.front();
+    sPipelineVC const item = _route_vcs.front();
 
-    int const time = item.first;
+    int const time = item.time;
     if((time < 0) || (GetSimTime() < time)) {
       break;
     }
     assert(GetSimTime() == time);
 
-    int const input = item.second.first;
+    int const input = item.input;
     assert((input >= 0) && (input < _inputs));
-    int const vc = item.second.second;
+    int const vc = item.vc;
     assert((vc >= 0) && (vc < _vcs));
     
     Buffer * const cur_buf = _buf[input];
@@ -535,10 +576,10 @@ void IQRouter::_RouteUpdate( )
     cur_buf->Route(vc, _rf, this, f, input);
     cur_buf->SetState(vc, VC::vc_alloc);
     if(_speculative) {
-      _sw_alloc_vcs.push_back(make_pair(-1, make_pair(item.second, -1)));
+      _sw_alloc_vcs.push_back(sPipelineVC(-1, item.input, item.vc));
     }
     if(_vc_allocator) {
-      _vc_alloc_vcs.push_back(make_pair(-1, make_pair(item.second, -1)));
+      _vc_alloc_vcs.push_back(sPipelineVC(-1, item.input, item.vc));
     }
     // NOTE: No need to handle NOQ here, as it requires lookahead routing!
     _route_vcs.pop_front();
@@ -556,21 +597,21 @@ void IQRouter::_VCAllocEvaluate( )
 
   bool watched = false;
 
-  for(deque<pair<int, pair<pair<int, int>, int> > >::iterator iter = _vc_alloc_vcs.begin();
+  for(RingBuffer<sPipelineVC>::iterator iter = _vc_alloc_vcs.begin();
       iter != _vc_alloc_vcs.end();
       ++iter) {
 
-    int const time = iter->first;
+    int const time = iter->time;
     if(time >= 0) {
       break;
     }
 
-    int const input = iter->second.first.first;
+    int const input = iter->input;
     assert((input >= 0) && (input < _inputs));
-    int const vc = iter->second.first.second;
+    int const vc = iter->vc;
     assert((vc >= 0) && (vc < _vcs));
 
-    assert(iter->second.second == -1);
+    assert(iter->result == -1);
 
     Buffer const * const cur_buf = _buf[input];
     assert(!cur_buf->Empty(vc));
@@ -593,16 +634,15 @@ void IQRouter::_VCAllocEvaluate( )
     assert(route_set);
 
     int const out_priority = cur_buf->GetPriority(vc);
-    set<OutputSet::sSetElement> const setlist = route_set->GetSet();
 
     bool elig = false;
     bool cred = false;
     bool reserved = false;
 
-    assert(!_noq || (setlist.size() == 1));
+    assert(!_noq || (route_set->size() == 1));
 
-    for(set<OutputSet::sSetElement>::const_iterator iset = setlist.begin();
-	iset != setlist.end();
+    for(OutputSet::const_iterator iset = route_set->begin();
+	iset != route_set->end();
 	++iset) {
 
       int const out_port = iset->output_port;
@@ -625,6 +665,38 @@ void IQRouter::_VCAllocEvaluate( )
       assert(vc_end >= 0 && vc_end < _vcs);
       assert(vc_end >= vc_start);
 
+      int const input_and_vc
+	= _vc_shuffle_requests ? (vc*_inputs + input) : (input*_vcs + vc);
+
+      if(!f->watch && !_vc_busy_when_full) {
+
+	// request all available VCs in the range at once
+	unsigned long long const range
+	  = (~0ULL >> (63 - (vc_end - vc_start))) << vc_start;
+	unsigned long long const avail = range & dest_buf->AvailableVCs();
+	if(avail) {
+	  elig = true;
+	  int const first = out_port*_vcs;
+	  if(_vc_prioritize_empty) {
+	    assert(iset->pri >= 0);
+	    unsigned long long const empty = dest_buf->EmptyVCs();
+	    if(avail & empty) {
+	      _vc_allocator->AddRequestMask(input_and_vc, first, avail & empty,
+					    0, iset->pri, out_priority);
+	    }
+	    if(avail & ~empty) {
+	      _vc_allocator->AddRequestMask(input_and_vc, first, avail & ~empty,
+					    0, iset->pri + numeric_limits<int>::min(),
+					    out_priority);
+	    }
+	  } else {
+	    _vc_allocator->AddRequestMask(input_and_vc, first, avail, 
+					  0, iset->pri, out_priority);
+	  }
+	}
+	continue;
+      }
+
       for(int out_vc = vc_start; out_vc <= vc_end; ++out_vc) {
 	assert((out_vc >= 0) && (out_vc < _vcs));
 
@@ -678,8 +750,6 @@ void IQRouter::_VCAllocEvaluate( )
 			 << ")." << endl;
 	      watched = true;
 	    }
-	    int const input_and_vc
-	      = _vc_shuffle_requests ? (vc*_inputs + input) : (input*_vcs + vc);
 	    _vc_allocator->AddRequest(input_and_vc, out_port*_vcs + out_vc, 
 				      0, in_priority, out_priority);
 	  }
@@ -687,9 +757,9 @@ void IQRouter::_VCAllocEvaluate( )
       }
     }
     if(!elig) {
-      iter->second.second = STALL_BUFFER_BUSY;
+      iter->result = STALL_BUFFER_BUSY;
     } else if(_vc_busy_when_full && !cred) {
-      iter->second.second = reserved ? STALL_BUFFER_RESERVED : STALL_BUFFER_FULL;
+      iter->result = reserved ? STALL_BUFFER_RESERVED : STALL_BUFFER_FULL;
     }
   }
 
@@ -705,26 +775,26 @@ void IQRouter::_VCAllocEvaluate( )
     _vc_allocator->PrintGrants( gWatchOut );
   }
 
-  for(deque<pair<int, pair<pair<int, int>, int> > >::iterator iter = _vc_alloc_vcs.begin();
+  for(RingBuffer<sPipelineVC>::iterator iter = _vc_alloc_vcs.begin();
       iter != _vc_alloc_vcs.end();
       ++iter) {
 
-    int const time = iter->first;
+    int const time = iter->time;
     if(time >= 0) {
       break;
     }
-    iter->first = GetSimTime() + _vc_alloc_delay - 1;
+    iter->time = GetSimTime() + _vc_alloc_delay - 1;
 
-    int const input = iter->second.first.first;
+    int const input = iter->input;
     assert((input >= 0) && (input < _inputs));
-    int const vc = iter->second.first.second;
+    int const vc = iter->vc;
     assert((vc >= 0) && (vc < _vcs));
 
-    if(iter->second.second < -1) {
+    if(iter->result < -1) {
       continue;
     }
 
-    assert(iter->second.second == -1);
+    assert(iter->result == -1);
 
     Buffer const * const cur_buf = _buf[input];
     assert(!cur_buf->Empty(vc));
@@ -755,7 +825,7 @@ void IQRouter::_VCAllocEvaluate( )
 		   << "." << endl;
       }
 
-      iter->second.second = output_and_vc;
+      iter->result = output_and_vc;
 
     } else {
 
@@ -766,7 +836,7 @@ void IQRouter::_VCAllocEvaluate( )
 		   << "." << endl;
       }
       
-      iter->second.second = STALL_BUFFER_CONFLICT;
+      iter->result = STALL_BUFFER_CONFLICT;
 
     }
   }
@@ -775,19 +845,19 @@ void IQRouter::_VCAllocEvaluate( )
     return;
   }
 
-  for(deque<pair<int, pair<pair<int, int>, int> > >::iterator iter = _vc_alloc_vcs.begin();
+  for(RingBuffer<sPipelineVC>::iterator iter = _vc_alloc_vcs.begin();
       iter != _vc_alloc_vcs.end();
       ++iter) {
     
-    int const time = iter->first;
+    int const time = iter->time;
     assert(time >= 0);
     if(GetSimTime() < time) {
       break;
     }
     
-    assert(iter->second.second != -1);
+    assert(iter->result != -1);
 
-    int const output_and_vc = iter->second.second;
+    int const output_and_vc = iter->result;
     
     if(output_and_vc >= 0) {
       
@@ -798,9 +868,9 @@ void IQRouter::_VCAllocEvaluate( )
       
       BufferState const * const dest_buf = _next_buf[match_output];
       
-      int const input = iter->second.first.first;
+      int const input = iter->input;
       assert((input >= 0) && (input < _inputs));
-      int const vc = iter->second.first.second;
+      int const vc = iter->vc;
       assert((vc >= 0) && (vc < _vcs));
       
       Buffer const * const cur_buf = _buf[input];
@@ -821,7 +891,7 @@ void IQRouter::_VCAllocEvaluate( )
 		     << " at output " << match_output
 		     << " is no longer available." << endl;
 	}
-	iter->second.second = STALL_BUFFER_BUSY;
+	iter->result = STALL_BUFFER_BUSY;
       } else if(_vc_busy_when_full && dest_buf->IsFullFor(match_vc)) {
 	if(f->watch) {
 	  *gWatchOut << GetSimTime() << " | " << FullName() << " | "
@@ -831,7 +901,7 @@ void IQRouter::_VCAllocEvaluate( )
 		     << " at output " << match_output
 		     << " has become full." << endl;
 	}
-	iter->second.second = dest_buf->IsFull() ? STALL_BUFFER_FULL : STALL_BUFFER_RESERVED;
+	iter->result = dest_buf->IsFull() ? STALL_BUFFER_FULL : STALL_BUFFER_RESERVED;
       }
     }
   }
@@ -843,20 +913,20 @@ void IQRouter::_VCAllocUpdate( )
 
   while(!_vc_alloc_vcs.empty()) {
 
-    pair<int, pair<pair<int, int>, int> > const & item = _vc_alloc_vcs.front();
+    sPipelineVC const item = _vc_alloc_vcs.front();
 
-    int const time = item.first;
+    int const time = item.time;
     if((time < 0) || (GetSimTime() < time)) {
       break;
     }
     assert(GetSimTime() == time);
 
-    int const input = item.second.first.first;
+    int const input = item.input;
     assert((input >= 0) && (input < _inputs));
-    int const vc = item.second.first.second;
+    int const vc = item.vc;
     assert((vc >= 0) && (vc < _vcs));
     
-    assert(item.second.second != -1);
+    assert(item.result != -1);
 
     Buffer * const cur_buf = _buf[input];
     assert(!cur_buf->Empty(vc));
@@ -875,7 +945,7 @@ void IQRouter::_VCAllocUpdate( )
 		 << ")." << endl;
     }
     
-    int const output_and_vc = item.second.second;
+    int const output_and_vc = item.result;
     
     if(output_and_vc >= 0) {
       
@@ -899,7 +969,7 @@ void IQRouter::_VCAllocUpdate( )
       cur_buf->SetOutput(vc, match_output, match_vc);
       cur_buf->SetState(vc, VC::active);
       if(!_speculative) {
-	_sw_alloc_vcs.push_back(make_pair(-1, make_pair(item.second.first, -1)));
+	_sw_alloc_vcs.push_back(sPipelineVC(-1, item.input, item.vc));
       }
     } else {
       if(f->watch) {
@@ -917,7 +987,7 @@ void IQRouter::_VCAllocUpdate( )
       }
 #endif
 
-      _vc_alloc_vcs.push_back(make_pair(-1, make_pair(item.second.first, -1)));
+      _vc_alloc_vcs.push_back(sPipelineVC(-1, item.input, item.vc));
     }
     _vc_alloc_vcs.pop_front();
   }
@@ -932,22 +1002,22 @@ void IQRouter::_SWHoldEvaluate( )
 {
   assert(_hold_switch_for_packet);
 
-  for(deque<pair<int, pair<pair<int, int>, int> > >::iterator iter = _sw_hold_vcs.begin();
+  for(RingBuffer<sPipelineVC>::iterator iter = _sw_hold_vcs.begin();
       iter != _sw_hold_vcs.end();
       ++iter) {
     
-    int const time = iter->first;
+    int const time = iter->time;
     if(time >= 0) {
       break;
     }
-    iter->first = GetSimTime();
+    iter->time = GetSimTime();
     
-    int const input = iter->second.first.first;
+    int const input = iter->input;
     assert((input >= 0) && (input < _inputs));
-    int const vc = iter->second.first.second;
+    int const vc = iter->vc;
     assert((vc >= 0) && (vc < _vcs));
     
-    assert(iter->second.second == -1);
+    assert(iter->result == -1);
 
     Buffer const * const cur_buf = _buf[input];
     assert(!cur_buf->Empty(vc));
@@ -987,7 +1057,7 @@ void IQRouter::_SWHoldEvaluate( )
 		   << "." << (expanded_output % _output_speedup)
 		   << ": No credit available." << endl;
       }
-      iter->second.second = dest_buf->IsFull() ? STALL_BUFFER_FULL : STALL_BUFFER_RESERVED;
+      iter->result = dest_buf->IsFull() ? STALL_BUFFER_FULL : STALL_BUFFER_RESERVED;
     } else {
       if(f->watch) {
 	*gWatchOut << GetSimTime() << " | " << FullName() << " | "
@@ -997,7 +1067,7 @@ void IQRouter::_SWHoldEvaluate( )
 		   << "." << (expanded_output % _output_speedup)
 		   << "." << endl;
       }
-      iter->second.second = expanded_output;
+      iter->result = expanded_output;
     }
   }
 }
@@ -1008,20 +1078,20 @@ void IQRouter::_SWHoldUpdate( )
 
   while(!_sw_hold_vcs.empty()) {
     
-    pair<int, pair<pair<int, int>, int> > const & item = _sw_hold_vcs.front();
+    sPipelineVC const item = _sw_hold_vcs.front();
     
-    int const time = item.first;
+    int const time = item.time;
     if(time < 0) {
       break;
     }
     assert(GetSimTime() == time);
     
-    int const input = item.second.first.first;
+    int const input = item.input;
     assert((input >= 0) && (input < _inputs));
-    int const vc = item.second.first.second;
+    int const vc = item.vc;
     assert((vc >= 0) && (vc < _vcs));
     
-    assert(item.second.second != -1);
+    assert(item.result != -1);
 
     Buffer * const cur_buf = _buf[input];
     assert(!cur_buf->Empty(vc));
@@ -1042,7 +1112,7 @@ void IQRouter::_SWHoldUpdate( )
     int const expanded_input = input * _input_speedup + vc % _input_speedup;
     assert(_switch_hold_vc[expanded_input] == vc);
     
-    int const expanded_output = item.second.second;
+    int const expanded_output = item.result;
     
     if(expanded_output >= 0 && ( _output_buffer_size==-1 || _output_buffer[expanded_output].size()<size_t(_output_buffer_size))) {
       
@@ -1121,12 +1191,12 @@ void IQRouter::_SWHoldUpdate( )
 
       dest_buf->SendingFlit(f);
 
-      _crossbar_flits.push_back(make_pair(-1, make_pair(f, make_pair(expanded_input, expanded_output))));
+      _crossbar_flits.push_back(sCrossbarFlit(-1, f, expanded_input, expanded_output));
       
-      if(_out_queue_credits.count(input) == 0) {
-	_out_queue_credits.insert(make_pair(input, Credit::New()));
+      if(!_out_queue_credits[input]) {
+	_out_queue_credits[input] = Credit::New();
       }
-      _out_queue_credits.find(input)->second->vc.insert(vc);
+      _out_queue_credits[input]->vc.insert(vc);
       
       if(cur_buf->Empty(vc)) {
 	if(f->watch) {
@@ -1162,7 +1232,7 @@ void IQRouter::_SWHoldUpdate( )
 	  _switch_hold_out[expanded_output] = -1;
 	  if(_routing_delay) {
 	    cur_buf->SetState(vc, VC::routing);
-	    _route_vcs.push_back(make_pair(-1, item.second.first));
+	    _route_vcs.push_back(sPipelineVC(-1, item.input, item.vc));
 	  } else {
 	    if(nf->watch) {
 	      *gWatchOut << GetSimTime() << " | " << FullName() << " | "
@@ -1174,20 +1244,17 @@ void IQRouter::_SWHoldUpdate( )
 	    cur_buf->SetRouteSet(vc, &nf->la_route_set);
 	    cur_buf->SetState(vc, VC::vc_alloc);
 	    if(_speculative) {
-	      _sw_alloc_vcs.push_back(make_pair(-1, make_pair(item.second.first,
-							      -1)));
+	      _sw_alloc_vcs.push_back(sPipelineVC(-1, item.input, item.vc));
 	    }
 	    if(_vc_allocator) {
-	      _vc_alloc_vcs.push_back(make_pair(-1, make_pair(item.second.first,
-							      -1)));
+	      _vc_alloc_vcs.push_back(sPipelineVC(-1, item.input, item.vc));
 	    }
 	    if(_noq) {
 	      _UpdateNOQ(input, vc, nf);
 	    }
 	  }
 	} else {
-	  _sw_hold_vcs.push_back(make_pair(-1, make_pair(item.second.first,
-							 -1)));
+	  _sw_hold_vcs.push_back(sPipelineVC(-1, item.input, item.vc));
 	}
       }
     } else {
@@ -1209,8 +1276,7 @@ void IQRouter::_SWHoldUpdate( )
       _switch_hold_vc[expanded_input] = -1;
       _switch_hold_in[expanded_input] = -1;
       _switch_hold_out[held_expanded_output] = -1;
-      _sw_alloc_vcs.push_back(make_pair(-1, make_pair(item.second.first,
-						      -1)));
+      _sw_alloc_vcs.push_back(sPipelineVC(-1, item.input, item.vc));
     }
     _sw_hold_vcs.pop_front();
   }
@@ -1328,21 +1394,21 @@ void IQRouter::_SWAllocEvaluate( )
 {
   bool watched = false;
 
-  for(deque<pair<int, pair<pair<int, int>, int> > >::iterator iter = _sw_alloc_vcs.begin();
+  for(RingBuffer<sPipelineVC>::iterator iter = _sw_alloc_vcs.begin();
       iter != _sw_alloc_vcs.end();
       ++iter) {
 
-    int const time = iter->first;
+    int const time = iter->time;
     if(time >= 0) {
       break;
     }
 
-    int const input = iter->second.first.first;
+    int const input = iter->input;
     assert((input >= 0) && (input < _inputs));
-    int const vc = iter->second.first.second;
+    int const vc = iter->vc;
     assert((vc >= 0) && (vc < _vcs));
     
-    assert(iter->second.second == -1);
+    assert(iter->result == -1);
 
     assert(_switch_hold_vc[input * _input_speedup + vc % _input_speedup] != vc);
 
@@ -1379,7 +1445,7 @@ void IQRouter::_SWAllocEvaluate( )
 		     << " at output " << dest_output 
 		     << " is full." << endl;
 	}
-	iter->second.second = dest_buf->IsFull() ? STALL_BUFFER_FULL : STALL_BUFFER_RESERVED;
+	iter->result = dest_buf->IsFull() ? STALL_BUFFER_FULL : STALL_BUFFER_RESERVED;
 	continue;
       }
       bool const requested = _SWAllocAddReq(input, vc, dest_output);
@@ -1397,12 +1463,10 @@ void IQRouter::_SWAllocEvaluate( )
     OutputSet const * const route_set = cur_buf->GetRouteSet(vc);
     assert(route_set);
     
-    set<OutputSet::sSetElement> const setlist = route_set->GetSet();
-    
-    assert(!_noq || (setlist.size() == 1));
+    assert(!_noq || (route_set->size() == 1));
 
-    for(set<OutputSet::sSetElement>::const_iterator iset = setlist.begin();
-	iset != setlist.end();
+    for(OutputSet::const_iterator iset = route_set->begin();
+	iset != route_set->end();
 	++iset) {
       
       int const dest_output = iset->output_port;
@@ -1455,14 +1519,14 @@ void IQRouter::_SWAllocEvaluate( )
 		     << "  Output " << dest_output 
 		     << " has no suitable VCs available." << endl;
 	}
-	iter->second.second = STALL_BUFFER_BUSY;
+	iter->result = STALL_BUFFER_BUSY;
       } else if(_spec_check_cred && !cred) {
 	if(f->watch) {
 	  *gWatchOut << GetSimTime() << " | " << FullName() << " | "
 		     << "  All suitable VCs at output " << dest_output 
 		     << " are full." << endl;
 	}
-	iter->second.second = dest_buf->IsFull() ? STALL_BUFFER_FULL : STALL_BUFFER_RESERVED;
+	iter->result = dest_buf->IsFull() ? STALL_BUFFER_FULL : STALL_BUFFER_RESERVED;
       } else {
 	bool const requested = _SWAllocAddReq(input, vc, dest_output);
 	watched |= requested && f->watch;
@@ -1492,26 +1556,26 @@ void IQRouter::_SWAllocEvaluate( )
     }
   }
   
-  for(deque<pair<int, pair<pair<int, int>, int> > >::iterator iter = _sw_alloc_vcs.begin();
+  for(RingBuffer<sPipelineVC>::iterator iter = _sw_alloc_vcs.begin();
       iter != _sw_alloc_vcs.end();
       ++iter) {
 
-    int const time = iter->first;
+    int const time = iter->time;
     if(time >= 0) {
       break;
     }
-    iter->first = GetSimTime() + _sw_alloc_delay - 1;
+    iter->time = GetSimTime() + _sw_alloc_delay - 1;
 
-    int const input = iter->second.first.first;
+    int const input = iter->input;
     assert((input >= 0) && (input < _inputs));
-    int const vc = iter->second.first.second;
+    int const vc = iter->vc;
     assert((vc >= 0) && (vc < _vcs));
 
-    if(iter->second.second < -1) {
+    if(iter->result < -1) {
       continue;
     }
 
-    assert(iter->second.second == -1);
+    assert(iter->result == -1);
 
     Buffer const * const cur_buf = _buf[input];
     assert(!cur_buf->Empty(vc));
@@ -1540,7 +1604,7 @@ void IQRouter::_SWAllocEvaluate( )
 		     << "." << endl;
 	}
 	_sw_rr_offset[expanded_input] = (vc + _input_speedup) % _vcs;
-	iter->second.second = expanded_output;
+	iter->result = expanded_output;
       } else {
 	if(f->watch) {
 	  *gWatchOut << GetSimTime() << " | " << FullName() << " | "
@@ -1548,7 +1612,7 @@ void IQRouter::_SWAllocEvaluate( )
 		     << " at input " << input
 		     << ": Granted to VC " << granted_vc << "." << endl;
 	}
-	iter->second.second = STALL_CROSSBAR_CONFLICT;
+	iter->result = STALL_CROSSBAR_CONFLICT;
       }
     } else if(_spec_sw_allocator) {
       expanded_output = _spec_sw_allocator->OutputAssigned(expanded_input);
@@ -1565,7 +1629,7 @@ void IQRouter::_SWAllocEvaluate( )
 		       << "." << (expanded_output % _output_speedup)
 		       << " has non-speculative requests." << endl;
 	  }
-	  iter->second.second = STALL_CROSSBAR_CONFLICT;
+	  iter->result = STALL_CROSSBAR_CONFLICT;
 	} else if(!_spec_mask_by_reqs &&
 		  (_sw_allocator->InputAssigned(expanded_output) >= 0)) {
 	  if(f->watch) {
@@ -1577,7 +1641,7 @@ void IQRouter::_SWAllocEvaluate( )
 		       << "." << (expanded_output % _output_speedup)
 		       << " has a non-speculative grant." << endl;
 	  }
-	  iter->second.second = STALL_CROSSBAR_CONFLICT;
+	  iter->result = STALL_CROSSBAR_CONFLICT;
 	} else {
 	  int const granted_vc = _spec_sw_allocator->ReadRequest(expanded_input, 
 								 expanded_output);
@@ -1592,7 +1656,7 @@ void IQRouter::_SWAllocEvaluate( )
 			 << "." << endl;
 	    }
 	    _sw_rr_offset[expanded_input] = (vc + _input_speedup) % _vcs;
-	    iter->second.second = expanded_output;
+	    iter->result = expanded_output;
 	  } else {
 	    if(f->watch) {
 	      *gWatchOut << GetSimTime() << " | " << FullName() << " | "
@@ -1600,7 +1664,7 @@ void IQRouter::_SWAllocEvaluate( )
 			 << " at input " << input
 			 << ": Granted to VC " << granted_vc << "." << endl;
 	    }
-	    iter->second.second = STALL_CROSSBAR_CONFLICT;
+	    iter->result = STALL_CROSSBAR_CONFLICT;
 	  }
 	}
       } else {
@@ -1612,7 +1676,7 @@ void IQRouter::_SWAllocEvaluate( )
 		     << ": No output granted." << endl;
 	}
 	
-	iter->second.second = STALL_CROSSBAR_CONFLICT;
+	iter->result = STALL_CROSSBAR_CONFLICT;
 
       }
     } else {
@@ -1624,7 +1688,7 @@ void IQRouter::_SWAllocEvaluate( )
 		   << ": No output granted." << endl;
       }
       
-      iter->second.second = STALL_CROSSBAR_CONFLICT;
+      iter->result = STALL_CROSSBAR_CONFLICT;
       
     }
   }
@@ -1633,19 +1697,19 @@ void IQRouter::_SWAllocEvaluate( )
     return;
   }
 
-  for(deque<pair<int, pair<pair<int, int>, int> > >::iterator iter = _sw_alloc_vcs.begin();
+  for(RingBuffer<sPipelineVC>::iterator iter = _sw_alloc_vcs.begin();
       iter != _sw_alloc_vcs.end();
       ++iter) {
 
-    int const time = iter->first;
+    int const time = iter->time;
     assert(time >= 0);
     if(GetSimTime() < time) {
       break;
     }
 
-    assert(iter->second.second != -1);
+    assert(iter->result != -1);
 
-    int const expanded_output = iter->second.second;
+    int const expanded_output = iter->result;
     
     if(expanded_output >= 0) {
       
@@ -1654,10 +1718,10 @@ void IQRouter::_SWAllocEvaluate( )
       
       BufferState const * const dest_buf = _next_buf[output];
       
-      int const input = iter->second.first.first;
+      int const input = iter->input;
       assert((input >= 0) && (input < _inputs));
       assert((input % _output_speedup) == (expanded_output % _output_speedup));
-      int const vc = iter->second.first.second;
+      int const vc = iter->vc;
       assert((vc >= 0) && (vc < _vcs));
       
       int const expanded_input = input * _input_speedup + vc % _input_speedup;
@@ -1693,7 +1757,7 @@ void IQRouter::_SWAllocEvaluate( )
 	  }
 	  *gWatchOut << "." << endl;
 	}
-	iter->second.second = STALL_CROSSBAR_CONFLICT;
+	iter->result = STALL_CROSSBAR_CONFLICT;
       } else if(_speculative && (cur_buf->GetState(vc) == VC::vc_alloc)) {
 
 	assert(f->head);
@@ -1713,7 +1777,7 @@ void IQRouter::_SWAllocEvaluate( )
 			 << "." << (expanded_output % _output_speedup)
 			 << " due to misspeculation." << endl;
 	    }
-	    iter->second.second = -1; // stall is counted in VC allocation path!
+	    iter->result = -1; // stall is counted in VC allocation path!
 	  } else if((output_and_vc / _vcs) != output) {
 	    if(f->watch) {
 	      *gWatchOut << GetSimTime() << " | " << FullName() << " | "
@@ -1723,7 +1787,7 @@ void IQRouter::_SWAllocEvaluate( )
 			 << "." << (expanded_output % _output_speedup)
 			 << " due to port mismatch between VC and switch allocator." << endl;
 	    }
-	    iter->second.second = STALL_BUFFER_CONFLICT; // count this case as if we had failed allocation
+	    iter->result = STALL_BUFFER_CONFLICT; // count this case as if we had failed allocation
 	  } else if(dest_buf->IsFullFor((output_and_vc % _vcs))) {
 	    if(f->watch) {
 	      *gWatchOut << GetSimTime() << " | " << FullName() << " | "
@@ -1733,7 +1797,7 @@ void IQRouter::_SWAllocEvaluate( )
 			 << "." << (expanded_output % _output_speedup)
 			 << " due to lack of credit." << endl;
 	    }
-	    iter->second.second = dest_buf->IsFull() ? STALL_BUFFER_FULL : STALL_BUFFER_RESERVED;
+	    iter->result = dest_buf->IsFull() ? STALL_BUFFER_FULL : STALL_BUFFER_RESERVED;
 	  }
 
 	} else { // VC allocation is piggybacked onto switch allocation
@@ -1741,16 +1805,14 @@ void IQRouter::_SWAllocEvaluate( )
 	  OutputSet const * const route_set = cur_buf->GetRouteSet(vc);
 	  assert(route_set);
 
-	  set<OutputSet::sSetElement> const setlist = route_set->GetSet();
-
 	  bool busy = true;
 	  bool full = true;
 	  bool reserved = false;
 
-	  assert(!_noq || (setlist.size() == 1));
+	  assert(!_noq || (route_set->size() == 1));
 
-	  for(set<OutputSet::sSetElement>::const_iterator iset = setlist.begin();
-	      iset != setlist.end();
+	  for(OutputSet::const_iterator iset = route_set->begin();
+	      iset != route_set->end();
 	      ++iset) {
 	    if(iset->output_port == output) {
 
@@ -1796,7 +1858,7 @@ void IQRouter::_SWAllocEvaluate( )
 			 << "." << (expanded_output % _output_speedup)
 			 << " because no suitable output VC for piggyback allocation is available." << endl;
 	    }
-	    iter->second.second = STALL_BUFFER_BUSY;
+	    iter->result = STALL_BUFFER_BUSY;
 	  } else if(full) {
 	    if(f->watch) {
 	      *gWatchOut << GetSimTime() << " | " << FullName() << " | "
@@ -1806,7 +1868,7 @@ void IQRouter::_SWAllocEvaluate( )
 			 << "." << (expanded_output % _output_speedup)
 			 << " because all suitable output VCs for piggyback allocation are full." << endl;
 	    }
-	    iter->second.second = reserved ? STALL_BUFFER_RESERVED : STALL_BUFFER_FULL;
+	    iter->result = reserved ? STALL_BUFFER_RESERVED : STALL_BUFFER_FULL;
 	  }
 
 	}
@@ -1826,7 +1888,7 @@ void IQRouter::_SWAllocEvaluate( )
 		       << "." << (expanded_output % _output_speedup)
 		       << " due to lack of credit." << endl;
 	  }
-	  iter->second.second = dest_buf->IsFull() ? STALL_BUFFER_FULL : STALL_BUFFER_RESERVED;
+	  iter->result = dest_buf->IsFull() ? STALL_BUFFER_FULL : STALL_BUFFER_RESERVED;
 	}
       }
     }
@@ -1837,17 +1899,17 @@ void IQRouter::_SWAllocUpdate( )
 {
   while(!_sw_alloc_vcs.empty()) {
 
-    pair<int, pair<pair<int, int>, int> > const & item = _sw_alloc_vcs.front();
+    sPipelineVC const item = _sw_alloc_vcs.front();
 
-    int const time = item.first;
+    int const time = item.time;
     if((time < 0) || (GetSimTime() < time)) {
       break;
     }
     assert(GetSimTime() == time);
 
-    int const input = item.second.first.first;
+    int const input = item.input;
     assert((input >= 0) && (input < _inputs));
-    int const vc = item.second.first.second;
+    int const vc = item.vc;
     assert((vc >= 0) && (vc < _vcs));
     
     Buffer * const cur_buf = _buf[input];
@@ -1867,7 +1929,7 @@ void IQRouter::_SWAllocUpdate( )
 		 << ")." << endl;
     }
     
-    int const expanded_output = item.second.second;
+    int const expanded_output = item.result;
     
     if(expanded_output >= 0) {
       
@@ -1896,12 +1958,10 @@ void IQRouter::_SWAllocUpdate( )
 	int match_prio = numeric_limits<int>::min();
 
 	const OutputSet * route_set = cur_buf->GetRouteSet(vc);
-	set<OutputSet::sSetElement> const setlist = route_set->GetSet();
-	
-	assert(!_noq || (setlist.size() == 1));
+	assert(!_noq || (route_set->size() == 1));
 	
-	for(set<OutputSet::sSetElement>::const_iterator iset = setlist.begin();
-	    iset != setlist.end();
+	for(OutputSet::const_iterator iset = route_set->begin();
+	    iset != route_set->end();
 	    ++iset) {
 	  if(iset->output_port == output) {
 
@@ -2031,12 +2091,12 @@ void IQRouter::_SWAllocUpdate( )
 
       dest_buf->SendingFlit(f);
 
-      _crossbar_flits.push_back(make_pair(-1, make_pair(f, make_pair(expanded_input, expanded_output))));
+      _crossbar_flits.push_back(sCrossbarFlit(-1, f, expanded_input, expanded_output));
 
-      if(_out_queue_credits.count(input) == 0) {
-	_out_queue_credits.insert(make_pair(input, Credit::New()));
+      if(!_out_queue_credits[input]) {
+	_out_queue_credits[input] = Credit::New();
       }
-      _out_queue_credits.find(input)->second->vc.insert(vc);
+      _out_queue_credits[input]->vc.insert(vc);
 
       if(cur_buf->Empty(vc)) {
 	if(f->tail) {
@@ -2050,7 +2110,7 @@ void IQRouter::_SWAllocUpdate( )
 	  assert(nf->head);
 	  if(_routing_delay) {
 	    cur_buf->SetState(vc, VC::routing);
-	    _route_vcs.push_back(make_pair(-1, item.second.first));
+	    _route_vcs.push_back(sPipelineVC(-1, item.input, item.vc));
 	  } else {
 	    if(nf->watch) {
 	      *gWatchOut << GetSimTime() << " | " << FullName() << " | "
@@ -2062,12 +2122,10 @@ void IQRouter::_SWAllocUpdate( )
 	    cur_buf->SetRouteSet(vc, &nf->la_route_set);
 	    cur_buf->SetState(vc, VC::vc_alloc);
 	    if(_speculative) {
-	      _sw_alloc_vcs.push_back(make_pair(-1, make_pair(item.second.first,
-							      -1)));
+	      _sw_alloc_vcs.push_back(sPipelineVC(-1, item.input, item.vc));
 	    }
 	    if(_vc_allocator) {
-	      _vc_alloc_vcs.push_back(make_pair(-1, make_pair(item.second.first,
-							      -1)));
+	      _vc_alloc_vcs.push_back(sPipelineVC(-1, item.input, item.vc));
 	    }
 	    if(_noq) {
 	      _UpdateNOQ(input, vc, nf);
@@ -2087,11 +2145,9 @@ void IQRouter::_SWAllocUpdate( )
 	    _switch_hold_vc[expanded_input] = vc;
 	    _switch_hold_in[expanded_input] = expanded_output;
 	    _switch_hold_out[expanded_output] = expanded_input;
-	    _sw_hold_vcs.push_back(make_pair(-1, make_pair(item.second.first,
-							   -1)));
+	    _sw_hold_vcs.push_back(sPipelineVC(-1, item.input, item.vc));
 	  } else {
-	    _sw_alloc_vcs.push_back(make_pair(-1, make_pair(item.second.first,
-							    -1)));
+	    _sw_alloc_vcs.push_back(sPipelineVC(-1, item.input, item.vc));
 	  }
 	}
       }
@@ -2121,7 +2177,7 @@ void IQRouter::_SWAllocUpdate( )
       }
 #endif
 
-      _sw_alloc_vcs.push_back(make_pair(-1, make_pair(item.second.first, -1)));
+      _sw_alloc_vcs.push_back(sPipelineVC(-1, item.input, item.vc));
     }
     _sw_alloc_vcs.pop_front();
   }
@@ -2134,21 +2190,21 @@ void IQRouter::_SWAllocUpdate( )
 
 void IQRouter::_SwitchEvaluate( )
 {
-  for(deque<pair<int, pair<Flit *, pair<int, int> > > >::iterator iter = _crossbar_flits.begin();
+  for(RingBuffer<sCrossbarFlit>::iterator iter = _crossbar_flits.begin();
       iter != _crossbar_flits.end();
       ++iter) {
     
-    int const time = iter->first;
+    int const time = iter->time;
     if(time >= 0) {
       break;
     }
-    iter->first = GetSimTime() + _crossbar_delay - 1;
+    iter->time = GetSimTime() + _crossbar_delay - 1;
 
-    Flit const * const f = iter->second.first;
+    Flit const * const f = iter->f;
     assert(f);
 
-    int const expanded_input = iter->second.second.first;
-    int const expanded_output = iter->second.second.second;
+    int const expanded_input = iter->expanded_input;
+    int const expanded_output = iter->expanded_output;
       
     if(f->watch) {
       *gWatchOut << GetSimTime() << " | " << FullName() << " | "
@@ -2166,21 +2222,21 @@ void IQRouter::_SwitchUpdate( )
 {
   while(!_crossbar_flits.empty()) {
 
-    pair<int, pair<Flit *, pair<int, int> > > const & item = _crossbar_flits.front();
+    sCrossbarFlit const item = _crossbar_flits.front();
 
-    int const time = item.first;
+    int const time = item.time;
     if((time < 0) || (GetSimTime() < time)) {
       break;
     }
     assert(GetSimTime() == time);
 
-    Flit * const f = item.second.first;
+    Flit * const f = item.f;
     assert(f);
 
-    int const expanded_input = item.second.second.first;
+    int const expanded_input = item.expanded_input;
     int const input = expanded_input / _input_speedup;
     assert((input >= 0) && (input < _inputs));
-    int const expanded_output = item.second.second.second;
+    int const expanded_output = item.expanded_output;
     int const output = expanded_output / _output_speedup;
     assert((output >= 0) && (output < _outputs));
 
@@ -2201,7 +2257,7 @@ void IQRouter::_SwitchUpdate( )
 		 << " at output " << output
 		 << "." << endl;
     }
-    _output_buffer[output].push(f);
+    _output_buffer[output].push_back(f);
     //the output buffer size isn't precise due to flits in flight
     //but there is a maximum bound based on output speed up and ST traversal
     assert(_output_buffer[output].size()<=(size_t)_output_buffer_size+ _crossbar_delay* _output_speedup+( _output_speedup-1) ||_output_buffer_size==-1);
@@ -2216,20 +2272,17 @@ void IQRouter::_SwitchUpdate( )
 
 void IQRouter::_OutputQueuing( )
 {
-  for(map<int, Credit *>::const_iterator iter = _out_queue_credits.begin();
-      iter != _out_queue_credits.end();
-      ++iter) {
-
-    int const input = iter->first;
-    assert((input >= 0) && (input < _inputs));
+  for(int input = 0; input < _inputs; ++input) {
 
-    Credit * const c = iter->second;
-    assert(c);
+    Credit * const c = _out_queue_credits[input];
+    if(!c) {
+      continue;
+    }
     assert(!c->vc.empty());
 
-    _credit_buffer[input].push(c);
+    _credit_buffer[input].push_back(c);
+    _out_queue_credits[input] = NULL;
   }
-  _out_queue_credits.clear();
 }
 
 //------------------------------------------------------------------------------
@@ -2242,7 +2295,7 @@ void IQRouter::_SendFlits( )
     if ( !_output_buffer[output].empty( ) ) {
       Flit * const f = _output_buffer[output].front( );
       assert(f);
-      _output_buffer[output].pop( );
+      _output_buffer[output].pop_front( );
 
 #ifdef TRACK_FLOWS
       ++_sent_flits[f->cl][output];
@@ -2267,7 +2320,7 @@ void IQRouter::_SendCredits( )
     if ( !_credit_buffer[input].empty( ) ) {
       Credit * const c = _credit_buffer[input].front( );
       assert(c);
-      _credit_buffer[input].pop( );
+      _credit_buffer[input].pop_front( );
       _input_credits[input]->Send( c );
     }
   }
@@ -2285,6 +2338,99 @@ void IQRouter::Display( ostream & os ) const
   }
 }
 
+void IQRouter::sPipelineVC::Serialize( Checkpoint & cp )
+{
+  cp.Sync(time);
+  cp.Sync(input);
+  cp.Sync(vc);
+  cp.Sync(result);
+}
+
+void IQRouter::sCrossbarFlit::Serialize( Checkpoint & cp )
+{
+  cp.Sync(time);
+  cp.Sync(f);
+  cp.Sync(expanded_input);
+  cp.Sync(expanded_output);
+}
+
+void IQRouter::sPendingCredit::Serialize( Checkpoint & cp )
+{
+  cp.Sync(time);
+  cp.Sync(c);
+  cp.Sync(output);
+}
+
+template<class T>
+void IQRouter::_SerializeStage( Checkpoint & cp, RingBuffer<T> & stage )
+{
+  int size = stage.size();
+  cp.Sync(size);
+  if(cp.Loading()) {
+    stage.clear();
+    for(int i = 0; i < size; ++i) {
+      stage.push_back(T());
+    }
+  }
+  for(typename RingBuffer<T>::iterator iter = stage.begin();
+      iter != stage.end();
+      ++iter) {
+    iter->Serialize(cp);
+  }
+}
+
+void IQRouter::Serialize( Checkpoint & cp )
+{
+  _SerializeCommon(cp);
+
+  cp.Sync(_active);
+
+  cp.Sync(_in_queue_flits);
+  _SerializeStage(cp, _proc_credits);
+  _SerializeStage(cp, _route_vcs);
+  _SerializeStage(cp, _vc_alloc_vcs);
+  _SerializeStage(cp, _sw_hold_vcs);
+  _SerializeStage(cp, _sw_alloc_vcs);
+  _SerializeStage(cp, _crossbar_flits);
+  cp.Sync(_out_queue_credits);
+
+  for(int input = 0; input < _inputs; ++input) {
+    _buf[input]->Serialize(cp);
+  }
+  for(int output = 0; output < _outputs; ++output) {
+    _next_buf[output]->Serialize(cp);
+  }
+
+  if(_vc_allocator) {
+    _vc_allocator->Serialize(cp);
+  }
+  _sw_allocator->Serialize(cp);
+  if(_spec_sw_allocator) {
+    _spec_sw_allocator->Serialize(cp);
+  }
+
+  cp.Sync(_vc_rr_offset);
+  cp.Sync(_sw_rr_offset);
+
+  cp.Sync(_output_buffer);
+  cp.Sync(_credit_buffer);
+
+  cp.Sync(_switch_hold_in);
+  cp.Sync(_switch_hold_out);
+  cp.Sync(_switch_hold_vc);
+
+  cp.Sync(_noq_next_output_port);
+  cp.Sync(_noq_next_vc_start);
+  cp.Sync(_noq_next_vc_end);
+
+#ifdef TRACK_FLOWS
+  cp.Sync(_outstanding_classes);
+#endif
+
+  _bufferMonitor->Serialize(cp);
+  _switchMonitor->Serialize(cp);
+}
+
 int IQRouter::GetUsedCredit(int o) const
 {
   assert((o >= 0) && (o < _outputs));
@@ -2350,18 +2496,16 @@ void IQRouter::_UpdateNOQ(int input, int vc, Flit const * f) {
   assert(f);
   assert(f->vc == vc);
   assert(f->head);
-  set<OutputSet::sSetElement> sl = f->la_route_set.GetSet();
-  assert(sl.size() == 1);
-  int out_port = sl.begin()->output_port;
+  assert(f->la_route_set.size() == 1);
+  int out_port = f->la_route_set.begin()->output_port;
   const FlitChannel * channel = _output_channels[out_port];
   const Router * router = channel->GetSink();
   if(router) {
     int in_channel = channel->GetSinkPort();
     OutputSet nos;
     _rf(router, f, in_channel, &nos, false);
-    sl = nos.GetSet();
-    assert(sl.size() == 1);
-    OutputSet::sSetElement const & se = *sl.begin();
+    assert(nos.size() == 1);
+    OutputSet::sSetElement const & se = *nos.begin();
     int next_output_port = se.output_port;
     assert(next_output_port >= 0);
     assert(_noq_next_output_port[input][vc] < 0);
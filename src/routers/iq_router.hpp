@@ -35,6 +35,7 @@
 #include <map>
 
 #include "router.hpp"
+#include "ring_buffer.hpp"
 #include "routefunc.hpp"
 
 using namespace std;
@@ -67,18 +68,52 @@ class IQRouter : public Router {
   int _vc_alloc_delay;
   int _sw_alloc_delay;
   
-  map<int, Flit *> _in_queue_flits;
-
-  deque<pair<int, pair<Credit *, int> > > _proc_credits;
-
-  deque<pair<int, pair<int, int> > > _route_vcs;
-  deque<pair<int, pair<pair<int, int>, int> > > _vc_alloc_vcs;  
-  deque<pair<int, pair<pair<int, int>, int> > > _sw_hold_vcs;
-  deque<pair<int, pair<pair<int, int>, int> > > _sw_alloc_vcs;
-
-  deque<pair<int, pair<Flit *, pair<int, int> > > > _crossbar_flits;
-
-  map<int, Credit *> _out_queue_credits;
+  // a VC waiting in one of the pipeline stages; the time at which the stage
+  // completes is -1 until the stage has been evaluated for it, and the
+  // result is the assigned output (VC) or a stall reason
+  struct sPipelineVC {
+    int time;
+    int input;
+    int vc;
+    int result;
+    sPipelineVC( int t = -1, int i = -1, int v = -1, int r = -1 )
+      : time(t), input(i), vc(v), result(r) {}
+    void Serialize( Checkpoint & cp );
+  };
+
+  struct sCrossbarFlit {
+    int time;
+    Flit * f;
+    int expanded_input;
+    int expanded_output;
+    sCrossbarFlit( int t = -1, Flit * flit = NULL, int in = -1, int out = -1 )
+      : time(t), f(flit), expanded_input(in), expanded_output(out) {}
+    void Serialize( Checkpoint & cp );
+  };
+
+  struct sPendingCredit {
+    int time;
+    Credit * c;
+    int output;
+    sPendingCredit( int t = -1, Credit * cred = NULL, int out = -1 )
+      : time(t), c(cred), output(out) {}
+    void Serialize( Checkpoint & cp );
+  };
+
+  // flits received this cycle, by input (NULL if none)
+  vector<Flit *> _in_queue_flits;
+
+  RingBuffer<sPendingCredit> _proc_credits;
+
+  RingBuffer<sPipelineVC> _route_vcs;
+  RingBuffer<sPipelineVC> _vc_alloc_vcs;  
+  RingBuffer<sPipelineVC> _sw_hold_vcs;
+  RingBuffer<sPipelineVC> _sw_alloc_vcs;
+
+  RingBuffer<sCrossbarFlit> _crossbar_flits;
+
+  // credits to be returned this cycle, by input (NULL if none)
+  vector<Credit *> _out_queue_credits;
 
   vector<Buffer *> _buf;
   vector<BufferState *> _next_buf;
@@ -93,9 +128,11 @@ class IQRouter : public Router {
   tRoutingFunction   _rf;
 
   int _output_buffer_size;
-  vector<queue<Flit *> > _output_buffer;
+  vector<RingBuffer<Flit *> > _output_buffer;
+  vector<Flit *> _output_buffer_storage;
 
-  vector<queue<Credit *> > _credit_buffer;
+  vector<RingBuffer<Credit *> > _credit_buffer;
+  vector<Credit *> _credit_buffer_storage;
 
   bool _hold_switch_for_packet;
   vector<int> _switch_hold_in;
@@ -111,6 +148,8 @@ class IQRouter : public Router {
   vector<vector<queue<int> > > _outstanding_classes;
 #endif
 
+  template<class T> void _SerializeStage( Checkpoint & cp, RingBuffer<T> & stage );
+
   bool _ReceiveFlits( );
   bool _ReceiveCredits( );
 
@@ -160,9 +199,13 @@ public:
 
   virtual void ReadInputs( );
   virtual void WriteOutputs( );
+
+  virtual bool IsIdle( ) const;
   
   void Display( ostream & os = cout ) const;
 
+  virtual void Serialize( Checkpoint & cp );
+
   virtual int GetUsedCredit(int o) const;
   virtual int GetBufferOccupancy(int i) const;
 
@@ -90,6 +90,9 @@ protected:
 
   virtual void _InternalStep() = 0;
 
+  // state kept by every router implementation, for use by their Serialize()
+  void _SerializeCommon( Checkpoint & cp );
+
 public:
   Router( const Configuration& config,
 	  Module *parent, const string & name, int id,
@@ -0,0 +1,73 @@
+// $Id$
+
+/*
+ Copyright (c) 2007-2012, Trustees of The Leland Stanford Junior University
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ Redistributions of source code must retain the above copyright notice, this 
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice, this
+ list of conditions and the following disclaimer in the documentation and/or
+ other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE 
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "simulation_context.hpp"
+
+SimulationContext::SimulationContext( const Configuration & config )
+  : _clock(0), _topology(0)
+{
+  _num_vcs = config.GetInt( "num_vcs" );
+
+  _begin_vc[Flit::ANY_TYPE] = 0;
+  _end_vc[Flit::ANY_TYPE] = _num_vcs - 1;
+
+  //
+  // traffic class partitions
+  //
+  _begin_vc[Flit::READ_REQUEST] = config.GetInt("read_request_begin_vc");
+  if(_begin_vc[Flit::READ_REQUEST] < 0) {
+    _begin_vc[Flit::READ_REQUEST] = 0;
+  }
+  _end_vc[Flit::READ_REQUEST] = config.GetInt("read_request_end_vc");
+  if(_end_vc[Flit::READ_REQUEST] < 0) {
+    _end_vc[Flit::READ_REQUEST] = _num_vcs / 2 - 1;
+  }
+  _begin_vc[Flit::WRITE_REQUEST] = config.GetInt("write_request_begin_vc");
+  if(_begin_vc[Flit::WRITE_REQUEST] < 0) {
+    _begin_vc[Flit::WRITE_REQUEST] = 0;
+  }
+  _end_vc[Flit::WRITE_REQUEST] = config.GetInt("write_request_end_vc");
+  if(_end_vc[Flit::WRITE_REQUEST] < 0) {
+    _end_vc[Flit::WRITE_REQUEST] = _num_vcs / 2 - 1;
+  }
+  _begin_vc[Flit::READ_REPLY] = config.GetInt("read_reply_begin_vc");
+  if(_begin_vc[Flit::READ_REPLY] < 0) {
+    _begin_vc[Flit::READ_REPLY] = _num_vcs / 2;
+  }
+  _end_vc[Flit::READ_REPLY] = config.GetInt("read_reply_end_vc");
+  if(_end_vc[Flit::READ_REPLY] < 0) {
+    _end_vc[Flit::READ_REPLY] = _num_vcs - 1;
+  }
+  _begin_vc[Flit::WRITE_REPLY] = config.GetInt("write_reply_begin_vc");
+  if(_begin_vc[Flit::WRITE_REPLY] < 0) {
+    _begin_vc[Flit::WRITE_REPLY] = _num_vcs / 2;
+  }
+  _end_vc[Flit::WRITE_REPLY] = config.GetInt("write_reply_end_vc");
+  if(_end_vc[Flit::WRITE_REPLY] < 0) {
+    _end_vc[Flit::WRITE_REPLY] = _num_vcs - 1;
+  }
+}
@@ -0,0 +1,83 @@
+// $Id$
+
+/*
+ Copyright (c) 2007-2012, Trustees of The Leland Stanford Junior University
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ Redistributions of source code must retain the above copyright notice, this 
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice, this
+ list of conditions and the following disclaimer in the documentation and/or
+ other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE 
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*simulation_context.hpp
+ *
+ *State that belongs to a single simulation rather than to the process:
+ *the simulation clock, the virtual channel partitions of the message
+ *types and the topology consulted by the routing functions. Top-level
+ *modules are given the context on construction and all other modules
+ *inherit it from their parent, so several simulations can coexist in
+ *one process.
+ *
+ */
+
+#ifndef _SIMULATION_CONTEXT_HPP_
+#define _SIMULATION_CONTEXT_HPP_
+
+#include <cassert>
+
+#include "flit.hpp"
+#include "config_utils.hpp"
+
+class Network;
+
+class SimulationContext {
+
+  int const * _clock;
+
+  Network const * _topology;
+
+  int _num_vcs;
+  int _begin_vc[Flit::NUM_FLIT_TYPES];
+  int _end_vc[Flit::NUM_FLIT_TYPES];
+
+public:
+  SimulationContext( const Configuration & config );
+
+  // the clock is owned by the traffic manager driving the simulation
+  inline void SetClock( int const * clock ) { _clock = clock; }
+  inline int GetSimTime( ) const {
+    assert(_clock);
+    return *_clock;
+  }
+
+  // all subnetworks of a simulation share the same topology
+  inline void SetTopology( Network const * net ) { _topology = net; }
+  inline Network const * GetTopology( ) const {
+    assert(_topology);
+    return _topology;
+  }
+
+  inline int NumVCs( ) const { return _num_vcs; }
+
+  // range of virtual channels flits of the given type may use
+  inline int BeginVC( Flit::FlitType type ) const { return _begin_vc[type]; }
+  inline int EndVC( Flit::FlitType type ) const { return _end_vc[type]; }
+};
+
+#endif
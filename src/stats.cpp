@@ -41,6 +41,7 @@
 #include <cstdio>
 
 #include "stats.hpp"
+#include "checkpoint.hpp"
 
 Stats::Stats( Module *parent, const string &name,
 	      double bin_size, int num_bins ) :
@@ -114,6 +115,16 @@ void Stats::AddSample( double val )
   _hist[b]++;
 }
 
+void Stats::Serialize( Checkpoint & cp )
+{
+  cp.Sync( _num_samples );
+  cp.Sync( _sample_sum );
+  cp.Sync( _sample_squared_sum );
+  cp.Sync( _min );
+  cp.Sync( _max );
+  cp.Sync( _hist );
+}
+
 void Stats::Display( ostream & os ) const
 {
   os << *this << endl;
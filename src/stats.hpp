@@ -30,6 +30,8 @@
 
 #include "module.hpp"
 
+class Checkpoint;
+
 class Stats : public Module {
   int    _num_samples;
   double _sample_sum;
@@ -67,6 +69,8 @@ public:
 
   void Display( ostream & os = cout ) const;
 
+  void Serialize( Checkpoint & cp );
+
   friend ostream & operator<<(ostream & os, const Stats & s);
 
 };
@@ -0,0 +1,116 @@
+// $Id$
+
+/*
+ Copyright (c) 2007-2012, Trustees of The Leland Stanford Junior University
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ Redistributions of source code must retain the above copyright notice, this 
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice, this
+ list of conditions and the following disclaimer in the documentation and/or
+ other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE 
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <iostream>
+#include <cstdlib>
+#include <cassert>
+#include <sched.h>
+
+#include "thread_pool.hpp"
+
+using namespace std;
+
+// number of busy-wait iterations before a waiting thread starts yielding;
+// phases are typically only a few microseconds long, so spinning briefly is
+// much cheaper than sleeping on a condition variable
+#define SPIN_LIMIT 4096
+
+ThreadPool::ThreadPool(int threads)
+  : _threads(threads), _task(0), _generation(0), _pending(0), _quit(false)
+{
+  assert(threads >= 1);
+  _handles.resize(threads);
+  _workers.resize(threads);
+  for(int t = 1; t < threads; ++t) {
+    _workers[t].pool = this;
+    _workers[t].part = t;
+    if(pthread_create(&_handles[t], NULL, &_WorkerMain, &_workers[t])) {
+      cerr << "Error: Unable to create worker thread " << t << "." << endl;
+      exit(-1);
+    }
+  }
+}
+
+ThreadPool::~ThreadPool()
+{
+  _quit = true;
+  __sync_synchronize();
+  __sync_fetch_and_add(&_generation, 1);
+  for(int t = 1; t < _threads; ++t) {
+    pthread_join(_handles[t], NULL);
+  }
+}
+
+void ThreadPool::Run(Task * task)
+{
+  if(_threads == 1) {
+    task->Run(0);
+    return;
+  }
+  _task = task;
+  _pending = _threads - 1;
+  __sync_synchronize();
+  __sync_fetch_and_add(&_generation, 1);
+
+  task->Run(0);
+
+  int spins = 0;
+  while(_pending > 0) {
+    if(++spins > SPIN_LIMIT) {
+      sched_yield();
+    }
+  }
+  __sync_synchronize();
+}
+
+void * ThreadPool::_WorkerMain(void * arg)
+{
+  sWorker * w = (sWorker *)arg;
+  w->pool->_Work(w->part);
+  return NULL;
+}
+
+void ThreadPool::_Work(int part)
+{
+  unsigned seen = 0;
+  while(true) {
+    int spins = 0;
+    while(_generation == seen) {
+      if(++spins > SPIN_LIMIT) {
+	sched_yield();
+      }
+    }
+    seen = _generation;
+    __sync_synchronize();
+    if(_quit) {
+      break;
+    }
+    _task->Run(part);
+    __sync_synchronize();
+    __sync_fetch_and_sub(&_pending, 1);
+  }
+}
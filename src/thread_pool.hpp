@@ -0,0 +1,87 @@
+// $Id$
+
+/*
+ Copyright (c) 2007-2012, Trustees of The Leland Stanford Junior University
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ Redistributions of source code must retain the above copyright notice, this 
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice, this
+ list of conditions and the following disclaimer in the documentation and/or
+ other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE 
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*thread_pool.hpp
+ *
+ *A small pool of persistent worker threads used to evaluate independent
+ *parts of the simulation concurrently. Run() hands the same task to every
+ *thread (the calling thread takes part 0) and returns once all parts have
+ *completed, so consecutive calls act as barriers between phases.
+ *
+ */
+
+#ifndef _THREAD_POOL_HPP_
+#define _THREAD_POOL_HPP_
+
+#include <vector>
+#include <pthread.h>
+
+class ThreadPool {
+
+public:
+
+  class Task {
+  public:
+    virtual ~Task() {}
+    virtual void Run(int part) = 0;
+  };
+
+  ThreadPool(int threads);
+  ~ThreadPool();
+
+  inline int NumThreads() const {
+    return _threads;
+  }
+
+  void Run(Task * task);
+
+private:
+
+  struct sWorker {
+    ThreadPool * pool;
+    int part;
+  };
+
+  int _threads;
+
+  std::vector<pthread_t> _handles;
+  std::vector<sWorker> _workers;
+
+  Task * volatile _task;
+  volatile unsigned _generation;
+  volatile int _pending;
+  volatile bool _quit;
+
+  static void * _WorkerMain(void * arg);
+  void _Work(int part);
+
+  ThreadPool(ThreadPool const &);
+  ThreadPool & operator=(ThreadPool const &);
+
+};
+
+#endif
@@ -30,15 +30,45 @@
 
 #include "module.hpp"
 
+class Checkpoint;
+
 class TimedModule : public Module {
 
+  // entry in the owner's active set, if the owner schedules by activity
+  unsigned long long * _active_word;
+  unsigned long long _active_bit;
+
 public:
-  TimedModule(Module * parent, string const & name) : Module(parent, name) {}
+  TimedModule(Module * parent, string const & name)
+    : Module(parent, name), _active_word(0), _active_bit(0) {}
+  TimedModule(SimulationContext * context, string const & name)
+    : Module(context, name), _active_word(0), _active_bit(0) {}
   virtual ~TimedModule() {}
   
   virtual void ReadInputs() = 0;
   virtual void Evaluate() = 0;
   virtual void WriteOutputs() = 0;
+
+  inline void SetActiveBit(unsigned long long * word, int bit) {
+    _active_word = word;
+    _active_bit = 1ULL << bit;
+  }
+
+  // Schedules the module for the following phases after new work arrived
+  inline void Wakeup() {
+    if(_active_word) {
+      *_active_word |= _active_bit;
+    }
+  }
+
+  // A module that is idle after WriteOutputs() has nothing to do until its
+  // next Wakeup(), so its owner may stop calling it
+  virtual bool IsIdle() const { return false; }
+
+  // Saves or restores the module's state between two cycles
+  virtual void Serialize(Checkpoint & cp) {
+    Error("Checkpoints are not supported by this module.");
+  }
 };
 
 #endif
@@ -0,0 +1,96 @@
+// $Id$
+
+/*
+ Copyright (c) 2007-2012, Trustees of The Leland Stanford Junior University
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ Redistributions of source code must retain the above copyright notice, this 
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice, this
+ list of conditions and the following disclaimer in the documentation and/or
+ other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE 
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/////
+//
+//  File Name: timing_wheel.hpp
+//
+//  A TimingWheel schedules callbacks a bounded number of cycles into the
+//   future. Each cycle maps to one bucket, so scheduling and advancing are
+//   proportional to the number of callbacks rather than to the number of
+//   clients.
+//
+/////
+
+#ifndef _TIMING_WHEEL_HPP_
+#define _TIMING_WHEEL_HPP_
+
+#include <vector>
+#include <cassert>
+
+using namespace std;
+
+class TimingWheel {
+public:
+  class Client {
+  public:
+    virtual ~Client() {}
+    virtual void Expire(int time) = 0;
+  };
+
+  TimingWheel() : _mask(0), _buckets(1) {}
+
+  // Allow callbacks up to the given number of cycles ahead of the current one
+  void SetHorizon(int cycles) {
+    assert(Empty());
+    int size = 1;
+    while(size <= cycles) {
+      size <<= 1;
+    }
+    _buckets.resize(size);
+    _mask = size - 1;
+  }
+
+  inline void Schedule(int time, Client * c) {
+    _buckets[time & _mask].push_back(c);
+  }
+
+  // Invoke every callback scheduled for the given cycle
+  inline void Advance(int time) {
+    _due.swap(_buckets[time & _mask]);
+    for(size_t i = 0; i < _due.size(); ++i) {
+      _due[i]->Expire(time);
+    }
+    _due.clear();
+  }
+
+  bool Empty() const {
+    for(size_t i = 0; i < _buckets.size(); ++i) {
+      if(!_buckets[i].empty()) {
+	return false;
+      }
+    }
+    return true;
+  }
+
+private:
+  int _mask;
+  vector<vector<Client *> > _buckets;
+  vector<Client *> _due;
+};
+
+#endif
@@ -0,0 +1,129 @@
+// $Id$
+
+/*
+ Copyright (c) 2007-2012, Trustees of The Leland Stanford Junior University
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ Redistributions of source code must retain the above copyright notice, this 
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice, this
+ list of conditions and the following disclaimer in the documentation and/or
+ other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE 
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "trace_reader.hpp"
+
+// consumed parts of the trace are released in chunks of this size (a
+// multiple of any page size)
+static size_t const gReleaseChunk = 64 << 20;
+
+TraceReader::TraceReader( string const & filename )
+  : _filename(filename)
+{
+  int const fd = open(filename.c_str(), O_RDONLY);
+  if(fd < 0) {
+    cout << "Error: Unable to open trace file: " << filename << endl;
+    exit(-1);
+  }
+  struct stat st;
+  if(fstat(fd, &st) != 0) {
+    cout << "Error: Unable to determine size of trace file: " << filename << endl;
+    exit(-1);
+  }
+  _bytes = (size_t)st.st_size;
+  if(_bytes < sizeof(sTraceHeader)) {
+    cout << "Error: Not a trace file: " << filename << endl;
+    exit(-1);
+  }
+  void * const base = mmap(NULL, _bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if(base == MAP_FAILED) {
+    cout << "Error: Unable to map trace file: " << filename << endl;
+    exit(-1);
+  }
+  _base = (char *)base;
+  madvise(_base, _bytes, MADV_SEQUENTIAL);
+
+  sTraceHeader const * const header = (sTraceHeader const *)_base;
+  if(strncmp(header->magic, TRACE_MAGIC, sizeof(header->magic)) != 0) {
+    cout << "Error: Not a trace file: " << filename << endl;
+    exit(-1);
+  }
+  if((header->version != TRACE_VERSION) || 
+     (header->record_size != sizeof(sTraceRecord))) {
+    cout << "Error: Unsupported trace format in trace file: " << filename
+	 << " (convert it again with trace2bin)" << endl;
+    exit(-1);
+  }
+  size_t const data = _bytes - sizeof(sTraceHeader);
+  if((data % sizeof(sTraceRecord)) != 0) {
+    cout << "Error: Truncated trace file: " << filename << endl;
+    exit(-1);
+  }
+  _begin = (sTraceRecord const *)(_base + sizeof(sTraceHeader));
+  _end = _begin + data / sizeof(sTraceRecord);
+
+  Rewind();
+}
+
+TraceReader::~TraceReader( )
+{
+  munmap(_base, _bytes);
+}
+
+void TraceReader::Rewind( )
+{
+  _next = _begin;
+  _released = _base;
+  _last_cycle = 0;
+}
+
+sTraceRecord TraceReader::Next( )
+{
+  sTraceRecord const r = *_next;
+  if(r.cycle > (unsigned int)numeric_limits<int>::max()) {
+    cout << "Error: Invalid cycle in record " << Position()
+	 << " of trace file: " << _filename << endl;
+    exit(-1);
+  }
+  if(r.cycle < _last_cycle) {
+    cout << "Error: Record " << Position() << " out of order in trace file: "
+	 << _filename << endl;
+    exit(-1);
+  }
+  _last_cycle = r.cycle;
+  ++_next;
+
+  // the pages before the current record are not read again until the
+  // next Rewind()
+  if((char const *)_next - _released >= (ptrdiff_t)(2 * gReleaseChunk)) {
+    madvise(_released, gReleaseChunk, MADV_DONTNEED);
+    _released += gReleaseChunk;
+  }
+  return r;
+}
@@ -0,0 +1,120 @@
+// $Id$
+
+/*
+ Copyright (c) 2007-2012, Trustees of The Leland Stanford Junior University
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ Redistributions of source code must retain the above copyright notice, this 
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice, this
+ list of conditions and the following disclaimer in the documentation and/or
+ other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE 
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+/*trace_reader.hpp
+ *
+ *Sequential reader for binary packet traces. A trace file consists of a
+ *sTraceHeader followed by sTraceRecords sorted by cycle, all in the byte
+ *order of the host that wrote them; utils/trace2bin.cpp converts text
+ *traces into this format.
+ *
+ *The file is memory-mapped rather than read into memory, and the pages
+ *behind the read position are handed back to the kernel as the trace is
+ *replayed, so the size of a trace is not limited by the available RAM.
+ *
+ */
+
+#ifndef _TRACE_READER_HPP_
+#define _TRACE_READER_HPP_
+
+#include <string>
+#include <cstddef>
+
+using namespace std;
+
+#define TRACE_MAGIC "BSIMTRC"
+#define TRACE_VERSION 1
+
+struct sTraceHeader {
+  char magic[8];            // TRACE_MAGIC, zero-terminated
+  unsigned int version;     // TRACE_VERSION
+  unsigned int record_size; // sizeof(sTraceRecord)
+};
+
+// packet types of trace records
+enum eTraceType { trace_any = 0, trace_read = 1, trace_write = 2 };
+
+struct sTraceRecord {
+  unsigned int cycle;
+  unsigned int source;
+  unsigned int dest;
+  unsigned short size;      // in flits; 0 uses the size of the class
+  unsigned char cl;
+  unsigned char type;       // eTraceType
+};
+
+class TraceReader {
+
+public:
+
+  TraceReader( string const & filename );
+  ~TraceReader( );
+
+  // restart from the first record
+  void Rewind( );
+
+  inline bool Done( ) const {
+    return _next == _end;
+  }
+
+  inline sTraceRecord const & Peek( ) const {
+    return *_next;
+  }
+
+  // the next record; records must not go back in time
+  sTraceRecord Next( );
+
+  // number of records read since the last Rewind()
+  inline long long Position( ) const {
+    return _next - _begin;
+  }
+  inline long long Records( ) const {
+    return _end - _begin;
+  }
+
+  inline string const & GetFilename( ) const {
+    return _filename;
+  }
+
+private:
+
+  string _filename;
+
+  char * _base;
+  size_t _bytes;
+
+  sTraceRecord const * _begin;
+  sTraceRecord const * _end;
+  sTraceRecord const * _next;
+
+  // start of the pages that have not been released yet
+  char * _released;
+
+  unsigned int _last_cycle;
+
+};
+
+#endif
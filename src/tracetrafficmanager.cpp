@@ -0,0 +1,202 @@
+// $Id$
+
+/*
+ Copyright (c) 2007-2012, Trustees of The Leland Stanford Junior University
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ Redistributions of source code must retain the above copyright notice, this 
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice, this
+ list of conditions and the following disclaimer in the documentation and/or
+ other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE 
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <iostream>
+#include <sstream>
+
+#include "packet_reply_info.hpp"
+#include "tracetrafficmanager.hpp"
+
+TraceTrafficManager::TraceTrafficManager( const Configuration &config, 
+					  const vector<Network *> & net )
+: TrafficManager(config, net)
+{
+  if(!config.GetStr("flow_file").empty()) {
+    Error( "Flow files are not supported in trace mode." );
+  }
+  if(((config.GetInt("checkpoint_period") > 0) && 
+      !config.GetStr("checkpoint_file").empty()) ||
+     !config.GetStr("resume_from").empty()) {
+    Error( "Checkpoints are not supported in trace mode." );
+  }
+
+  string const trace_file = config.GetStr("trace_file");
+  if(trace_file.empty()) {
+    Error( "Trace mode requires a trace_file." );
+  }
+  _trace = new TraceReader(trace_file);
+
+  for(int c = 0; c < _classes; ++c) {
+    if(_use_read_write[c]) {
+      _reply_classes.push_back(c);
+    }
+  }
+}
+
+TraceTrafficManager::~TraceTrafficManager( )
+{
+  delete _trace;
+}
+
+void TraceTrafficManager::_CheckRecord( sTraceRecord const & r ) const
+{
+  bool valid = ((int)r.source < _nodes) && ((int)r.dest < _nodes) &&
+    ((int)r.cl < _classes);
+  if(valid) {
+    valid = _use_read_write[r.cl] ? 
+      ((r.type == trace_read) || (r.type == trace_write)) : 
+      (r.type == trace_any);
+  }
+  if(!valid) {
+    ostringstream err;
+    err << "Invalid record " << _trace->Position() - 1 
+	<< " in trace file: " << _trace->GetFilename();
+    Error( err.str( ) );
+  }
+}
+
+bool TraceTrafficManager::_RepliesPending( ) const
+{
+  for(int n = 0; n < _nodes; ++n) {
+    if(!_repliesPending[n].empty()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Same queuing behavior as _InjectFlows(): a (source, class) queue takes its
+// next packet only once it is empty, and packets that had to wait keep the
+// cycle of their record as creation time. Only queues with a record due are
+// visited.
+void TraceTrafficManager::_Inject( )
+{
+  // as in _IssuePacket(), replies go ahead of new requests
+  if(!_reply_classes.empty()) {
+    for(int n = 0; n < _nodes; ++n) {
+      for(size_t i = 0; i < _reply_classes.size(); ++i) {
+	if(_repliesPending[n].empty() ||
+	   (_repliesPending[n].front()->time > _time)) {
+	  break;
+	}
+	int const c = _reply_classes[i];
+	if(_partial_packets[n][c].empty()) {
+	  _packet_seq_no[n]++;
+	  // destination, size and creation time follow from the request
+	  _GeneratePacket(n, -1, c, _time, -1, 0);
+	}
+      }
+    }
+  }
+
+  while(!_trace->Done() && ((int)_trace->Peek().cycle <= _time)) {
+    sTraceRecord const r = _trace->Next();
+    _CheckRecord(r);
+    _waiting[r.source * _classes + r.cl].push_back(r);
+  }
+
+  map<int, deque<sTraceRecord> >::iterator iter = _waiting.begin();
+  while(iter != _waiting.end()) {
+    int const input = iter->first / _classes;
+    int const c = iter->first % _classes;
+    if(!_partial_packets[input][c].empty()) {
+      ++iter;
+      continue;
+    }
+    sTraceRecord const & r = iter->second.front();
+    int size = r.size;
+    if((size == 0) && !_use_read_write[c]) {
+      size = _GetNextPacketSize(input, c);
+    }
+    _requestsOutstanding[input]++;
+    _packet_seq_no[input]++;
+    _GeneratePacket(input, _use_read_write[c] ? r.type : 1, c,
+		    _include_queuing==1 ? (int)r.cycle : _time,
+		    r.dest, size);
+    iter->second.pop_front();
+    if(iter->second.empty()) {
+      _waiting.erase(iter++);
+    } else {
+      ++iter;
+    }
+  }
+}
+
+// skips to the cycle of the next record while there is nothing else to do
+int TraceTrafficManager::_FastForward( int max_cycles )
+{
+  if((max_cycles <= 0) || _trace->Done() || !_waiting.empty() || 
+     _RepliesPending() || !_NetworkIdle()) {
+    return 0;
+  }
+  int const next = (int)_trace->Peek().cycle;
+  int const horizon = (next - _time < max_cycles) ? next : _time + max_cycles;
+  if(horizon <= _time) {
+    return 0;
+  }
+  int const skipped = horizon - _time;
+  _time = horizon;
+  return skipped;
+}
+
+bool TraceTrafficManager::_SingleSim( )
+{
+  _trace->Rewind();
+  _waiting.clear();
+  _sim_state = running;
+
+  cout << "Replaying " << _trace->Records() << " packets from trace file "
+       << _trace->GetFilename() << "..." << endl;
+
+  int next_report = _time + _sample_period;
+  bool packets_left = true;
+  while(packets_left) {
+    if(_idle_fast_forward) {
+      _FastForward(next_report - _time - 1);
+    }
+    _Step();
+
+    if(_time >= next_report) {
+      cout << "Time " << _time << ": " << _trace->Position() << " of "
+	   << _trace->Records() << " packets released" << endl;
+      next_report += _sample_period;
+    }
+
+    packets_left = !_trace->Done() || !_waiting.empty() || _RepliesPending();
+    for(int c = 0; c < _classes; ++c) {
+      packets_left |= !_total_in_flight_flits[c].empty();
+    }
+  }
+  cout << "Trace replayed. Time used is " << _time << " cycles." << endl;
+
+  UpdateStats();
+  DisplayStats();
+
+  _sim_state = draining;
+  _drain_time = _time;
+  return 1;
+}
@@ -0,0 +1,68 @@
+// $Id$
+
+/*
+ Copyright (c) 2007-2012, Trustees of The Leland Stanford Junior University
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ Redistributions of source code must retain the above copyright notice, this 
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice, this
+ list of conditions and the following disclaimer in the documentation and/or
+ other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE 
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef _TRACETRAFFICMANAGER_HPP_
+#define _TRACETRAFFICMANAGER_HPP_
+
+#include <map>
+#include <deque>
+
+#include "config_utils.hpp"
+#include "trafficmanager.hpp"
+#include "trace_reader.hpp"
+
+// Replays the packets of a binary trace file (see trace_reader.hpp) instead
+// of using the injection processes and traffic patterns, and ends once every
+// packet of the trace has been delivered.
+class TraceTrafficManager : public TrafficManager {
+
+protected:
+
+  TraceReader * _trace;
+
+  // records that are due but wait for their (source, class) queue, by queue
+  // (source * classes + class)
+  map<int, deque<sTraceRecord> > _waiting;
+
+  // classes whose replies are injected by _Inject()
+  vector<int> _reply_classes;
+
+  void _CheckRecord( sTraceRecord const & r ) const;
+  bool _RepliesPending( ) const;
+
+  virtual void _Inject( );
+  virtual int _FastForward( int max_cycles );
+  virtual bool _SingleSim( );
+
+public:
+
+  TraceTrafficManager( const Configuration &config, const vector<Network *> & net );
+  virtual ~TraceTrafficManager( );
+
+};
+
+#endif
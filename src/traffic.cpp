@@ -29,6 +29,7 @@
 #include <sstream>
 #include "random_utils.hpp"
 #include "traffic.hpp"
+#include "checkpoint.hpp"
 
 TrafficPattern::TrafficPattern(int nodes)
 : _nodes(nodes)
@@ -44,8 +45,19 @@ void TrafficPattern::reset()
 
 }
 
+bool TrafficPattern::active(int source) const
+{
+  return true;
+}
+
+void TrafficPattern::serialize(Checkpoint & cp)
+{
+  cp.Sync(_random);
+}
+
 TrafficPattern * TrafficPattern::New(string const & pattern, int nodes, 
-				     Configuration const * const config)
+				     Configuration const * const config,
+				     int cl)
 {
   string pattern_name;
   string param_str;
@@ -190,12 +202,21 @@ TrafficPattern * TrafficPattern::New(string const & pattern, int nodes,
       rates.resize(hotspots.size(), 1);
     }
     result = new HotSpotTrafficPattern(nodes, hotspots, rates);
-  } else if(pattern_name == "customizedpattern") {
-    result=new CustomizedTrafficPattern(nodes);
+  } else if(pattern_name == "pair") {
+    if(params.size() < 2) {
+      cout << "Error: Missing parameters for pair traffic pattern: " << pattern << endl;
+      exit(-1);
+    }
+    int const source = atoi(params[0].c_str());
+    int const dest = atoi(params[1].c_str());
+    result = new PairTrafficPattern(nodes, source, dest);
   } else {
     cout << "Error: Unknown traffic pattern: " << pattern << endl;
     exit(-1);
   }
+  for(int n = 0; n < nodes; ++n) {
+    result->_random.push_back(RandomStream(random_traffic, n, cl));
+  }
   return result;
 }
 
@@ -387,7 +408,7 @@ UniformRandomTrafficPattern::UniformRandomTrafficPattern(int nodes)
 int UniformRandomTrafficPattern::dest(int source,int cl)
 {
   assert((source >= 0) && (source < _nodes));
-  return RandomInt(_nodes - 1);
+  return _random[source].Int(_nodes - 1);
 }
 
 UniformBackgroundTrafficPattern::UniformBackgroundTrafficPattern(int nodes, vector<int> excluded_nodes)
@@ -407,7 +428,7 @@ int UniformBackgroundTrafficPattern::dest(int source,int cl)
   int result;
 
   do {
-    result = RandomInt(_nodes - 1);
+    result = _random[source].Int(_nodes - 1);
   } while(_excluded.count(result) > 0);
 
   return result;
@@ -422,7 +443,7 @@ DiagonalTrafficPattern::DiagonalTrafficPattern(int nodes)
 int DiagonalTrafficPattern::dest(int source,int cl)
 {
   assert((source >= 0) && (source < _nodes));
-  return ((RandomInt(2) == 0) ? ((source + 1) % _nodes) : source);
+  return ((_random[source].Int(2) == 0) ? ((source + 1) % _nodes) : source);
 }
 
 AsymmetricTrafficPattern::AsymmetricTrafficPattern(int nodes)
@@ -435,7 +456,7 @@ int AsymmetricTrafficPattern::dest(int source,int cl)
 {
   assert((source >= 0) && (source < _nodes));
   int const half = _nodes / 2;
-  return (source % half) + (RandomInt(1) ? half : 0);
+  return (source % half) + (_random[source].Int(1) ? half : 0);
 }
 
 Taper64TrafficPattern::Taper64TrafficPattern(int nodes)
@@ -451,10 +472,10 @@ Taper64TrafficPattern::Taper64TrafficPattern(int nodes)
 int Taper64TrafficPattern::dest(int source,int cl)
 {
   assert((source >= 0) && (source < _nodes));
-  if(RandomInt(1)) {
-    return ((64 + source + 8 * (RandomInt(2) - 1) + (RandomInt(2) - 1)) % 64);
+  if(_random[source].Int(1)) {
+    return ((64 + source + 8 * (_random[source].Int(2) - 1) + (_random[source].Int(2) - 1)) % 64);
   } else {
-    return RandomInt(_nodes - 1);
+    return _random[source].Int(_nodes - 1);
   }
 }
 
@@ -471,7 +492,7 @@ int BadPermDFlyTrafficPattern::dest(int source,int cl)
   int const grp_size_routers = 2 * _k;
   int const grp_size_nodes = grp_size_routers * _k;
 
-  return ((RandomInt(grp_size_nodes - 1) + ((source / grp_size_nodes) + 1) * grp_size_nodes) % _nodes);
+  return ((_random[source].Int(grp_size_nodes - 1) + ((source / grp_size_nodes) + 1) * grp_size_nodes) % _nodes);
 }
 
 BadPermYarcTrafficPattern::BadPermYarcTrafficPattern(int nodes, int k, int n, 
@@ -485,7 +506,28 @@ int BadPermYarcTrafficPattern::dest(int source,int cl)
 {
   assert((source >= 0) && (source < _nodes));
   int const row = source / (_xr * _k);
-  return RandomInt((_xr * _k) - 1) * (_xr * _k) + row;
+  return _random[source].Int((_xr * _k) - 1) * (_xr * _k) + row;
+}
+
+PairTrafficPattern::PairTrafficPattern(int nodes, int source, int dest)
+  : TrafficPattern(nodes), _source(source), _dest(dest)
+{
+  if((source < 0) || (source >= nodes) || (dest < 0) || (dest >= nodes)) {
+    cout << "Error: Invalid source or destination for pair traffic pattern." 
+	 << endl;
+    exit(-1);
+  }
+}
+
+int PairTrafficPattern::dest(int source,int cl)
+{
+  assert((source >= 0) && (source < _nodes));
+  return _dest;
+}
+
+bool PairTrafficPattern::active(int source) const
+{
+  return (source == _source);
 }
 
 HotSpotTrafficPattern::HotSpotTrafficPattern(int nodes, vector<int> hotspots, 
@@ -512,7 +554,7 @@ int HotSpotTrafficPattern::dest(int source,int cl)
     return _hotspots[0];
   }
 
-  int pct = RandomInt(_max_val);
+  int pct = _random[source].Int(_max_val);
 
   for(size_t i = 0; i < (_hotspots.size() - 1); ++i) {
     int const limit = _rates[i];
@@ -525,15 +567,3 @@ int HotSpotTrafficPattern::dest(int source,int cl)
   assert(_rates.back() > pct);
   return _hotspots.back();
 }
-
-
-CustomizedTrafficPattern::CustomizedTrafficPattern(int nodes): TrafficPattern(nodes){
-    assert(nodes>=0);
-}
-
-int CustomizedTrafficPattern::dest(int source,int cl){
-    assert((cl>=0)&&(cl<26));
-    assert((source>=0)&&(source<_nodes));
-    int destination[26]={3,3,1,2,7,1,2,5,8,9,10,6,5,15,12,13,14,7,15,8,15,9,15,10,15,11};
-    return destination[cl];
-}
@@ -31,19 +31,29 @@
 #include <vector>
 #include <set>
 #include "config_utils.hpp"
+#include "random_utils.hpp"
 
 using namespace std;
 
+class Checkpoint;
+
 class TrafficPattern {
 protected:
   int _nodes;
+  // one random number stream per source
+  vector<RandomStream> _random;
   TrafficPattern(int nodes);
 public:
   virtual ~TrafficPattern() {}
   virtual void reset();
   virtual int dest(int source,int cl=0) = 0;
+  // whether the given source ever sends traffic
+  virtual bool active(int source) const;
+  // save or restore the pattern state
+  virtual void serialize(Checkpoint & cp);
   static TrafficPattern * New(string const & pattern, int nodes, 
-			      Configuration const * const config = NULL);
+			      Configuration const * const config = NULL,
+			      int cl = 0);
 };
 
 class PermutationTrafficPattern : public TrafficPattern {
@@ -160,6 +170,16 @@ public:
   virtual int dest(int source,int cl=0);
 };
 
+class PairTrafficPattern : public TrafficPattern {
+private:
+  int _source;
+  int _dest;
+public:
+  PairTrafficPattern(int nodes, int source, int dest);
+  virtual int dest(int source,int cl=0);
+  virtual bool active(int source) const;
+};
+
 class HotSpotTrafficPattern : public TrafficPattern {
 private:
   vector<int> _hotspots;
@@ -171,11 +191,4 @@ public:
   virtual int dest(int source,int cl=0);
 };
 
-class CustomizedTrafficPattern: public TrafficPattern {
-private:
-public:
-    CustomizedTrafficPattern(int nodes);
-    virtual int dest(int source,int cl=0);
-};
-
 #endif
@@ -30,14 +30,18 @@
 #include <fstream>
 #include <limits>
 #include <cstdlib>
+#include <algorithm>
 
 #include "booksim.hpp"
 #include "booksim_config.hpp"
 #include "trafficmanager.hpp"
 #include "batchtrafficmanager.hpp"
+#include "tracetrafficmanager.hpp"
 #include "random_utils.hpp" 
 #include "vc.hpp"
 #include "packet_reply_info.hpp"
+#include "checkpoint.hpp"
+#include "process_pool.hpp"
 
 TrafficManager * TrafficManager::New(Configuration const & config,
                                      vector<Network *> const & net)
@@ -48,6 +52,8 @@ TrafficManager * TrafficManager::New(Configuration const & config,
         result = new TrafficManager(config, net);
     } else if(sim_type == "batch") {
         result = new BatchTrafficManager(config, net);
+    } else if(sim_type == "trace") {
+        result = new TraceTrafficManager(config, net);
     } else {
         cerr << "Unknown simulation type: " << sim_type << endl;
     } 
@@ -55,13 +61,20 @@ TrafficManager * TrafficManager::New(Configuration const & config,
 }
 
 TrafficManager::TrafficManager( const Configuration &config, const vector<Network *> & net )
-    : Module( 0, "traffic_manager" ), _net(net), _empty_network(false), _deadlock_timer(0), _reset_time(0), _drain_time(-1), _cur_id(0), _cur_pid(0), _time(0)
+    : Module( net[0]->GetContext(), "traffic_manager" ), _net(net), _empty_network(false), _deadlock_timer(0), _reset_time(0), _drain_time(-1), _cur_id(0), _cur_pid(0), _time(0)
 {
 
+    GetContext()->SetClock(&_time);
+
     _nodes = _net[0]->NumNodes( );
     _routers = _net[0]->NumRouters( );
 
     _vcs = config.GetInt("num_vcs");
+    if(_vcs > VCMask::MAX_VCS) {
+        ostringstream err;
+        err << "At most " << VCMask::MAX_VCS << " VCs are supported.";
+        Error(err.str());
+    }
     _subnets = config.GetInt("subnets");
  
     _subnet.resize(Flit::NUM_FLIT_TYPES);
@@ -70,6 +83,12 @@ TrafficManager::TrafficManager( const Configuration &config, const vector<Networ
     _subnet[Flit::WRITE_REQUEST] = config.GetInt("write_request_subnet");
     _subnet[Flit::WRITE_REPLY] = config.GetInt("write_reply_subnet");
 
+    _subnet_pool = NULL;
+    // watch output must stay in simulation order
+    if((_subnets > 1) && (config.GetInt("parallel_subnets") > 0) && !gWatchOut) {
+        _subnet_pool = new ThreadPool(_subnets);
+    }
+
     // ============ Message priorities ============ 
 
     string priority = config.GetStr( "priority" );
@@ -205,7 +224,8 @@ TrafficManager::TrafficManager( const Configuration &config, const vector<Networ
     }
     _load.resize(_classes, _load.back());
 
-    if(config.GetInt("injection_rate_uses_flits")) {
+    _injection_rate_uses_flits = (config.GetInt("injection_rate_uses_flits") > 0);
+    if(_injection_rate_uses_flits) {
         for(int c = 0; c < _classes; ++c)
             _load[c] /= _GetAveragePacketSize(c);
     }
@@ -227,8 +247,19 @@ TrafficManager::TrafficManager( const Configuration &config, const vector<Networ
     _injection_process.resize(_classes);
 
     for(int c = 0; c < _classes; ++c) {
-        _traffic_pattern[c] = TrafficPattern::New(_traffic[c], _nodes, &config);
-        _injection_process[c] = InjectionProcess::New(injection_process[c], _nodes, _load[c], &config);
+        _traffic_pattern[c] = TrafficPattern::New(_traffic[c], _nodes, &config, c);
+        _injection_process[c] = InjectionProcess::New(injection_process[c], _nodes, _load[c], &config, c);
+    }
+
+    _flow_table = NULL;
+    string const flow_file = config.GetStr("flow_file");
+    if(!flow_file.empty()) {
+        for(int c = 0; c < _classes; ++c) {
+            if(_use_read_write[c]) {
+                Error( "Flow files cannot be combined with read/write traffic." );
+            }
+        }
+        _flow_table = new FlowTable(flow_file, _nodes, _classes);
     }
 
     // ============ Injection VC states  ============ 
@@ -277,19 +308,30 @@ TrafficManager::TrafficManager( const Configuration &config, const vector<Networ
         _partial_packets[s].resize(_classes);
     }
 
+    // filled in by _UpdateActiveSources() at the start of each simulation
+    _active_sources.resize(_classes, vector<bool>(_nodes, false));
+
     _total_in_flight_flits.resize(_classes);
-    _measured_in_flight_flits.resize(_classes);
-    _retired_packets.resize(_classes);
+    _measured_in_flight_flits.resize(_classes, 0);
+    _in_flight_ctime_sum.resize(_classes, 0);
 
     _packet_seq_no.resize(_nodes);
     _repliesPending.resize(_nodes);
     _requestsOutstanding.resize(_nodes);
 
+    _packet_random.resize(_nodes);
+    for ( int s = 0; s < _nodes; ++s ) {
+        for ( int c = 0; c < _classes; ++c ) {
+            _packet_random[s].push_back( RandomStream( random_packet, s, c ) );
+        }
+    }
+
     _hold_switch_for_packet = config.GetInt("hold_switch_for_packet");
 
     // ============ Simulation parameters ============ 
 
     _total_sims = config.GetInt( "sim_count" );
+    _sim_jobs = config.GetInt( "sim_jobs" );
 
     _router.resize(_subnets);
     for (int i=0; i < _subnets; ++i) {
@@ -305,6 +347,8 @@ TrafficManager::TrafficManager( const Configuration &config, const vector<Networ
       seed = config.GetInt("seed");
     }
     RandomSeed(seed);
+    RandomStreamSeed(seed);
+    _seed = seed;
 
     _measure_latency = (config.GetStr("sim_type") == "latency");
 
@@ -354,6 +398,43 @@ TrafficManager::TrafficManager( const Configuration &config, const vector<Networ
     _print_csv_results = config.GetInt( "print_csv_results" );
     _deadlock_warn_timeout = config.GetInt( "deadlock_warn_timeout" );
 
+    _idle_fast_forward = (config.GetInt( "idle_fast_forward" ) > 0);
+    if(_idle_fast_forward) {
+        if(config.GetStr( "router" ) != "iq") {
+            Error( "Idle fast-forward requires the iq router." );
+        }
+        double const speedup = config.GetFloat( "internal_speedup" );
+        if(speedup != floor(speedup)) {
+            Error( "Idle fast-forward requires an integer internal speedup." );
+        }
+        // the trace viewer expects a record for every cycle
+        _idle_fast_forward = !gTrace;
+    }
+
+    _warmup_handler = NULL;
+
+    _checkpoint_file = config.GetStr( "checkpoint_file" );
+    _checkpoint_period = config.GetInt( "checkpoint_period" );
+    _resume_file = config.GetStr( "resume_from" );
+    if(((_checkpoint_period > 0) && !_checkpoint_file.empty()) ||
+       !_resume_file.empty()) {
+        if(config.GetStr( "router" ) != "iq") {
+            Error( "Checkpoints require the iq router." );
+        }
+        if(config.GetStr( "sim_type" ) == "batch") {
+            Error( "Checkpoints are not supported for batch simulations." );
+        }
+        if((_sim_jobs != 1) && (_total_sims > 1)) {
+            Error( "Checkpoints require sim_jobs = 1." );
+        }
+    }
+    if((_sim_jobs != 1) && (_total_sims > 1) &&
+       (config.GetStr( "sim_type" ) == "batch")) {
+        Error( "Concurrent simulations are not supported for batch simulations." );
+    }
+    _sim = 0;
+    _resuming = false;
+
     string watch_file = config.GetStr( "watch_file" );
     if((watch_file != "") && (watch_file != "-")) {
         _LoadWatchList(watch_file);
@@ -509,6 +590,43 @@ TrafficManager::TrafficManager( const Configuration &config, const vector<Networ
     _overall_crossbar_conflict_stalls.resize(_classes, 0);
 #endif
 
+    // the statistics that are accumulated over all simulations, and their
+    // value in each simulation
+    _overall_stats.push_back(&_overall_min_plat);
+    _overall_stats.push_back(&_overall_avg_plat);
+    _overall_stats.push_back(&_overall_max_plat);
+    _overall_stats.push_back(&_overall_min_nlat);
+    _overall_stats.push_back(&_overall_avg_nlat);
+    _overall_stats.push_back(&_overall_max_nlat);
+    _overall_stats.push_back(&_overall_min_flat);
+    _overall_stats.push_back(&_overall_avg_flat);
+    _overall_stats.push_back(&_overall_max_flat);
+    _overall_stats.push_back(&_overall_min_frag);
+    _overall_stats.push_back(&_overall_avg_frag);
+    _overall_stats.push_back(&_overall_max_frag);
+    _overall_stats.push_back(&_overall_hop_stats);
+    _overall_stats.push_back(&_overall_min_sent_packets);
+    _overall_stats.push_back(&_overall_avg_sent_packets);
+    _overall_stats.push_back(&_overall_max_sent_packets);
+    _overall_stats.push_back(&_overall_min_accepted_packets);
+    _overall_stats.push_back(&_overall_avg_accepted_packets);
+    _overall_stats.push_back(&_overall_max_accepted_packets);
+    _overall_stats.push_back(&_overall_min_sent);
+    _overall_stats.push_back(&_overall_avg_sent);
+    _overall_stats.push_back(&_overall_max_sent);
+    _overall_stats.push_back(&_overall_min_accepted);
+    _overall_stats.push_back(&_overall_avg_accepted);
+    _overall_stats.push_back(&_overall_max_accepted);
+#ifdef TRACK_STALLS
+    _overall_stats.push_back(&_overall_buffer_busy_stalls);
+    _overall_stats.push_back(&_overall_buffer_conflict_stalls);
+    _overall_stats.push_back(&_overall_buffer_full_stalls);
+    _overall_stats.push_back(&_overall_buffer_reserved_stalls);
+    _overall_stats.push_back(&_overall_crossbar_conflict_stalls);
+#endif
+    _overall_samples.resize(_overall_stats.size(),
+                            vector<vector<double> >(_classes));
+
     for ( int c = 0; c < _classes; ++c ) {
         ostringstream tmp_name;
 
@@ -586,6 +704,15 @@ TrafficManager::TrafficManager( const Configuration &config, const vector<Networ
 
 TrafficManager::~TrafficManager( )
 {
+    GetContext()->SetClock(NULL);
+
+    if(_subnet_pool) {
+        delete _subnet_pool;
+    }
+
+    if(_flow_table) {
+        delete _flow_table;
+    }
 
     for ( int source = 0; source < _nodes; ++source ) {
         for ( int subnet = 0; subnet < _subnets; ++subnet ) {
@@ -638,17 +765,40 @@ TrafficManager::~TrafficManager( )
 }
 
 
-void TrafficManager::_RetireFlit( Flit *f, int dest )
+void TrafficManager::_AddInFlight( Flit * f )
 {
-    _deadlock_timer = 0;
+    vector<Flit *> & flits = _total_in_flight_flits[f->cl];
+    f->slot = flits.size();
+    flits.push_back(f);
+    _in_flight_ctime_sum[f->cl] += f->ctime;
+    if(f->record) {
+        ++_measured_in_flight_flits[f->cl];
+    }
+}
 
-    assert(_total_in_flight_flits[f->cl].count(f->id) > 0);
-    _total_in_flight_flits[f->cl].erase(f->id);
-  
+void TrafficManager::_RemoveInFlight( Flit * f )
+{
+    vector<Flit *> & flits = _total_in_flight_flits[f->cl];
+    assert((f->slot >= 0) && (f->slot < (int)flits.size()));
+    assert(flits[f->slot] == f);
+    // move the last flit into the vacated slot
+    Flit * const last = flits.back();
+    last->slot = f->slot;
+    flits[f->slot] = last;
+    flits.pop_back();
+    f->slot = -1;
+    _in_flight_ctime_sum[f->cl] -= f->ctime;
     if(f->record) {
-        assert(_measured_in_flight_flits[f->cl].count(f->id) > 0);
-        _measured_in_flight_flits[f->cl].erase(f->id);
+        assert(_measured_in_flight_flits[f->cl] > 0);
+        --_measured_in_flight_flits[f->cl];
     }
+}
+
+void TrafficManager::_RetireFlit( Flit *f, int dest )
+{
+    _deadlock_timer = 0;
+
+    _RemoveInFlight(f);
 
     if ( f->watch ) { 
         *gWatchOut << GetSimTime() << " | "
@@ -681,10 +831,11 @@ void TrafficManager::_RetireFlit( Flit *f, int dest )
         if(f->head) {
             head = f;
         } else {
-            map<int, Flit *>::iterator iter = _retired_packets[f->cl].find(f->pid);
-            assert(iter != _retired_packets[f->cl].end());
-            head = iter->second;
-            _retired_packets[f->cl].erase(iter);
+            assert(f->packet_slot >= 0);
+            head = _retired_packets[f->packet_slot];
+            assert(head);
+            _retired_packets[f->packet_slot] = NULL;
+            _free_packet_slots.push_back(f->packet_slot);
             assert(head->head);
             assert(f->pid == head->pid);
         }
@@ -743,12 +894,34 @@ void TrafficManager::_RetireFlit( Flit *f, int dest )
     }
   
     if(f->head && !f->tail) {
-        _retired_packets[f->cl].insert(make_pair(f->pid, f));
+        assert(!_retired_packets[f->packet_slot]);
+        _retired_packets[f->packet_slot] = f;
     } else {
         f->Free();
     }
 }
 
+// Number of upcoming calls to _IssuePacket() for the given queue that are
+// known to return 0. Request-reply classes are not predicted, since a reply 
+// can become due at any time.
+int TrafficManager::_QuietCalls( int source, int cl ) const
+{
+    if ( _use_read_write[cl] ) {
+        return 0;
+    }
+    return max( _injection_process[cl]->quiet( source, cl ), 0 );
+}
+
+// Has the same effect as the given number of failing calls to _IssuePacket()
+void TrafficManager::_SkipIssue( int source, int cl, int calls )
+{
+    _injection_process[cl]->skip( source, cl, calls );
+    if ( !_use_read_write[cl] ) {
+        _requestsOutstanding[source] += calls;
+    }
+    _qtime[source][cl] += calls;
+}
+
 int TrafficManager::_IssuePacket( int source, int cl )
 {
     int result = 0;
@@ -761,9 +934,10 @@ int TrafficManager::_IssuePacket( int source, int cl )
             }
         } else {
             //produce a packet
-            if(_injection_process[cl]->test(source,cl)) {
+            if(_active_sources[cl][source] && 
+               _injection_process[cl]->test(source,cl)) {
                 //coin toss to determine request type.
-                result = (RandomFloat() < _write_fraction[cl]) ? 2 : 1;
+                result = (_packet_random[source][cl].Float() < _write_fraction[cl]) ? 2 : 1;
                 _requestsOutstanding[source]++;
             }
         }
@@ -779,24 +953,36 @@ int TrafficManager::_IssuePacket( int source, int cl )
 
 void TrafficManager::_GeneratePacket( int source, int stype, 
                                       int cl, int time )
+{
+    // request-reply packets take their size from their type
+    int size = _use_read_write[cl] ? 0 : _GetNextPacketSize(source, cl);
+    int dest = _traffic_pattern[cl]->dest(source,cl);
+    _GeneratePacket( source, stype, cl, time, dest, size );
+}
+
+void TrafficManager::_GeneratePacket( int source, int stype, int cl, int time,
+                                      int dest, int size )
 {
     assert(stype!=0);
 
     Flit::FlitType packet_type = Flit::ANY_TYPE;
-    int size = _GetNextPacketSize(cl); //input size 
     int pid = _cur_pid++;
     assert(_cur_pid);
-    int packet_destination = _traffic_pattern[cl]->dest(source,cl);
+    int packet_destination = dest;
     bool record = false;
     bool watch = gWatchOut && (_packets_to_watch.count(pid) > 0);
     if(_use_read_write[cl]){
         if(stype > 0) {
             if (stype == 1) {
                 packet_type = Flit::READ_REQUEST;
-                size = _read_request_size[cl];
+                if (size <= 0) {
+                    size = _read_request_size[cl];
+                }
             } else if (stype == 2) {
                 packet_type = Flit::WRITE_REQUEST;
-                size = _write_request_size[cl];
+                if (size <= 0) {
+                    size = _write_request_size[cl];
+                }
             } else {
                 ostringstream err;
                 err << "Invalid packet type: " << packet_type;
@@ -836,7 +1022,7 @@ void TrafficManager::_GeneratePacket( int source, int stype,
     }
 
     int subnetwork = ((packet_type == Flit::ANY_TYPE) ? 
-                      RandomInt(_subnets-1) :
+                      _packet_random[source][cl].Int(_subnets-1) :
                       _subnet[packet_type]);
   
     if ( watch ) { 
@@ -847,6 +1033,18 @@ void TrafficManager::_GeneratePacket( int source, int stype,
                    << "." << endl;
     }
   
+    // the head flit of a multi-flit packet waits for its tail when retired
+    int packet_slot = -1;
+    if ( size > 1 ) {
+        if ( _free_packet_slots.empty() ) {
+            packet_slot = _retired_packets.size();
+            _retired_packets.push_back(NULL);
+        } else {
+            packet_slot = _free_packet_slots.back();
+            _free_packet_slots.pop_back();
+        }
+    }
+
     for ( int i = 0; i < size; ++i ) {
         Flit * f  = Flit::New();
         f->id     = _cur_id++;
@@ -858,11 +1056,9 @@ void TrafficManager::_GeneratePacket( int source, int stype,
         f->ctime  = time;
         f->record = record;
         f->cl     = cl;
+        f->packet_slot = packet_slot;
 
-        _total_in_flight_flits[f->cl].insert(make_pair(f->id, f));
-        if(record) {
-            _measured_in_flight_flits[f->cl].insert(make_pair(f->id, f));
-        }
+        _AddInFlight(f);
     
         if(gTrace){
             cout<<"New Flit "<<f->src<<endl;
@@ -916,32 +1112,89 @@ void TrafficManager::_GeneratePacket( int source, int stype,
 
 void TrafficManager::_Inject(){
 
-    for ( int input = 0; input < _nodes; ++input ) {
-        for ( int c = 0; c < _classes; ++c ) {
-            // Potentially generate packets for any (input,class)
-            // that is currently empty
-            if ( _partial_packets[input][c].empty() ) {
-                bool generated = false;
-                while( !generated && ( _qtime[input][c] <= _time ) ) {
-                    int stype = _IssuePacket( input, c );
+    if ( _flow_table ) {
+        _InjectFlows();
+        return;
+    }
+
+    for ( size_t i = 0; i < _active_queues.size(); ++i ) {
+        int const input = _active_queues[i].first;
+        int const c = _active_queues[i].second;
+        // Potentially generate packets for any (input,class)
+        // that is currently empty
+        if ( _partial_packets[input][c].empty() ) {
+            bool generated = false;
+            while( !generated && ( _qtime[input][c] <= _time ) ) {
+                // skip the calls that are known to fail, up to and 
+                // including the current cycle
+                int const calls = min( _QuietCalls( input, c ), 
+                                       _time + 1 - _qtime[input][c] );
+                if ( calls > 0 ) {
+                    _SkipIssue( input, c, calls );
+                    continue;
+                }
+                int stype = _IssuePacket( input, c );
 	  
-                    if ( stype != 0 ) { //generate a packet
-                        _GeneratePacket( input, stype, c, 
-                                         _include_queuing==1 ? 
-                                         _qtime[input][c] : _time );
-                        generated = true;
-                    }
-                    // only advance time if this is not a reply packet
-                    if(!_use_read_write[c] || (stype >= 0)){
-                        ++_qtime[input][c];
-                    }
+                if ( stype != 0 ) { //generate a packet
+                    _GeneratePacket( input, stype, c, 
+                                     _include_queuing==1 ? 
+                                     _qtime[input][c] : _time );
+                    generated = true;
                 }
-	
-                if ( ( _sim_state == draining ) && 
-                     ( _qtime[input][c] > _drain_time ) ) {
-                    _qdrained[input][c] = true;
+                // only advance time if this is not a reply packet
+                if(!_use_read_write[c] || (stype >= 0)){
+                    ++_qtime[input][c];
                 }
             }
+	
+            if ( ( _sim_state == draining ) && 
+                 ( _qtime[input][c] > _drain_time ) ) {
+                _qdrained[input][c] = true;
+            }
+        }
+    }
+}
+
+// Same queuing behavior as _Inject(): a (source, class) queue takes its next
+// packet only once it is empty, and packets that had to wait keep their
+// release time as creation time. Only queues with a packet due are visited.
+void TrafficManager::_InjectFlows(){
+
+    _flow_table->Release( _time );
+
+    if ( _sim_state == draining ) {
+        for ( size_t i = 0; i < _active_queues.size(); ++i ) {
+            int const input = _active_queues[i].first;
+            int const c = _active_queues[i].second;
+            // an empty queue with nothing due has caught up with _time
+            if ( !_qdrained[input][c] && 
+                 _partial_packets[input][c].empty() &&
+                 !_flow_table->Ready( input * _classes + c ) ) {
+                _qdrained[input][c] = true;
+            }
+        }
+    }
+
+    for ( int queue = _flow_table->NextReady( -1 ); queue >= 0;
+          queue = _flow_table->NextReady( queue ) ) {
+        int const input = queue / _classes;
+        int const c = queue % _classes;
+        if ( !_partial_packets[input][c].empty() ) {
+            continue;
+        }
+        int release;
+        int const flow = _flow_table->Pop( queue, _time, &release );
+        FlowTable::sFlow const & f = _flow_table->GetFlow( flow );
+        _requestsOutstanding[input]++;
+        _packet_seq_no[input]++;
+        _GeneratePacket( input, 1, c, 
+                         _include_queuing==1 ? release : _time,
+                         f.dest, 
+                         ( f.size > 0 ) ? f.size : _GetNextPacketSize(input, c) );
+        _qtime[input][c] = release + 1;
+        if ( ( _sim_state == draining ) && 
+             ( _qtime[input][c] > _drain_time ) ) {
+            _qdrained[input][c] = true;
         }
     }
 }
@@ -983,8 +1236,8 @@ void TrafficManager::_Step( )
             Credit * const c = _net[subnet]->ReadCredit( n );
             if ( c ) {
 #ifdef TRACK_FLOWS
-                for(set<int>::const_iterator iter = c->vc.begin(); iter != c->vc.end(); ++iter) {
-                    int const vc = *iter;
+                for(unsigned long long bits = c->vc.bits(); bits; bits &= bits - 1) {
+                    int const vc = __builtin_ctzll(bits);
                     assert(!_outstanding_classes[n][subnet][vc].empty());
                     int cl = _outstanding_classes[n][subnet][vc].front();
                     _outstanding_classes[n][subnet][vc].pop();
@@ -996,7 +1249,15 @@ void TrafficManager::_Step( )
                 c->Free();
             }
         }
-        _net[subnet]->ReadInputs( );
+        if(!_subnet_pool) {
+            _net[subnet]->ReadInputs( );
+        }
+    }
+    if(_subnet_pool) {
+        SubnetTask task(_net, subnetReadInputs);
+        RandomLock(true);
+        _subnet_pool->Run(&task);
+        RandomLock(false);
     }
   
     if ( !_empty_network ) {
@@ -1053,10 +1314,9 @@ void TrafficManager::_Step( )
                 if(cf->head && cf->vc == -1) { // Find first available VC
 	  
                     OutputSet route_set;
-                    _rf(NULL, cf, -1, &route_set, true);
-                    set<OutputSet::sSetElement> const & os = route_set.GetSet();
-                    assert(os.size() == 1);
-                    OutputSet::sSetElement const & se = *os.begin();
+                    _rf(_net[subnet]->GetInject(n)->GetSink(), cf, -1, &route_set, true);
+                    assert(route_set.size() == 1);
+                    OutputSet::sSetElement const & se = *route_set.begin();
                     assert(se.output_port == -1);
                     int vc_start = se.vc_start;
                     int vc_end = se.vc_end;
@@ -1081,9 +1341,8 @@ void TrafficManager::_Step( )
                                        << "Generating lookahead routing info for flit " << cf->id
                                        << " (NOQ)." << endl;
                         }
-                        set<OutputSet::sSetElement> const sl = cf->la_route_set.GetSet();
-                        assert(sl.size() == 1);
-                        int next_output = sl.begin()->output_port;
+                        assert(cf->la_route_set.size() == 1);
+                        int next_output = cf->la_route_set.begin()->output_port;
                         vc_count /= router->NumOutputs();
                         vc_start += next_output * vc_count;
                         vc_end = vc_start + vc_count - 1;
@@ -1254,8 +1513,16 @@ void TrafficManager::_Step( )
             }
         }
         flits[subnet].clear();
-        _net[subnet]->Evaluate( );
-        _net[subnet]->WriteOutputs( );
+        if(!_subnet_pool) {
+            _net[subnet]->Evaluate( );
+            _net[subnet]->WriteOutputs( );
+        }
+    }
+    if(_subnet_pool) {
+        SubnetTask task(_net, subnetEvaluate);
+        RandomLock(true);
+        _subnet_pool->Run(&task);
+        RandomLock(false);
     }
 
     ++_time;
@@ -1266,14 +1533,131 @@ void TrafficManager::_Step( )
 
 }
   
+void TrafficManager::SubnetTask::Run( int subnet )
+{
+    if(_phase == subnetReadInputs) {
+        _net[subnet]->ReadInputs( );
+    } else {
+        _net[subnet]->Evaluate( );
+        _net[subnet]->WriteOutputs( );
+    }
+}
+
+// Skips ahead over cycles in which nothing can happen: the network holds no
+// flits or credits and every injection process can tell that its next
+// injection is still in the future. Returns the number of cycles skipped.
+// whether the network holds no flits or credits, so that advancing _time
+// without stepping the network leaves its state unchanged
+bool TrafficManager::_NetworkIdle( ) const
+{
+    if ( _empty_network ) {
+        return false;
+    }
+    for ( int c = 0; c < _classes; ++c ) {
+        if ( !_total_in_flight_flits[c].empty() ) {
+            return false;
+        }
+    }
+    return ( Credit::OutStanding( ) == 0 );
+}
+
+int TrafficManager::_FastForward( int max_cycles )
+{
+    if ( ( max_cycles <= 0 ) || !_NetworkIdle( ) ) {
+        return 0;
+    }
+
+    if ( _flow_table ) {
+        if ( _flow_table->HasReady() ) {
+            return 0;
+        }
+        int const horizon = min( _time + max_cycles, 
+                                 _flow_table->NextRelease() );
+        if ( horizon <= _time ) {
+            return 0;
+        }
+        int const skipped = horizon - _time;
+        _time = horizon;
+        return skipped;
+    }
+
+    // _Inject() issues one test() call for each cycle up to and including
+    // the current one, so the first cycle that cannot be skipped is the one
+    // whose call may succeed
+    int horizon = _time + max_cycles;
+    for ( int n = 0; n < _nodes; ++n ) {
+        if ( !_repliesPending[n].empty() ) {
+            return 0;
+        }
+    }
+    for ( size_t i = 0; i < _active_queues.size(); ++i ) {
+        int const n = _active_queues[i].first;
+        int const c = _active_queues[i].second;
+        int const quiet = _QuietCalls( n, c );
+        if ( _qtime[n][c] < horizon - quiet ) {
+            horizon = _qtime[n][c] + quiet;
+        }
+    }
+    if ( horizon <= _time ) {
+        return 0;
+    }
+
+    for ( size_t i = 0; i < _active_queues.size(); ++i ) {
+        int const n = _active_queues[i].first;
+        int const c = _active_queues[i].second;
+        int const calls = horizon - _qtime[n][c];
+        if ( calls > 0 ) {
+            _SkipIssue( n, c, calls );
+        }
+    }
+
+    int const skipped = horizon - _time;
+    _time = horizon;
+    return skipped;
+}
+
+// A source is active for a class if its injection process and traffic
+// pattern can ever make it inject. The queues of inactive sources are skipped
+// by _Inject() and _FastForward() and do not hold up draining, except that
+// any node may have to send replies in request-reply traffic.
+bool TrafficManager::_SourceActive( int source, int cl ) const
+{
+    if ( _flow_table ) {
+        return _flow_table->Active( source * _classes + cl );
+    }
+    return ( _injection_process[cl]->active( source ) &&
+             _traffic_pattern[cl]->active( source ) );
+}
+
+void TrafficManager::_UpdateActiveSources( )
+{
+    _active_queues.clear();
+    for ( int s = 0; s < _nodes; ++s ) {
+        for ( int c = 0; c < _classes; ++c ) {
+            bool const active = _SourceActive( s, c );
+            // a queue that was not visited while it was inactive has not
+            // missed any injections; queues that stayed active keep their
+            // (possibly lagging) injection time
+            if ( active && !_active_sources[c][s] && !_use_read_write[c] &&
+                 _partial_packets[s][c].empty() && ( _qtime[s][c] < _time ) ) {
+                _qtime[s][c] = _time;
+            }
+            _active_sources[c][s] = active;
+            if ( active || _use_read_write[c] ) {
+                _active_queues.push_back( make_pair( s, c ) );
+            }
+        }
+    }
+}
+
 bool TrafficManager::_PacketsOutstanding( ) const
 {
     for ( int c = 0; c < _classes; ++c ) {
         if ( _measure_stats[c] ) {
-            if ( _measured_in_flight_flits[c].empty() ) {
+            if ( _measured_in_flight_flits[c] == 0 ) {
 	
                 for ( int s = 0; s < _nodes; ++s ) {
-                    if ( !_qdrained[s][c] ) {
+                    if ( _active_sources[c][s] && !_qdrained[s][c] ) {
 #ifdef DEBUG_DRAIN
                         cout << "waiting on queue " << s << " class " << c;
                         cout << ", time = " << _time << " qtime = " << _qtime[s][c] << endl;
@@ -1283,7 +1667,7 @@ bool TrafficManager::_PacketsOutstanding( ) const
                 }
             } else {
 #ifdef DEBUG_DRAIN
-                cout << "in flight = " << _measured_in_flight_flits[c].size() << endl;
+                cout << "in flight = " << _measured_in_flight_flits[c] << endl;
 #endif
                 return true;
             }
@@ -1376,45 +1760,60 @@ void TrafficManager::_DisplayRemaining( ostream & os ) const
 {
     for(int c = 0; c < _classes; ++c) {
 
-        map<int, Flit *>::const_iterator iter;
-        int i;
+        // the in-flight table is unordered, so list the oldest flits
+        vector<int> remaining, measured;
+        for(size_t i = 0; i < _total_in_flight_flits[c].size(); ++i) {
+            Flit const * const f = _total_in_flight_flits[c][i];
+            remaining.push_back(f->id);
+            if(f->record) {
+                measured.push_back(f->id);
+            }
+        }
 
         os << "Class " << c << ":" << endl;
 
         os << "Remaining flits: ";
-        for ( iter = _total_in_flight_flits[c].begin( ), i = 0;
-              ( iter != _total_in_flight_flits[c].end( ) ) && ( i < 10 );
-              iter++, i++ ) {
-            os << iter->first << " ";
-        }
-        if(_total_in_flight_flits[c].size() > 10)
-            os << "[...] ";
-    
-        os << "(" << _total_in_flight_flits[c].size() << " flits)" << endl;
+        _DisplayOldest(os, remaining);
     
         os << "Measured flits: ";
-        for ( iter = _measured_in_flight_flits[c].begin( ), i = 0;
-              ( iter != _measured_in_flight_flits[c].end( ) ) && ( i < 10 );
-              iter++, i++ ) {
-            os << iter->first << " ";
-        }
-        if(_measured_in_flight_flits[c].size() > 10)
-            os << "[...] ";
-    
-        os << "(" << _measured_in_flight_flits[c].size() << " flits)" << endl;
+        _DisplayOldest(os, measured);
     
     }
 }
 
+void TrafficManager::_DisplayOldest( ostream & os, vector<int> & ids ) const
+{
+    size_t const shown = min(ids.size(), (size_t)10);
+    partial_sort(ids.begin(), ids.begin() + shown, ids.end());
+    for(size_t i = 0; i < shown; ++i) {
+        os << ids[i] << " ";
+    }
+    if(ids.size() > 10)
+        os << "[...] ";
+    
+    os << "(" << ids.size() << " flits)" << endl;
+}
+
 bool TrafficManager::_SingleSim( )
 {
-    int converged = 0;
+    // a resumed simulation picks up the sample loop where the checkpoint
+    // was taken
+    if ( !_resuming ) {
+        _sample_state.converged = 0;
+        _sample_state.prev_latency.assign(_classes, 0.0);
+        _sample_state.prev_accepted.assign(_classes, 0.0);
+        _sample_state.clear_last = false;
+        _sample_state.total_phases = 0;
+    }
+    _resuming = false;
+
+    int & converged = _sample_state.converged;
   
     //once warmed up, we require 3 converging runs to end the simulation 
-    vector<double> prev_latency(_classes, 0.0);
-    vector<double> prev_accepted(_classes, 0.0);
-    bool clear_last = false;
-    int total_phases = 0;
+    vector<double> & prev_latency = _sample_state.prev_latency;
+    vector<double> & prev_accepted = _sample_state.prev_accepted;
+    bool & clear_last = _sample_state.clear_last;
+    int & total_phases = _sample_state.total_phases;
     while( ( total_phases < _max_samples ) && 
            ( ( _sim_state != running ) || 
              ( converged < 3 ) ) ) {
@@ -1425,8 +1824,12 @@ bool TrafficManager::_SingleSim( )
         }
     
     
-        for ( int iter = 0; iter < _sample_period; ++iter )
+        for ( int iter = 0; iter < _sample_period; ++iter ) {
+            if ( _idle_fast_forward ) {
+                iter += _FastForward( _sample_period - iter - 1 );
+            }
             _Step( );
+        }
     
         //cout << _sim_state << endl;
 
@@ -1459,13 +1862,8 @@ bool TrafficManager::_SingleSim( )
             double latency = (double)_plat_stats[c]->Sum();
             double count = (double)_plat_stats[c]->NumSamples();
       
-            map<int, Flit *>::const_iterator iter;
-            for(iter = _total_in_flight_flits[c].begin(); 
-                iter != _total_in_flight_flits[c].end(); 
-                iter++) {
-                latency += (double)(_time - iter->second->ctime);
-                count++;
-            }
+            latency += (double)_InFlightLatency(c);
+            count += (double)_total_in_flight_flits[c].size();
       
             if((lat_exc_class < 0) &&
                (_latency_thres[c] >= 0.0) &&
@@ -1523,6 +1921,14 @@ bool TrafficManager::_SingleSim( )
                 cout << "Warmed up ..." <<  "Time used is " << _time << " cycles" <<endl;
                 clear_last = true;
                 _sim_state = running;
+                if(_warmup_handler) {
+                    WarmupHandler * const handler = _warmup_handler;
+                    _warmup_handler = NULL;
+                    if(!handler->WarmedUp(this)) {
+                        _sim_state = done;
+                        return false;
+                    }
+                }
             }
         } else if(_sim_state == running) {
             if ( ( !_measure_latency || ( lat_chg_exc_class < 0 ) ) &&
@@ -1533,6 +1939,11 @@ bool TrafficManager::_SingleSim( )
             }
         }
         ++total_phases;
+
+        if ( ( _checkpoint_period > 0 ) && !_checkpoint_file.empty() &&
+             ( ( total_phases % _checkpoint_period ) == 0 ) ) {
+            _SaveCheckpoint( );
+        }
     }
   
     if ( _sim_state == running ) {
@@ -1564,13 +1975,8 @@ bool TrafficManager::_SingleSim( )
                         double acc_latency = _plat_stats[c]->Sum();
                         double acc_count = (double)_plat_stats[c]->NumSamples();
 	    
-                        map<int, Flit *>::const_iterator iter;
-                        for(iter = _total_in_flight_flits[c].begin(); 
-                            iter != _total_in_flight_flits[c].end(); 
-                            iter++) {
-                            acc_latency += (double)(_time - iter->second->ctime);
-                            acc_count++;
-                        }
+                        acc_latency += (double)_InFlightLatency(c);
+                        acc_count += (double)_total_in_flight_flits[c].size();
 	    
                         if((acc_latency / acc_count) > threshold) {
                             lat_exc_class = c;
@@ -1600,9 +2006,161 @@ bool TrafficManager::_SingleSim( )
     return ( converged > 0 );
 }
 
+void TrafficManager::_Serialize( Checkpoint & cp )
+{
+    cp.Check(_nodes, "number of nodes");
+    cp.Check(_subnets, "number of subnets");
+    cp.Check(_classes, "number of classes");
+
+    cp.Sync(_sim);
+    cp.Sync(_sample_state.converged);
+    cp.Sync(_sample_state.prev_latency);
+    cp.Sync(_sample_state.prev_accepted);
+    cp.Sync(_sample_state.clear_last);
+    cp.Sync(_sample_state.total_phases);
+
+    cp.Sync(_time);
+    cp.Sync(_reset_time);
+    cp.Sync(_drain_time);
+    cp.Sync(_sim_state);
+    cp.Sync(_empty_network);
+    cp.Sync(_deadlock_timer);
+    cp.Sync(_cur_id);
+    cp.Sync(_cur_pid);
+
+    cp.Sync(_load);
+    cp.Sync(_last_class);
+    cp.Sync(_last_vc);
+
+    cp.Sync(_qtime);
+    cp.Sync(_qdrained);
+    cp.Sync(_active_sources);
+    cp.Sync(_partial_packets);
+    cp.Sync(_total_in_flight_flits);
+    cp.Sync(_measured_in_flight_flits);
+    cp.Sync(_in_flight_ctime_sum);
+    cp.Sync(_retired_packets);
+    cp.Sync(_free_packet_slots);
+
+    cp.Sync(_packet_seq_no);
+    cp.Sync(_repliesPending);
+    cp.Sync(_requestsOutstanding);
+
+    for ( int s = 0; s < _nodes; ++s ) {
+        for ( int subnet = 0; subnet < _subnets; ++subnet ) {
+            _buf_states[s][subnet]->Serialize(cp);
+        }
+    }
+#ifdef TRACK_FLOWS
+    cp.Sync(_outstanding_credits);
+    cp.Sync(_outstanding_classes);
+    cp.Sync(_injected_flits);
+    cp.Sync(_ejected_flits);
+#endif
+
+    cp.Sync(_sent_packets);
+    cp.Sync(_accepted_packets);
+    cp.Sync(_sent_flits);
+    cp.Sync(_accepted_flits);
+#ifdef TRACK_STALLS
+    cp.Sync(_buffer_busy_stalls);
+    cp.Sync(_buffer_conflict_stalls);
+    cp.Sync(_buffer_full_stalls);
+    cp.Sync(_buffer_reserved_stalls);
+    cp.Sync(_crossbar_conflict_stalls);
+#endif
+    cp.Sync(_slowest_packet);
+    cp.Sync(_slowest_flit);
+
+    for ( map<string, Stats *>::iterator iter = _stats.begin();
+          iter != _stats.end(); ++iter ) {
+        iter->second->Serialize(cp);
+    }
+
+    for ( size_t i = 0; i < _overall_stats.size(); ++i ) {
+        cp.Sync(*_overall_stats[i]);
+    }
+    cp.Sync(_overall_samples);
+
+    for ( int c = 0; c < _classes; ++c ) {
+        _traffic_pattern[c]->serialize(cp);
+        _injection_process[c]->serialize(cp);
+    }
+    cp.Sync(_packet_random);
+    if ( _flow_table ) {
+        _flow_table->Serialize(cp);
+    }
+
+    for ( int subnet = 0; subnet < _subnets; ++subnet ) {
+        _net[subnet]->Serialize(cp);
+    }
+
+    vector<long> ran_state;
+    vector<double> ranf_state;
+    if ( !cp.Loading() ) {
+        ran_get_state(ran_state);
+        ranf_get_state(ranf_state);
+    }
+    long stream_seed = RandomStreamGetSeed();
+    cp.Sync(ran_state);
+    cp.Sync(ranf_state);
+    cp.Sync(stream_seed);
+    if ( cp.Loading() ) {
+        ran_set_state(ran_state);
+        ranf_set_state(ranf_state);
+        RandomStreamSeed(stream_seed);
+    }
+}
+
+void TrafficManager::_SaveCheckpoint( )
+{
+    Checkpoint cp(_checkpoint_file, false);
+    _Serialize(cp);
+    cp.Commit();
+    cout << "Saved checkpoint to " << _checkpoint_file
+         << " at time " << _time << endl;
+}
+
+void TrafficManager::_LoadCheckpoint( )
+{
+    Checkpoint cp(_resume_file, true);
+    _Serialize(cp);
+    _resuming = true;
+    cout << "Resuming from checkpoint " << _resume_file
+         << " at time " << _time << endl;
+}
+
 bool TrafficManager::Run( )
 {
-    for ( int sim = 0; sim < _total_sims; ++sim ) {
+    _sim = 0;
+    if ( !_resume_file.empty() ) {
+        _LoadCheckpoint( );
+    }
+
+    if ( ( _sim_jobs != 1 ) && ( _total_sims > 1 ) ) {
+        if ( !_RunReplications( ) ) {
+            return false;
+        }
+    } else {
+        for ( ; _sim < _total_sims; ++_sim ) {
+            if ( !_RunSim( ) ) {
+                return false;
+            }
+            _RecordOverallStats( );
+        }
+    }
+  
+    DisplayOverallStats();
+    if(_print_csv_results) {
+        DisplayOverallStatsCSV();
+    }
+  
+    return true;
+}
+
+bool TrafficManager::_RunSim( )
+{
+    if ( !_resuming ) {
 
         _time = 0;
 
@@ -1633,58 +2191,120 @@ bool TrafficManager::Run( )
             _traffic_pattern[c]->reset();
             _injection_process[c]->reset();
         }
+        if(_flow_table) {
+            _flow_table->Reset();
+        }
 
-        if ( !_SingleSim( ) ) {
+    }
+
+    _UpdateActiveSources( );
+
+    if ( !_SingleSim( ) ) {
+        if ( _sim_state != done ) {
             cout << "Simulation unstable, ending ..." << endl;
-            return false;
         }
+        return false;
+    }
 
-        // Empty any remaining packets
-        cout << "Draining remaining packets ..." << endl;
-        _empty_network = true;
-        int empty_steps = 0;
+    // Empty any remaining packets
+    cout << "Draining remaining packets ..." << endl;
+    _empty_network = true;
+    int empty_steps = 0;
 
-        bool packets_left = false;
+    bool packets_left = false;
+    for(int c = 0; c < _classes; ++c) {
+        packets_left |= !_total_in_flight_flits[c].empty();
+    }
+
+    while( packets_left ) { 
+        _Step( ); 
+
+        ++empty_steps;
+
+        if ( empty_steps % 1000 == 0 ) {
+            _DisplayRemaining( ); 
+        }
+  
+        packets_left = false;
         for(int c = 0; c < _classes; ++c) {
             packets_left |= !_total_in_flight_flits[c].empty();
         }
+    }
+    //wait until all the credits are drained as well
+    while(Credit::OutStanding()!=0){
+        _Step();
+    }
+    _empty_network = false;
 
-        while( packets_left ) { 
-            _Step( ); 
+    //for the love of god don't ever say "Time taken" anywhere else
+    //the power script depend on it
+    cout << "Time taken is " << _time << " cycles" <<endl; 
 
-            ++empty_steps;
+    if(_stats_out) {
+        WriteStats(*_stats_out);
+    }
+    return true;
+}
 
-            if ( empty_steps % 1000 == 0 ) {
-                _DisplayRemaining( ); 
-            }
-      
-            packets_left = false;
-            for(int c = 0; c < _classes; ++c) {
-                packets_left |= !_total_in_flight_flits[c].empty();
+/* run the simulations of sim_count concurrently, each in a forked process
+ * with its own random number stream (seeded with seed + its index), and
+ * add up their overall statistics
+ */
+bool TrafficManager::_RunReplications( )
+{
+    if ( _warmup_handler ) {
+        Error( "Warm-started load sweeps require sim_jobs = 1." );
+    }
+
+    vector<string> titles;
+    for ( int sim = 0; sim < _total_sims; ++sim ) {
+        ostringstream title;
+        title << "Simulation " << sim << " (seed " << _seed + sim << ")";
+        titles.push_back(title.str());
+    }
+    ProcessPool pool(titles, _sim_jobs);
+
+    _sim = pool.Fork();
+    if ( _sim >= 0 ) {
+        RandomSeed(_seed + _sim);
+        RandomStreamSeed(_seed + _sim);
+        bool const result = _RunSim( );
+        ostringstream results;
+        results.precision(17);
+        results << result;
+        if ( result ) {
+            _UpdateOverallStats( );
+            for ( size_t i = 0; i < _overall_stats.size(); ++i ) {
+                for ( int c = 0; c < _classes; ++c ) {
+                    results << ' ' << (*_overall_stats[i])[c];
+                }
             }
         }
-        //wait until all the credits are drained as well
-        while(Credit::OutStanding()!=0){
-            _Step();
-        }
-        _empty_network = false;
-
-        //for the love of god don't ever say "Time taken" anywhere else
-        //the power script depend on it
-        cout << "Time taken is " << _time << " cycles" <<endl; 
+        results << endl;
+        pool.Report(results.str());
+    }
 
-        if(_stats_out) {
-            WriteStats(*_stats_out);
+    bool result = true;
+    for ( int sim = 0; sim < _total_sims; ++sim ) {
+        istringstream results(pool.Results(sim));
+        bool succeeded = false;
+        results >> succeeded;
+        if ( !succeeded ) {
+            cout << "Simulation " << sim << " did not complete" << endl;
+            result = false;
+            continue;
         }
-        _UpdateOverallStats();
-    }
-  
-    DisplayOverallStats();
-    if(_print_csv_results) {
-        DisplayOverallStatsCSV();
+        vector<vector<double> > sample(_overall_stats.size(),
+                                       vector<double>(_classes));
+        for ( size_t i = 0; i < _overall_stats.size(); ++i ) {
+            for ( int c = 0; c < _classes; ++c ) {
+                results >> sample[i][c];
+            }
+        }
+        _AddOverallSample(sample);
     }
-  
-    return true;
+    _sim = _total_sims;
+    return result;
 }
 
 void TrafficManager::_UpdateOverallStats() {
@@ -2043,7 +2663,7 @@ void TrafficManager::DisplayStats(ostream & os) const {
              << "Accepted packet length average = " << (double)accepted_flits / (double)accepted_packets << endl;
 
         cout << "Total in-flight flits = " << _total_in_flight_flits[c].size()
-             << " (" << _measured_in_flight_flits[c].size() << " measured)"
+             << " (" << _measured_in_flight_flits[c] << " measured)"
              << endl;
     
 #ifdef TRACK_STALLS
@@ -2085,6 +2705,7 @@ void TrafficManager::DisplayOverallStats( ostream & os ) const {
     
         os << "Packet latency average = " << _overall_avg_plat[c] / (double)_total_sims
            << " (" << _total_sims << " samples)" << endl;
+        _DisplayInterval(os, _overall_avg_plat, c);
         os << "\tminimum = " << _overall_min_plat[c] / (double)_total_sims
            << " (" << _total_sims << " samples)" << endl;
         os << "\tmaximum = " << _overall_max_plat[c] / (double)_total_sims
@@ -2092,6 +2713,7 @@ void TrafficManager::DisplayOverallStats( ostream & os ) const {
 
         os << "Network latency average = " << _overall_avg_nlat[c] / (double)_total_sims
            << " (" << _total_sims << " samples)" << endl;
+        _DisplayInterval(os, _overall_avg_nlat, c);
         os << "\tminimum = " << _overall_min_nlat[c] / (double)_total_sims
            << " (" << _total_sims << " samples)" << endl;
         os << "\tmaximum = " << _overall_max_nlat[c] / (double)_total_sims
@@ -2099,6 +2721,7 @@ void TrafficManager::DisplayOverallStats( ostream & os ) const {
 
         os << "Flit latency average = " << _overall_avg_flat[c] / (double)_total_sims
            << " (" << _total_sims << " samples)" << endl;
+        _DisplayInterval(os, _overall_avg_flat, c);
         os << "\tminimum = " << _overall_min_flat[c] / (double)_total_sims
            << " (" << _total_sims << " samples)" << endl;
         os << "\tmaximum = " << _overall_max_flat[c] / (double)_total_sims
@@ -2106,6 +2729,7 @@ void TrafficManager::DisplayOverallStats( ostream & os ) const {
 
         os << "Fragmentation average = " << _overall_avg_frag[c] / (double)_total_sims
            << " (" << _total_sims << " samples)" << endl;
+        _DisplayInterval(os, _overall_avg_frag, c);
         os << "\tminimum = " << _overall_min_frag[c] / (double)_total_sims
            << " (" << _total_sims << " samples)" << endl;
         os << "\tmaximum = " << _overall_max_frag[c] / (double)_total_sims
@@ -2113,6 +2737,7 @@ void TrafficManager::DisplayOverallStats( ostream & os ) const {
 
         os << "Injected packet rate average = " << _overall_avg_sent_packets[c] / (double)_total_sims
            << " (" << _total_sims << " samples)" << endl;
+        _DisplayInterval(os, _overall_avg_sent_packets, c);
         os << "\tminimum = " << _overall_min_sent_packets[c] / (double)_total_sims
            << " (" << _total_sims << " samples)" << endl;
         os << "\tmaximum = " << _overall_max_sent_packets[c] / (double)_total_sims
@@ -2120,6 +2745,7 @@ void TrafficManager::DisplayOverallStats( ostream & os ) const {
     
         os << "Accepted packet rate average = " << _overall_avg_accepted_packets[c] / (double)_total_sims
            << " (" << _total_sims << " samples)" << endl;
+        _DisplayInterval(os, _overall_avg_accepted_packets, c);
         os << "\tminimum = " << _overall_min_accepted_packets[c] / (double)_total_sims
            << " (" << _total_sims << " samples)" << endl;
         os << "\tmaximum = " << _overall_max_accepted_packets[c] / (double)_total_sims
@@ -2127,6 +2753,7 @@ void TrafficManager::DisplayOverallStats( ostream & os ) const {
 
         os << "Injected flit rate average = " << _overall_avg_sent[c] / (double)_total_sims
            << " (" << _total_sims << " samples)" << endl;
+        _DisplayInterval(os, _overall_avg_sent, c);
         os << "\tminimum = " << _overall_min_sent[c] / (double)_total_sims
            << " (" << _total_sims << " samples)" << endl;
         os << "\tmaximum = " << _overall_max_sent[c] / (double)_total_sims
@@ -2134,6 +2761,7 @@ void TrafficManager::DisplayOverallStats( ostream & os ) const {
     
         os << "Accepted flit rate average = " << _overall_avg_accepted[c] / (double)_total_sims
            << " (" << _total_sims << " samples)" << endl;
+        _DisplayInterval(os, _overall_avg_accepted, c);
         os << "\tminimum = " << _overall_min_accepted[c] / (double)_total_sims
            << " (" << _total_sims << " samples)" << endl;
         os << "\tmaximum = " << _overall_max_accepted[c] / (double)_total_sims
@@ -2147,6 +2775,7 @@ void TrafficManager::DisplayOverallStats( ostream & os ) const {
     
         os << "Hops average = " << _overall_hop_stats[c] / (double)_total_sims
            << " (" << _total_sims << " samples)" << endl;
+        _DisplayInterval(os, _overall_hop_stats, c);
     
 #ifdef TRACK_STALLS
         os << "Buffer busy stall rate = " << (double)_overall_buffer_busy_stalls[c] / (double)_total_sims
@@ -2165,6 +2794,73 @@ void TrafficManager::DisplayOverallStats( ostream & os ) const {
   
 }
 
+void TrafficManager::_RecordOverallStats( )
+{
+    // collect the contribution of the current simulation on its own, then
+    // add it to the totals of the previous ones
+    vector<vector<double> > totals(_overall_stats.size());
+    for ( size_t i = 0; i < _overall_stats.size(); ++i ) {
+        totals[i].swap(*_overall_stats[i]);
+        _overall_stats[i]->assign(_classes, 0.0);
+    }
+    _UpdateOverallStats();
+    vector<vector<double> > sample(_overall_stats.size());
+    for ( size_t i = 0; i < _overall_stats.size(); ++i ) {
+        sample[i].swap(*_overall_stats[i]);
+        _overall_stats[i]->swap(totals[i]);
+    }
+    _AddOverallSample(sample);
+}
+
+void TrafficManager::_AddOverallSample( vector<vector<double> > const & sample )
+{
+    for ( size_t i = 0; i < _overall_stats.size(); ++i ) {
+        for ( int c = 0; c < _classes; ++c ) {
+            (*_overall_stats[i])[c] += sample[i][c];
+            _overall_samples[i][c].push_back(sample[i][c]);
+        }
+    }
+}
+
+// two-sided 95% quantile of Student's t distribution
+static double _StudentT95( int df )
+{
+    static double const table[] = {
+        12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+        2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+        2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+    };
+    if ( df <= 30 ) {
+        return table[df - 1];
+    }
+    return 1.960 + 2.37 / (double)df;
+}
+
+void TrafficManager::_DisplayInterval( ostream & os, vector<double> const & overall, int c ) const
+{
+    if ( _total_sims < 2 ) {
+        return;
+    }
+    size_t i = 0;
+    while ( _overall_stats[i] != &overall ) {
+        ++i;
+    }
+    vector<double> const & samples = _overall_samples[i][c];
+    int const n = samples.size();
+    double mean = 0.0;
+    for ( int s = 0; s < n; ++s ) {
+        mean += samples[s];
+    }
+    mean /= (double)n;
+    double var = 0.0;
+    for ( int s = 0; s < n; ++s ) {
+        var += (samples[s] - mean) * (samples[s] - mean);
+    }
+    var /= (double)(n - 1);
+    os << "\t95% confidence interval = +/- "
+       << _StudentT95(n - 1) * sqrt(var / (double)n) << endl;
+}
+
 string TrafficManager::_OverallStatsCSV(int c) const
 {
     ostringstream os;
@@ -2210,6 +2906,29 @@ string TrafficManager::_OverallStatsCSV(int c) const
     return os.str();
 }
 
+void TrafficManager::SetInjectionRate(double rate)
+{
+    for(int c = 0; c < _classes; ++c) {
+        _load[c] = rate;
+        if(_injection_rate_uses_flits) {
+            _load[c] /= _GetAveragePacketSize(c);
+        }
+        _injection_process[c]->set_rate(_load[c]);
+    }
+    _UpdateActiveSources();
+}
+
+vector<double> TrafficManager::getOverallAverages(int c) const
+{
+    vector<double> averages;
+    averages.push_back(_overall_avg_plat[c] / (double)_total_sims);
+    averages.push_back(_overall_avg_nlat[c] / (double)_total_sims);
+    averages.push_back(_overall_avg_flat[c] / (double)_total_sims);
+    averages.push_back(_overall_avg_sent[c] / (double)_total_sims);
+    averages.push_back(_overall_avg_accepted[c] / (double)_total_sims);
+    return averages;
+}
+
 void TrafficManager::DisplayOverallStatsCSV(ostream & os) const {
     for(int c = 0; c < _classes; ++c) {
         os << "results:" << c << ',' << _OverallStatsCSV() << endl;
@@ -2239,7 +2958,7 @@ void TrafficManager::_LoadWatchList(const string & filename){
     }
 }
 
-int TrafficManager::_GetNextPacketSize(int cl) const
+int TrafficManager::_GetNextPacketSize(int source, int cl)
 {
     assert(cl >= 0 && cl < _classes);
 
@@ -2253,7 +2972,7 @@ int TrafficManager::_GetNextPacketSize(int cl) const
     vector<int> const & prate = _packet_size_rate[cl];
     int max_val = _packet_size_max_val[cl];
 
-    int pct = RandomInt(max_val);
+    int pct = _packet_random[source][cl].Int(max_val);
 
     for(int i = 0; i < (sizes - 1); ++i) {
         int const limit = prate[i];
@@ -43,9 +43,24 @@
 #include "routefunc.hpp"
 #include "outputset.hpp"
 #include "injection.hpp"
+#include "random_utils.hpp"
+#include "flow_table.hpp"
+#include "thread_pool.hpp"
 
 //register the requests to a node
 class PacketReplyInfo;
+class Checkpoint;
+
+class TrafficManager;
+
+// notified once a simulation has warmed up, e.g. to fork the simulator and
+// continue from the warmed-up state with different parameters
+class WarmupHandler {
+public:
+  virtual ~WarmupHandler() {}
+  // returns false if the simulation should end at this point
+  virtual bool WarmedUp(TrafficManager * traffic_manager) = 0;
+};
 
 class TrafficManager : public Module {
 
@@ -86,6 +101,10 @@ protected:
   vector<TrafficPattern *> _traffic_pattern;
   vector<InjectionProcess *> _injection_process;
 
+  // replaces the injection processes and traffic patterns if a flow file
+  // is given
+  FlowTable * _flow_table;
+
   // ============ Message priorities ============ 
 
   enum ePriority { class_based, age_based, network_age_based, local_age_based, queue_length_based, hop_count_based, sequence_based, none };
@@ -113,9 +132,21 @@ protected:
   vector<vector<bool> > _qdrained;
   vector<vector<list<Flit *> > > _partial_packets;
 
-  vector<map<int, Flit *> > _total_in_flight_flits;
-  vector<map<int, Flit *> > _measured_in_flight_flits;
-  vector<map<int, Flit *> > _retired_packets;
+  // per-class masks of the sources that can ever inject, and the active
+  // (source, class) queues in the order in which _Inject() visits them
+  vector<vector<bool> > _active_sources;
+  vector<pair<int, int> > _active_queues;
+
+  // flits in flight per class, in no particular order; each flit knows
+  // its position (Flit::slot), so it can be removed in constant time
+  vector<vector<Flit *> > _total_in_flight_flits;
+  vector<int> _measured_in_flight_flits;
+  // sum of the creation times of the flits in flight per class
+  vector<long long> _in_flight_ctime_sum;
+  // head flits of packets whose tail has not arrived yet, indexed by the
+  // handle shared by all flits of the packet (Flit::packet_slot)
+  vector<Flit *> _retired_packets;
+  vector<int> _free_packet_slots;
   bool _empty_network;
 
   bool _hold_switch_for_packet;
@@ -126,15 +157,64 @@ protected:
 
   vector<int> _subnet;
 
+  // subnets share no router or channel state, so their ReadInputs and
+  // Evaluate/WriteOutputs phases can run on one thread each
+  ThreadPool * _subnet_pool;
+
+  enum eSubnetPhase { subnetReadInputs, subnetEvaluate };
+
+  class SubnetTask : public ThreadPool::Task {
+    vector<Network *> const & _net;
+    eSubnetPhase _phase;
+  public:
+    SubnetTask(vector<Network *> const & net, eSubnetPhase phase)
+      : _net(net), _phase(phase) {}
+    virtual void Run(int subnet);
+  };
+
   // ============ deadlock ==========
 
   int _deadlock_timer;
   int _deadlock_warn_timeout;
 
+  // ============ idle fast-forward ==========
+
+  bool _idle_fast_forward;
+
+  // ============ warm start ==========
+
+  WarmupHandler * _warmup_handler;
+  bool _injection_rate_uses_flits;
+
+  // ============ checkpoints ==========
+
+  string _checkpoint_file;
+  int _checkpoint_period;
+  string _resume_file;
+
+  // index of the current simulation
+  int _sim;
+
+  // progress of the sample period loop in _SingleSim
+  struct sSampleState {
+    int converged;
+    vector<double> prev_latency;
+    vector<double> prev_accepted;
+    bool clear_last;
+    int total_phases;
+  };
+  sSampleState _sample_state;
+
+  // set while continuing a simulation that was loaded from a checkpoint
+  bool _resuming;
+
   // ============ request & replies ==========================
 
   vector<int> _packet_seq_no;
   vector<list<PacketReplyInfo*> > _repliesPending;
+  // random number streams for the packet type, size and subnet of each
+  // source and class
+  vector<vector<RandomStream> > _packet_random;
   vector<int> _requestsOutstanding;
 
   // ============ Statistics ============
@@ -199,6 +279,11 @@ protected:
   vector<int> _slowest_packet;
   vector<int> _slowest_flit;
 
+  // all of the overall statistics above, and their value in each simulation
+  // (by statistic, class and simulation) for confidence intervals
+  vector<vector<double> *> _overall_stats;
+  vector<vector<vector<double> > > _overall_samples;
+
   map<string, Stats *> _stats;
 
   // ============ Simulation parameters ============ 
@@ -212,6 +297,8 @@ protected:
   int   _drain_time;
 
   int   _total_sims;
+  int   _sim_jobs;
+  int   _seed;
   int   _sample_period;
   int   _max_samples;
   int   _warmup_periods;
@@ -262,31 +349,60 @@ protected:
   // ============ Internal methods ============ 
 protected:
 
+  void _AddInFlight( Flit * f );
+  void _RemoveInFlight( Flit * f );
+
+  // total time the flits of a class currently in flight have existed for
+  inline long long _InFlightLatency( int c ) const {
+    return (long long)_total_in_flight_flits[c].size() * _time -
+      _in_flight_ctime_sum[c];
+  }
+
   virtual void _RetireFlit( Flit *f, int dest );
 
-  void _Inject();
+  virtual void _Inject();
+  void _InjectFlows();
   void _Step( );
+  bool _NetworkIdle( ) const;
+  virtual int  _FastForward( int max_cycles );
 
   bool _PacketsOutstanding( ) const;
+
+  virtual bool _SourceActive( int source, int cl ) const;
+  void _UpdateActiveSources( );
   
+  virtual int  _QuietCalls( int source, int cl ) const;
+  void _SkipIssue( int source, int cl, int calls );
   virtual int  _IssuePacket( int source, int cl );
-  void _GeneratePacket( int source, int size, int cl, int time );
+  void _GeneratePacket( int source, int stype, int cl, int time );
+  void _GeneratePacket( int source, int stype, int cl, int time,
+                        int dest, int size );
 
   virtual void _ClearStats( );
 
   void _ComputeStats( const vector<int> & stats, int *sum, int *min = NULL, int *max = NULL, int *min_pos = NULL, int *max_pos = NULL ) const;
 
   virtual bool _SingleSim( );
+  bool _RunSim( );
+  bool _RunReplications( );
 
   void _DisplayRemaining( ostream & os = cout ) const;
+  void _DisplayOldest( ostream & os, vector<int> & ids ) const;
   
   void _LoadWatchList(const string & filename);
 
   virtual void _UpdateOverallStats();
+  void _RecordOverallStats( );
+  void _AddOverallSample( vector<vector<double> > const & sample );
+  void _DisplayInterval( ostream & os, vector<double> const & overall, int c ) const;
 
   virtual string _OverallStatsCSV(int c = 0) const;
 
-  int _GetNextPacketSize(int cl) const;
+  void _SaveCheckpoint( );
+  void _LoadCheckpoint( );
+  virtual void _Serialize( Checkpoint & cp );
+
+  int _GetNextPacketSize(int source, int cl);
   double _GetAveragePacketSize(int cl) const;
 
 public:
@@ -299,6 +415,11 @@ public:
 
   bool Run( );
 
+  // the handler is notified (once) when the next simulation has warmed up
+  void SetWarmupHandler( WarmupHandler * handler ) { _warmup_handler = handler; }
+  // change the injection rate of all classes, keeping the simulation state
+  void SetInjectionRate( double rate );
+
   virtual void WriteStats( ostream & os = cout ) const ;
   virtual void UpdateStats( ) ;
   virtual void DisplayStats( ostream & os = cout ) const ;
@@ -308,6 +429,11 @@ public:
   inline int getTime() { return _time;}
   Stats * getStats(const string & name) { return _stats[name]; }
 
+  // overall packet, network and flit latency and injected and accepted flit
+  // rate averages of a class, as reported by DisplayOverallStats
+  inline int getClasses() const { return _classes; }
+  vector<double> getOverallAverages(int c) const;
+
 };
 
 template<class T>
@@ -39,6 +39,7 @@
 #include "globals.hpp"
 #include "booksim.hpp"
 #include "vc.hpp"
+#include "checkpoint.hpp"
 
 const char * const VC::VCSTATE[] = {"idle",
 				    "routing",
@@ -77,6 +78,11 @@ VC::~VC()
   }
 }
 
+void VC::AttachStorage( Flit::Handle * storage, int capacity )
+{
+  _buffer.Attach(storage, capacity);
+}
+
 void VC::AddFlit( Flit *f )
 {
   assert(f);
@@ -103,7 +109,7 @@ void VC::AddFlit( Flit *f )
     assert(f->pri >= 0);
   }
 
-  _buffer.push_back(f);
+  _buffer.push_back(f->GetHandle());
   UpdatePriority();
 }
 
@@ -111,7 +117,7 @@ Flit *VC::RemoveFlit( )
 {
   Flit *f = NULL;
   if ( !_buffer.empty( ) ) {
-    f = _buffer.front( );
+    f = Flit::Lookup(_buffer.front( ));
     _buffer.pop_front( );
     _last_id = f->id;
     _last_pid = f->pid;
@@ -160,11 +166,11 @@ void VC::UpdatePriority()
   if(_pri_type == queue_length_based) {
     _pri = _buffer.size();
   } else if(_pri_type != none) {
-    Flit * f = _buffer.front();
+    Flit * f = Flit::Lookup(_buffer.front());
     if((_pri_type != local_age_based) && _priority_donation) {
       Flit * df = f;
       for(size_t i = 1; i < _buffer.size(); ++i) {
-	Flit * bf = _buffer[i];
+	Flit * bf = Flit::Lookup(_buffer[i]);
 	if(bf->pri > df->pri) df = bf;
       }
       if((df != f) && (df->watch || f->watch)) {
@@ -204,6 +210,51 @@ bool VC::IsWatched( ) const
   return _watched;
 }
 
+void VC::Serialize(Checkpoint & cp)
+{
+  // handles are only meaningful within one run, so the buffered flits are
+  // saved by reference
+  vector<Flit *> flits;
+  if(!cp.Loading()) {
+    for(size_t i = 0; i < _buffer.size(); ++i) {
+      flits.push_back(Flit::Lookup(_buffer[i]));
+    }
+  }
+  cp.Sync(flits);
+  if(cp.Loading()) {
+    _buffer.clear();
+    for(size_t i = 0; i < flits.size(); ++i) {
+      _buffer.push_back(flits[i]->GetHandle());
+    }
+  }
+  cp.Sync(_state);
+  if(_lookahead_routing) {
+    // the route set is the lookahead route of one of the buffered flits
+    int owner = -1;
+    if(!cp.Loading()) {
+      for(size_t i = 0; i < _buffer.size(); ++i) {
+	if(&flits[i]->la_route_set == _route_set) {
+	  owner = i;
+	  break;
+	}
+      }
+    }
+    cp.Sync(owner);
+    if(cp.Loading()) {
+      _route_set = (owner >= 0) ? &flits[owner]->la_route_set : NULL;
+    }
+  } else {
+    cp.Sync(*_route_set);
+  }
+  cp.Sync(_out_port);
+  cp.Sync(_out_vc);
+  cp.Sync(_pri);
+  cp.Sync(_watched);
+  cp.Sync(_expected_pid);
+  cp.Sync(_last_id);
+  cp.Sync(_last_pid);
+}
+
 void VC::Display( ostream & os ) const
 {
   if ( _state != VC::idle ) {
@@ -215,7 +266,7 @@ void VC::Display( ostream & os ) const
     }
     os << " fill: " << _buffer.size();
     if(!_buffer.empty()) {
-      os << " front: " << _buffer.front()->id;
+      os << " front: " << Flit::Lookup(_buffer.front())->id;
     }
     os << " pri: " << _pri;
     os << endl;
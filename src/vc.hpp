@@ -28,13 +28,14 @@
 #ifndef _VC_HPP_
 #define _VC_HPP_
 
-#include <deque>
-
 #include "flit.hpp"
+#include "ring_buffer.hpp"
 #include "outputset.hpp"
 #include "routefunc.hpp"
 #include "config_utils.hpp"
 
+class Checkpoint;
+
 class VC : public Module {
 public:
   enum eVCState { state_min = 0, idle = state_min, routing, vc_alloc, active, 
@@ -46,7 +47,7 @@ public:
   
 private:
 
-  deque<Flit *> _buffer;
+  RingBuffer<Flit::Handle> _buffer;
   
   eVCState _state;
   
@@ -76,10 +77,13 @@ public:
       Module *parent, const string& name );
   ~VC();
 
+  // keep the buffered flits in an array owned by the enclosing buffer
+  void AttachStorage( Flit::Handle * storage, int capacity );
+
   void AddFlit( Flit *f );
   inline Flit *FrontFlit( ) const
   {
-    return _buffer.empty() ? NULL : _buffer.front();
+    return _buffer.empty() ? NULL : Flit::Lookup(_buffer.front());
   }
   
   Flit *RemoveFlit( );
@@ -132,6 +136,8 @@ public:
   void SetWatch( bool watch = true );
   bool IsWatched( ) const;
   void Display( ostream & os = cout ) const;
+
+  void Serialize( Checkpoint & cp );
 };
 
 #endif 
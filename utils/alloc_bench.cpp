@@ -0,0 +1,287 @@
+// $Id$
+
+/*
+ Copyright (c) 2007-2012, Trustees of The Leland Stanford Junior University
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice, this
+ list of conditions and the following disclaimer in the documentation and/or
+ other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*alloc_bench.cpp
+ *
+ *Microbenchmark for the allocators and arbiters in isolation. Synthetic
+ *request patterns are generated up front for a router of the given radix
+ *and VC count:
+ *
+ *  switch -- radix x radix; each VC of an input is busy with probability
+ *            load and requests a random output port
+ *  vc     -- (radix*vcs) x (radix*vcs); each input VC is waiting with
+ *            probability load and requests all VCs of a random output port
+ *
+ *Every allocator is created through Allocator::NewAllocator and timed over
+ *Clear(), adding the requests and Allocate(), which is what a router pays
+ *per cycle. Matching efficiency is the number of grants relative to
+ *max_size on the same patterns; every matching is checked against its
+ *requests. Arbiters are created through Arbiter::NewArbiter and timed over
+ *radix*vcs inputs with the same load.
+ *
+ *Build with "make alloc_bench" in src.
+ *
+ */
+
+#include <sys/time.h>
+
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include "booksim.hpp"
+#include "allocator.hpp"
+#include "arbiter.hpp"
+#include "random_utils.hpp"
+
+struct sBenchRequest {
+  int in;
+  int first;
+  unsigned long long mask;
+  int in_pri;
+  int out_pri;
+};
+
+typedef vector<sBenchRequest> tPattern;
+
+static double Now( )
+{
+  struct timeval tv;
+  gettimeofday( &tv, NULL );
+  return (double)tv.tv_sec + (double)tv.tv_usec / 1000000.0;
+}
+
+static int RandomPri( int spread )
+{
+  return ( spread > 1 ) ? RandomInt( spread - 1 ) : 0;
+}
+
+static tPattern SwitchPattern( int radix, int vcs, double load, int spread )
+{
+  tPattern pattern;
+  for ( int in = 0; in < radix; ++in ) {
+    vector<bool> requested( radix, false );
+    for ( int vc = 0; vc < vcs; ++vc ) {
+      if ( RandomFloat( ) < load ) {
+	int const out = RandomInt( radix - 1 );
+	if ( !requested[out] ) {
+	  requested[out] = true;
+	  sBenchRequest r;
+	  r.in = in;
+	  r.first = out;
+	  r.mask = 1;
+	  r.in_pri = RandomPri( spread );
+	  r.out_pri = RandomPri( spread );
+	  pattern.push_back( r );
+	}
+      }
+    }
+  }
+  return pattern;
+}
+
+static tPattern VCPattern( int radix, int vcs, double load, int spread )
+{
+  tPattern pattern;
+  unsigned long long const all_vcs = ( vcs == 64 ) ? ~0ULL : ( ( 1ULL << vcs ) - 1 );
+  for ( int in = 0; in < radix * vcs; ++in ) {
+    if ( RandomFloat( ) < load ) {
+      sBenchRequest r;
+      r.in = in;
+      r.first = RandomInt( radix - 1 ) * vcs;
+      r.mask = all_vcs;
+      r.in_pri = RandomPri( spread );
+      r.out_pri = r.in_pri;
+      pattern.push_back( r );
+    }
+  }
+  return pattern;
+}
+
+static void AddRequests( Allocator * a, tPattern const & pattern )
+{
+  a->Clear( );
+  for ( tPattern::const_iterator r = pattern.begin( ); r != pattern.end( ); ++r ) {
+    a->AddRequestMask( r->in, r->first, r->mask, 1, r->in_pri, r->out_pri );
+  }
+}
+
+// number of grants, after checking that they form a matching of requests
+static int CountMatches( Allocator const * a, int ports )
+{
+  int matches = 0;
+  for ( int in = 0; in < ports; ++in ) {
+    int const out = a->OutputAssigned( in );
+    if ( out >= 0 ) {
+      if ( ( a->ReadRequest( in, out ) < 0 ) || ( a->InputAssigned( out ) != in ) ) {
+	cerr << "Error: Invalid grant " << in << " -> " << out << endl;
+	exit( 1 );
+      }
+      ++matches;
+    }
+  }
+  return matches;
+}
+
+static double BenchAllocator( string const & type, int ports,
+			      vector<tPattern> const & patterns, int rounds,
+			      long long & matches )
+{
+  // matches are counted on a separate instance so that the timed loop
+  // only contains what a router does every cycle
+  Allocator * a = Allocator::NewAllocator( NULL, type, type, ports, ports );
+  if ( !a ) {
+    cerr << "Error: Unknown allocator " << type << endl;
+    exit( 1 );
+  }
+  matches = 0;
+  for ( size_t p = 0; p < patterns.size( ); ++p ) {
+    AddRequests( a, patterns[p] );
+    a->Allocate( );
+    matches += CountMatches( a, ports );
+  }
+  delete a;
+
+  a = Allocator::NewAllocator( NULL, type, type, ports, ports );
+  double const start = Now( );
+  for ( int r = 0; r < rounds; ++r ) {
+    AddRequests( a, patterns[r % patterns.size( )] );
+    a->Allocate( );
+  }
+  double const time = Now( ) - start;
+  delete a;
+  return time;
+}
+
+static double BenchArbiter( string const & type, int size, double load,
+			    int spread, int rounds, long long & checksum )
+{
+  vector<vector<pair<int, int> > > patterns( 256 );
+  for ( size_t p = 0; p < patterns.size( ); ++p ) {
+    for ( int in = 0; in < size; ++in ) {
+      if ( RandomFloat( ) < load ) {
+	patterns[p].push_back( make_pair( in, RandomPri( spread ) ) );
+      }
+    }
+  }
+
+  Arbiter * a = Arbiter::NewArbiter( NULL, type, type, size );
+  checksum = 0;
+  double const start = Now( );
+  for ( int r = 0; r < rounds; ++r ) {
+    vector<pair<int, int> > const & pattern = patterns[r % patterns.size( )];
+    for ( size_t i = 0; i < pattern.size( ); ++i ) {
+      a->AddRequest( pattern[i].first, pattern[i].first, pattern[i].second );
+    }
+    checksum += a->Arbitrate( NULL, NULL );
+    a->UpdateState( );
+    a->Clear( );
+  }
+  double const time = Now( ) - start;
+  delete a;
+  return time;
+}
+
+int main( int argc, char ** argv )
+{
+  int const radix = ( argc > 1 ) ? atoi( argv[1] ) : 5;
+  int const vcs = ( argc > 2 ) ? atoi( argv[2] ) : 4;
+  double const load = ( argc > 3 ) ? atof( argv[3] ) : 0.5;
+  int const spread = ( argc > 4 ) ? atoi( argv[4] ) : 1;
+  int const rounds = ( argc > 5 ) ? atoi( argv[5] ) : 100000;
+
+  if ( ( radix < 1 ) || ( vcs < 1 ) || ( vcs > 64 ) || ( rounds < 1 ) ) {
+    cerr << "Usage: " << argv[0]
+	 << " [radix [vcs (1-64) [load [priority spread [rounds]]]]]" << endl;
+    return 1;
+  }
+
+  RandomSeed( 0 );
+
+  cout << "radix = " << radix << ", vcs = " << vcs << ", load = " << load
+       << ", priorities = " << spread << ", rounds = " << rounds << endl;
+
+  int const num_patterns = 256;
+  vector<tPattern> switch_patterns, vc_patterns;
+  for ( int p = 0; p < num_patterns; ++p ) {
+    switch_patterns.push_back( SwitchPattern( radix, vcs, load, spread ) );
+    vc_patterns.push_back( VCPattern( radix, vcs, load, spread ) );
+  }
+
+  ostringstream tree_rr, tree_matrix;
+  tree_rr << "tree(" << radix << ",round_robin)";
+  tree_matrix << "tree(" << radix << ",matrix)";
+
+  string const allocators[] = {
+    "max_size", "islip", "islip(2)", "pim", "pim(2)", "loa",
+    "wavefront", "rr_wavefront", "select", "select(2)",
+    "separable_input_first", "separable_output_first",
+    "separable_input_first(matrix)", "separable_output_first(matrix)",
+    "vc_mask_input_first", "vc_mask_output_first"
+  };
+  string const arbiters[] = {
+    "round_robin", "matrix", tree_rr.str( ), tree_matrix.str( )
+  };
+  int const num_allocators = sizeof( allocators ) / sizeof( allocators[0] );
+  int const num_arbiters = sizeof( arbiters ) / sizeof( arbiters[0] );
+
+  cout << "stage,allocator,ns/allocation,matches/allocation,efficiency" << endl;
+
+  for ( int s = 0; s < 2; ++s ) {
+    string const stage = ( s == 0 ) ? "switch" : "vc";
+    int const ports = ( s == 0 ) ? radix : ( radix * vcs );
+    vector<tPattern> const & patterns = ( s == 0 ) ? switch_patterns : vc_patterns;
+    long long max_matches = 0;
+    for ( int i = 0; i < num_allocators; ++i ) {
+      long long matches;
+      double const time = BenchAllocator( allocators[i], ports, patterns,
+					  rounds, matches );
+      if ( i == 0 ) {
+	max_matches = matches;
+      } else if ( matches > max_matches ) {
+	cerr << "Error: " << allocators[i] << " found a larger matching than max_size"
+	     << endl;
+	return 1;
+      }
+      cout << stage << ',' << allocators[i] << ','
+	   << time * 1e9 / rounds << ','
+	   << (double)matches / num_patterns << ','
+	   << ( max_matches ? ( (double)matches / max_matches ) : 1.0 ) << endl;
+    }
+  }
+
+  cout << "arbiter,ns/arbitration" << endl;
+
+  for ( int i = 0; i < num_arbiters; ++i ) {
+    long long checksum;
+    double const time = BenchArbiter( arbiters[i], radix * vcs, load, spread,
+				      rounds, checksum );
+    cout << arbiters[i] << ',' << time * 1e9 / rounds << endl;
+  }
+  return 0;
+}
@@ -0,0 +1,169 @@
+// $Id$
+
+/*
+ Copyright (c) 2007-2012, Trustees of The Leland Stanford Junior University
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ Redistributions of source code must retain the above copyright notice, this 
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice, this
+ list of conditions and the following disclaimer in the documentation and/or
+ other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE 
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*outputset_bench.cpp
+ *
+ *Microbenchmark for the per-hop cost of route sets: a routing function
+ *clears the set and adds its outputs, then VC and switch allocation walk
+ *the set of every waiting VC. The old std::set based implementation, which
+ *the allocators copied before every walk, is timed alongside as reference.
+ *
+ *Build with "make outputset_bench" in src.
+ *
+ */
+
+#include <sys/time.h>
+
+#include <cstdlib>
+#include <iostream>
+#include <set>
+
+#include "booksim.hpp"
+#include "outputset.hpp"
+
+// ordering of the old route set
+inline bool operator<( const OutputSet::sSetElement & se1,
+		       const OutputSet::sSetElement & se2 ) {
+  return se1.pri > se2.pri; // higher priorities first!
+}
+
+// route set as it was implemented before OutputSet became a flat array
+class SetOutputSet {
+
+public:
+
+  typedef set<OutputSet::sSetElement> tSet;
+
+  void Clear( ) { _outputs.clear( ); }
+  void AddRange( int output_port, int vc_start, int vc_end, int pri = 0 ) {
+    OutputSet::sSetElement s;
+    s.vc_start = vc_start;
+    s.vc_end = vc_end;
+    s.pri = pri;
+    s.output_port = output_port;
+    _outputs.insert( s );
+  }
+  const tSet & GetSet( ) const { return _outputs; }
+
+private:
+  tSet _outputs;
+};
+
+static double Now( )
+{
+  struct timeval tv;
+  gettimeofday( &tv, NULL );
+  return (double)tv.tv_sec + (double)tv.tv_usec / 1000000.0;
+}
+
+// outputs added per hop: one for deterministic routing, three (with
+// different priorities) for adaptive routing
+static int Route( int hop, int outputs, int * ports, int * pris )
+{
+  for ( int i = 0; i < outputs; ++i ) {
+    ports[i] = ( hop + i ) % 5;
+    pris[i] = outputs - i;
+  }
+  return outputs;
+}
+
+static long long BenchSet( int hops, int outputs, int walks )
+{
+  SetOutputSet route_set;
+  long long checksum = 0;
+  int ports[3], pris[3];
+  for ( int h = 0; h < hops; ++h ) {
+    route_set.Clear( );
+    int const n = Route( h, outputs, ports, pris );
+    for ( int i = 0; i < n; ++i ) {
+      route_set.AddRange( ports[i], 0, 3, pris[i] );
+    }
+    for ( int w = 0; w < walks; ++w ) {
+      SetOutputSet::tSet const setlist = route_set.GetSet( );
+      for ( SetOutputSet::tSet::const_iterator iset = setlist.begin( );
+	    iset != setlist.end( );
+	    ++iset ) {
+	checksum += iset->output_port + iset->vc_end;
+      }
+    }
+  }
+  return checksum;
+}
+
+static long long BenchFlat( int hops, int outputs, int walks )
+{
+  OutputSet route_set;
+  long long checksum = 0;
+  int ports[3], pris[3];
+  for ( int h = 0; h < hops; ++h ) {
+    route_set.Clear( );
+    int const n = Route( h, outputs, ports, pris );
+    for ( int i = 0; i < n; ++i ) {
+      route_set.AddRange( ports[i], 0, 3, pris[i] );
+    }
+    for ( int w = 0; w < walks; ++w ) {
+      for ( OutputSet::const_iterator iset = route_set.begin( );
+	    iset != route_set.end( );
+	    ++iset ) {
+	checksum += iset->output_port + iset->vc_end;
+      }
+    }
+  }
+  return checksum;
+}
+
+int main( int argc, char ** argv )
+{
+  int const hops = ( argc > 1 ) ? atoi( argv[1] ) : 2000000;
+  // a waiting VC's set is walked once by VC allocation and once by switch
+  // allocation per cycle, for several cycles while it competes
+  int const walks = ( argc > 2 ) ? atoi( argv[2] ) : 4;
+
+  cout << "hops = " << hops << ", walks per hop = " << walks << endl;
+  cout << "outputs,std::set ns/hop,OutputSet ns/hop,speedup" << endl;
+
+  int const outputs[] = { 1, 3 };
+  for ( int o = 0; o < 2; ++o ) {
+    double start = Now( );
+    long long const set_sum = BenchSet( hops, outputs[o], walks );
+    double const set_time = Now( ) - start;
+
+    start = Now( );
+    long long const flat_sum = BenchFlat( hops, outputs[o], walks );
+    double const flat_time = Now( ) - start;
+
+    if ( set_sum != flat_sum ) {
+      cerr << "Error: Route sets differ" << endl;
+      return 1;
+    }
+    cout << outputs[o] << ','
+	 << set_time * 1e9 / hops << ','
+	 << flat_time * 1e9 / hops << ','
+	 << set_time / flat_time << endl;
+  }
+  return 0;
+}
@@ -0,0 +1,167 @@
+// $Id$
+
+/*
+ Copyright (c) 2007-2012, Trustees of The Leland Stanford Junior University
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice, this
+ list of conditions and the following disclaimer in the documentation and/or
+ other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*trace2bin.cpp
+ *
+ *Converts a text packet trace into the binary format replayed with
+ *sim_type = trace (see src/trace_reader.hpp). Each line describes one
+ *packet:
+ *
+ *  cycle source dest [class [size [type]]]
+ *
+ *class, size and type default to 0; a size of 0 uses the packet size of
+ *the class, and type is 0 for ordinary packets, 1 for read requests and 2
+ *for write requests. Text after "//" is ignored. Lines must be sorted by
+ *cycle (e.g., with "sort -n -k1,1"). The input is streamed, so traces of
+ *any length can be converted; "-" reads from standard input.
+ *
+ *Build with "make trace2bin" in src.
+ *
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include <climits>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "trace_reader.hpp"
+
+using namespace std;
+
+static void Fail( string const & filename, long long line_num,
+		  string const & what )
+{
+  cerr << "Error: " << what << " in line " << line_num << " of trace: "
+       << filename << endl;
+  exit(1);
+}
+
+int main( int argc, char ** argv )
+{
+  if ( argc != 3 ) {
+    cerr << "Usage: " << argv[0] << " <text trace | -> <binary trace>" << endl;
+    return 1;
+  }
+  string const in_name = argv[1];
+  string const out_name = argv[2];
+
+  ifstream in_file;
+  if ( in_name != "-" ) {
+    in_file.open( in_name.c_str( ) );
+    if ( !in_file ) {
+      cerr << "Error: Unable to open trace: " << in_name << endl;
+      return 1;
+    }
+  }
+  istream & in = ( in_name == "-" ) ? cin : in_file;
+
+  ofstream out( out_name.c_str( ), ios::binary );
+  if ( !out ) {
+    cerr << "Error: Unable to create trace file: " << out_name << endl;
+    return 1;
+  }
+
+  sTraceHeader header;
+  memset( &header, 0, sizeof( header ) );
+  strncpy( header.magic, TRACE_MAGIC, sizeof( header.magic ) );
+  header.version = TRACE_VERSION;
+  header.record_size = sizeof( sTraceRecord );
+  out.write( (char const *)&header, sizeof( header ) );
+
+  vector<sTraceRecord> buffer;
+  buffer.reserve( 65536 );
+  long long records = 0;
+  long long last_cycle = 0;
+
+  string line;
+  long long line_num = 0;
+  while ( getline( in, line ) ) {
+    ++line_num;
+    size_t const comment = line.find( "//" );
+    if ( comment != string::npos ) {
+      line.erase( comment );
+    }
+    istringstream fields( line );
+    long long cycle;
+    if ( !( fields >> cycle ) ) {
+      continue;
+    }
+    long long source, dest;
+    if ( !( fields >> source >> dest ) ) {
+      Fail( in_name, line_num, "Missing fields" );
+    }
+    long long value;
+    long long const cl = ( fields >> value ) ? value : 0;
+    long long const size = ( fields >> value ) ? value : 0;
+    long long const type = ( fields >> value ) ? value : trace_any;
+    if ( ( cycle < 0 ) || ( cycle > INT_MAX ) ||
+	 ( source < 0 ) || ( source > INT_MAX ) ||
+	 ( dest < 0 ) || ( dest > INT_MAX ) ||
+	 ( cl < 0 ) || ( cl > UCHAR_MAX ) ||
+	 ( size < 0 ) || ( size > USHRT_MAX ) ||
+	 ( ( type != trace_any ) && ( type != trace_read ) && 
+	   ( type != trace_write ) ) ) {
+      Fail( in_name, line_num, "Invalid packet" );
+    }
+    if ( cycle < last_cycle ) {
+      Fail( in_name, line_num, "Packet out of order" );
+    }
+    last_cycle = cycle;
+
+    sTraceRecord r;
+    memset( &r, 0, sizeof( r ) );
+    r.cycle = (unsigned int)cycle;
+    r.source = (unsigned int)source;
+    r.dest = (unsigned int)dest;
+    r.size = (unsigned short)size;
+    r.cl = (unsigned char)cl;
+    r.type = (unsigned char)type;
+    buffer.push_back( r );
+    if ( buffer.size( ) == buffer.capacity( ) ) {
+      out.write( (char const *)&buffer[0], 
+		 buffer.size( ) * sizeof( sTraceRecord ) );
+      buffer.clear( );
+    }
+    ++records;
+  }
+  if ( !buffer.empty( ) ) {
+    out.write( (char const *)&buffer[0], 
+	       buffer.size( ) * sizeof( sTraceRecord ) );
+  }
+  out.close( );
+  if ( !out ) {
+    cerr << "Error: Unable to write trace file: " << out_name << endl;
+    return 1;
+  }
+
+  cout << "Converted " << records << " packets." << endl;
+  return 0;
+}